@@ -0,0 +1,66 @@
+#ifndef MCU_NVIC_INTERRUPT
+#define MCU_NVIC_INTERRUPT
+
+#include <stdint.h>
+
+#include "mcu/tm4c123gh6pm.h"
+
+// Interrupt numbers of the peripherals used in this lab
+// Source: Table 2-9 or pg. 104-106 in datasheet (https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf)
+#define GPIOA_IRQn      0
+
+
+// NVIC register addressing
+// Sources:
+// * Register mapping: pg. 134 - 137 of datasheet (https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf)
+// * Priority bit field locations: pg. 152 of datasheet (https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf)
+//
+// The enable (EN), disable (DIS), set pending (PEND) and clear pending (UNPEND) banks are laid
+// out as consecutive 32-bit registers, with interrupt n controlled by bit (n % 32) of register (n / 32).
+// Writing a 0 has no effect on these registers, so a single store of just the target bit is enough
+// (no read-modify-write and no risk of clobbering another interrupt that changed in between).
+#define NVIC_IRQ_REG(reg0, IRQn)    (((volatile unsigned long *) &(reg0))[(IRQn) >> 5])
+#define NVIC_IRQ_BIT(IRQn)          (1UL << ((IRQn) & 0x1F))
+
+// The priority registers are byte-accessible, with interrupt n owning byte n starting from PRI0.
+// Only the upper 3 bits of each byte are implemented (priority 0 = highest, 7 = lowest).
+#define NVIC_PRI_BYTE(IRQn)         (((volatile unsigned char *) &NVIC_PRI0_R)[(IRQn)])
+#define NVIC_PRI_SHIFT              5
+#define NVIC_PRI_MASK               0x7u
+
+
+// Compile-time versions of the NVIC operations
+// NOTE: When 'IRQn' is a constant, every macro below resolves to a single store to a fixed address
+#define NVIC_ENABLE_IRQ(IRQn)           (NVIC_IRQ_REG(NVIC_EN0_R, IRQn) = NVIC_IRQ_BIT(IRQn))
+#define NVIC_DISABLE_IRQ(IRQn)          (NVIC_IRQ_REG(NVIC_DIS0_R, IRQn) = NVIC_IRQ_BIT(IRQn))
+#define NVIC_SET_PENDING_IRQ(IRQn)      (NVIC_IRQ_REG(NVIC_PEND0_R, IRQn) = NVIC_IRQ_BIT(IRQn))
+#define NVIC_CLEAR_PENDING_IRQ(IRQn)    (NVIC_IRQ_REG(NVIC_UNPEND0_R, IRQn) = NVIC_IRQ_BIT(IRQn))
+#define NVIC_IS_PENDING_IRQ(IRQn)       ((NVIC_IRQ_REG(NVIC_PEND0_R, IRQn) & NVIC_IRQ_BIT(IRQn)) != 0)
+#define NVIC_SET_PRIORITY(IRQn, priority) \
+    (NVIC_PRI_BYTE(IRQn) = (unsigned char) (((priority) & NVIC_PRI_MASK) << NVIC_PRI_SHIFT))
+
+
+// Run-time versions for when the interrupt number is only known at run-time
+
+// Enable the specified interrupt (number)
+extern void NVIC_EnableIRQn(int IRQn);
+
+// Disable the specified interrupt (number)
+extern void NVIC_DisableIRQn(int IRQn);
+
+// Force the specified interrupt (number) into the pending state
+extern void NVIC_SetPendingIRQn(int IRQn);
+
+// Remove the pending state of the specified interrupt (number)
+extern void NVIC_ClearPendingIRQn(int IRQn);
+
+// Set the priority for the specified interrupt (number)
+extern void NVIC_SetPriorityIRQn(int IRQn, int priority);
+
+// Split the 3 priority bits into 'preemptBits' (0 - 3) upper bits of group priority, deciding which handler
+// preempts which (& what BASEPRI masks), & the rest as subpriority, only ordering pending handlers
+// NOTE: Out of reset all 3 bits are group priority, which is what the rest of the labs assume
+extern void NVIC_SetPriorityGrouping(int preemptBits);
+
+
+#endif /* MCU_NVIC_INTERRUPT */
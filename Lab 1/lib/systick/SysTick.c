@@ -0,0 +1,104 @@
+#include <stdint.h>
+#include "mcu/tm4c123gh6pm.h"
+#include "power/power.h"
+#include "SysTick.h"
+
+// Number of periods elapsed since the last (re)configuration (incremented by SysTick_Handler)
+static volatile uint32_t sysTickTicks = 0;
+
+// Configure SysTick for delays running at initialized bus clock (from PLL)
+// Source: https://web2.qatar.cmu.edu/cs/15348/lectures/Lecture08.pdfs
+// NOTE: Accessing the RELOAD register requires system clock to be greater than 8 MHz
+void SysTick_Init(void) {
+    // Disable SysTick during setup
+    NVIC_ST_CTRL_R = 0;
+
+    // Set default reload value to maximum reload value
+    NVIC_ST_RELOAD_R = NVIC_ST_RELOAD_M;
+
+    // Set current value of counter to 0 to trigger reload after first cycle
+    NVIC_ST_CURRENT_R = 0;
+
+    // Re-enable SysTick with source set to system clock and interrupts enabled (to wake up from sleep)
+    NVIC_ST_CTRL_R = (NVIC_ST_CTRL_ENABLE | NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_INTEN);
+}
+
+// Unit time delay based on system clock
+// Source: https://web2.qatar.cmu.edu/cs/15348/lectures/Lecture08.pdfs
+// NOTE: It's better to construct higher level functions with greater delays to reduce function calling overhead
+// Delay parameter units is 1 per cycle time
+// Examples:
+// - 80 Mhz    => t = 1 / 80 Mhz    =  12.5 ns (unit)
+// - 50 Mhz    => t = 1 / 50 Mhz    =  20.0 ns (unit)
+// - 40 Mhz    => t = 1 / 40 Mhz    =  25.0 ns (unit)
+// - 3.125 Mhz => t = 1 / 3.125 Mhz = 320.0 ns (unit)
+//
+// Delays of at least SYSTICK_SLEEP_MIN_CYCLES put the core to sleep until the SysTick interrupt,
+// shorter ones busy wait on the count bit.
+// NOTE: Must not be called with interrupts disabled
+void SysTick_Wait(uint32_t delay) {
+    uint32_t start;
+
+    // Set reload value to number of counts to wait
+    // NOTE: Subtracting by 1 since reload will be triggered by first cycle
+    NVIC_ST_RELOAD_R = delay - 1;
+
+    if (delay < SYSTICK_SLEEP_MIN_CYCLES) {
+        // Set current value of counter to 0 to trigger reload after first cycle
+        NVIC_ST_CURRENT_R = 0;
+
+        // Wait for count bit to be set to 1, otherwise keep checking
+        while ((NVIC_ST_CTRL_R & NVIC_ST_CTRL_COUNT) == 0);
+        return;
+    }
+
+    __disable_irq();
+
+    // Set current value of counter to 0 to trigger reload after first cycle
+    NVIC_ST_CURRENT_R = 0;
+
+    // Drop any tick of the previous period that became pending in the meantime
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PENDSTCLR;
+
+    // Sleep until the SysTick interrupt counts the end of the delay
+    start = sysTickTicks;
+    while (sysTickTicks == start)
+        Power_Sleep();
+
+    __enable_irq();
+}
+
+
+// Configure SysTick to fire an interrupt every 'period' cycles, counting the elapsed periods (ticks)
+// Examples (assuming 50 MHz clock -> 1 cycle = 20 ns):
+// - 50,000 cycles => 1 tick per 1 ms
+// - 50 cycles     => 1 tick per 1 us (not recommended, interrupt overhead dominates)
+// NOTE: SysTick_Wait() reprograms the reload value, so it must not be used in this mode
+void SysTick_Init_Periodic(uint32_t period) {
+    // Disable SysTick during setup
+    NVIC_ST_CTRL_R = 0;
+
+    // Set reload value to number of counts per period
+    // NOTE: Subtracting by 1 since reload will be triggered by first cycle
+    NVIC_ST_RELOAD_R = period - 1;
+
+    // Set current value of counter to 0 to trigger reload after first cycle
+    NVIC_ST_CURRENT_R = 0;
+
+    // Reset the tick counter
+    sysTickTicks = 0;
+
+    // Re-enable SysTick with source set to system clock and interrupts enabled
+    NVIC_ST_CTRL_R = (NVIC_ST_CTRL_ENABLE | NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_INTEN);
+}
+
+// Get the number of periods elapsed since SysTick_Init_Periodic()
+// NOTE: The counter wraps around after 2^32 ticks, so compare ticks by subtraction, i.e. (now - start) >= n
+uint32_t SysTick_Get_Ticks(void) {
+    return sysTickTicks;
+}
+
+// NOTE: This is meant to be implicitly overriden
+void SysTick_Handler(void) {
+    sysTickTicks++;
+}
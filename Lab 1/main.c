@@ -12,7 +12,13 @@
  *   - Bit test: (arg & (1 << pinN) == 1)
  */
 
-#include "tm4c123gh6pm.h"
+#include <stdint.h>
+
+#include "lib/mcu/tm4c123gh6pm.h"
+#include "lib/gpio/gpio.h"
+#include "lib/nvic/Interrupt.h"
+#include "lib/systick/SysTick.h"
+#include "lib/power/power.h"
 
 // Task 1 pin definitions
 #define INPUT_BUTTON_PIN	0x20u // = 0x20 (PA5)
@@ -50,8 +56,8 @@ const unsigned char SEG_7_PATTERNS[10] = {
 };
 
 // Function declarations
-void Setup_Port_A_Pins(void);
-void Setup_Port_B_Pins(void);
+void Setup_GPIO_Pins(void);
+void Setup_Port_A_Interrupts(void);
 
 void Run_Task_1(void);
 void Run_Task_2(void);
@@ -65,75 +71,57 @@ void delayMs(int n);
 // Setup functions //
 /////////////////////
 
-void Setup_Port_A_Pins(void) {
-    // Enable Port A clock
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R0;
-
-    // Wait until Port A clock is fully initialized
-    while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R0) == 0);
-
-    // Unlock Port A configuration
-    GPIO_PORTA_LOCK_R = GPIO_LOCK_KEY;
-
-    // Set commit register to only work with pins PA5 - PA7
-    GPIO_PORTA_CR_R = (INPUT_BUTTON_PIN | OUTPUT_SELECTOR_PINS);
-
-    // Set output selector pins (PA6 & PA7) as outputs and rest of pins as inputs (implicitly)
-    GPIO_PORTA_DIR_R |= OUTPUT_SELECTOR_PINS;
-
-    // Disable analog functionality for PA5 - PA7
-    GPIO_PORTA_AMSEL_R &= ~(INPUT_BUTTON_PIN | OUTPUT_SELECTOR_PINS);
-
-    // Enable digital functionality for PA5 - PA7
-    GPIO_PORTA_DEN_R |= (INPUT_BUTTON_PIN | OUTPUT_SELECTOR_PINS);
-
-    // Disable all alternate functionality for PA5 - PA7
-    GPIO_PORTA_AFSEL_R &= ~(INPUT_BUTTON_PIN | OUTPUT_SELECTOR_PINS);
+// Pin configuration for the button (PA5), digit selectors (PA6 & PA7) and 7-segment LEDs (PB0 - PB7)
+// NOTE: Task 1 uses PA6 as a standalone LED output, which is the same configuration as the ones selector
+const GPIO_PinConfig TASK_PIN_CONFIG[] = {
+    {GPIO_PORT_A, INPUT_BUTTON_PIN,     GPIO_INPUT | GPIO_PULL_UP, 0},
+    {GPIO_PORT_A, OUTPUT_SELECTOR_PINS, GPIO_OUTPUT, 0},
+    {GPIO_PORT_B, OUTPUT_LED_SEG_PINS,  GPIO_OUTPUT | GPIO_PULL_UP, 0},
+    GPIO_PIN_CONFIG_END
+};
 
-    // Disable all special functionality for PA5 - PA7
-    GPIO_PORTA_PCTL_R &= ~(INPUT_BUTTON_PIN | OUTPUT_SELECTOR_PINS);
 
-    // Enable pull-up resistors for input button pin (PA5)
-    GPIO_PORTA_PUR_R |= INPUT_BUTTON_PIN;
+void Setup_GPIO_Pins(void) {
+    const GPIO_PinConfig *const pinTables[] = { TASK_PIN_CONFIG };
 
-    // Lock Port A configuration
-    GPIO_PORTA_LOCK_R = 0;
+    // Configure Ports A & B in a single pass
+    GPIO_Init_Pins(pinTables, sizeof(pinTables) / sizeof(pinTables[0]));
 }
 
 
-void Setup_Port_B_Pins(void) {
-    // Enable Port B clock
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R1;
-
-    // Wait until Port B clock is fully initialized
-    while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R1) == 0);
-
-    // Unlock Port B configuration
-    GPIO_PORTB_LOCK_R = GPIO_LOCK_KEY;
+void Setup_Port_A_Interrupts(void) {
+    // Set interrupt trigger for PA5 to be edge sensitive
+    GPIO_REG(GPIO_PORT_A, GPIO_O_IS) &= ~INPUT_BUTTON_PIN;
 
-    // Set commit register to only work with pins PB0 - PB7
-    GPIO_PORTB_CR_R = OUTPUT_LED_SEG_PINS;
+    // Set interrupt trigger for PA5 to be fired from both edges (button pressed & released)
+    GPIO_REG(GPIO_PORT_A, GPIO_O_IBE) |= INPUT_BUTTON_PIN;
 
-    // Set all LED pins (PB0 - PB7) as outputs
-    GPIO_PORTB_DIR_R |= OUTPUT_LED_SEG_PINS;
+    // Clear any prior interrupts for PA5
+    GPIO_REG(GPIO_PORT_A, GPIO_O_ICR) = INPUT_BUTTON_PIN;
 
-    // Disable all analog functionality for PB0 - PB7
-    GPIO_PORTB_AMSEL_R &= ~OUTPUT_LED_SEG_PINS;
+    // Unmask the interrupt for PA5
+    GPIO_REG(GPIO_PORT_A, GPIO_O_IM) |= INPUT_BUTTON_PIN;
 
-    // Enable digital functionality for PB0 - PB7
-    GPIO_PORTB_DEN_R |= OUTPUT_LED_SEG_PINS;
-
-    // Disable all alternate functionality for PB0 - PB7
-    GPIO_PORTB_AFSEL_R &= ~OUTPUT_LED_SEG_PINS;
+    // Set interrupt priority for GPIO Port A to level 5 & enable it
+    NVIC_SET_PRIORITY(GPIOA_IRQn, 5);
+    NVIC_ENABLE_IRQ(GPIOA_IRQn);
+}
 
-    // Disable all special functionality for PB0 - PB7
-    GPIO_PORTB_PCTL_R &= ~OUTPUT_LED_SEG_PINS;
 
-    // Enable pull-up resistors for PB0 - PB7
-    GPIO_PORTB_PUR_R |= OUTPUT_LED_SEG_PINS;
+// Mirror the push button (PA5) onto the LED (PA6) on every button edge (used by task 1)
+// NOTE: This is meant to be implicitly overriden
+void GPIOA_Handler(void) {
+    // Clear the PA5 interrupt flag (ICR is write-1-to-clear, so a direct store is enough)
+    GPIO_REG(GPIO_PORT_A, GPIO_O_ICR) = INPUT_BUTTON_PIN;
 
-    // Lock Port B configuration
-    GPIO_PORTB_LOCK_R = 0;
+    // Check if input button is pressed or not via PA5
+    if (GPIO_READ_PINS(GPIO_PORT_A, INPUT_BUTTON_PIN) != 0) { // = 0x20 (PA5)
+        // Turn on output LED via PA6
+        GPIO_SET_PINS(GPIO_PORT_A, OUTPUT_LED_PIN);	// = 0x40 (PA6)
+    } else {
+        // Turn off output LED via PA6
+        GPIO_CLEAR_PINS(GPIO_PORT_A, OUTPUT_LED_PIN);	// = 0x40 (PA6)
+    }
 }
 
 ////////////////////////
@@ -148,17 +136,18 @@ void Setup_Port_B_Pins(void) {
 * - Standalone LED: PA6
 */
 void Run_Task_1(void) {
+    // Only Port A keeps its clock while sleeping, to detect the button edges
+    const Power_SleepClocks sleepClocks = { (1UL << GPIO_PORT_A), 0, 0, 0, 0, 0, 0 };
 
-    for (;;) {
-        // Check if input button is pressed or not via PA5
-        if ((GPIO_PORTA_DATA_R & INPUT_BUTTON_PIN) == 1) { // = 0x20 (PA5)
-            // Turn on output LED via PA6
-            GPIO_PORTA_DATA_R |= OUTPUT_LED_PIN;	// = 0x40 (PA6)
-        } else {
-            // Turn off output LED via PA6
-            GPIO_PORTA_DATA_R &= ~OUTPUT_LED_PIN;	// = 0x40 (PA6)
-        }
-    }
+    // Instead of polling the button, let its edge interrupt update the LED (see GPIOA_Handler)
+    Setup_Port_A_Interrupts();
+
+    // Apply the current button state once, since no edge has happened yet
+    NVIC_SET_PENDING_IRQ(GPIOA_IRQn);
+
+    // Sleep for good, only waking up to run GPIOA_Handler
+    Power_Init(&sleepClocks);
+    Power_Sleep_On_Exit();
 }
 
 
@@ -173,6 +162,10 @@ void Run_Task_2(void) {
     unsigned int n = 0, counter = 0;
     unsigned int tens = 0, ones = 0;
 
+    // Only SysTick has to wake up the core, so every peripheral clock can be gated while sleeping
+    const Power_SleepClocks sleepClocks = { 0, 0, 0, 0, 0, 0, 0 };
+    Power_Init(&sleepClocks);
+
     for (;;) {
         // Trigger an increment to the display number (n) roughly every 500 ms (10 ms per iteration * 50 counts)
         if (counter >= 50) {
@@ -206,38 +199,31 @@ void Run_Task_2(void) {
 
 void Display_Tens_Digit(unsigned int n) {
     // Drive pattern of first number on 7-segment LEDs
-    GPIO_PORTB_DATA_R = SEG_7_PATTERNS[n];
+    GPIO_WRITE_PINS(GPIO_PORT_B, OUTPUT_LED_SEG_PINS, SEG_7_PATTERNS[n]);
 
-    // Enable left digit via PA7
-    GPIO_PORTA_DATA_R &= ~OUTPUT_ONES_SELECTOR_PIN;	// = 0x40 (PA6)
-
-    // Disable right digit via PA6
-    GPIO_PORTA_DATA_R |= OUTPUT_TENS_SELECTOR_PIN;	// = 0x80 (PA7)
+    // Enable left digit via PA7 & disable right digit via PA6 in a single store
+    GPIO_WRITE_PINS(GPIO_PORT_A, OUTPUT_SELECTOR_PINS, OUTPUT_TENS_SELECTOR_PIN);	// = 0x80 (PA7)
 }
 
 
 void Display_Ones_Digit(unsigned int n) {
     // Drive pattern of second number on 7-segment LEDs
-    GPIO_PORTB_DATA_R = SEG_7_PATTERNS[n];
-
-    // Disable left digit via PA7
-    GPIO_PORTA_DATA_R |= OUTPUT_ONES_SELECTOR_PIN;	// = 0x40 (PD6)
+    GPIO_WRITE_PINS(GPIO_PORT_B, OUTPUT_LED_SEG_PINS, SEG_7_PATTERNS[n]);
 
-    // Enable right digit via PA6
-    GPIO_PORTA_DATA_R &= ~OUTPUT_TENS_SELECTOR_PIN;	// = 0x80 (PA7)
+    // Disable left digit via PA7 & enable right digit via PA6 in a single store
+    GPIO_WRITE_PINS(GPIO_PORT_A, OUTPUT_SELECTOR_PINS, OUTPUT_ONES_SELECTOR_PIN);	// = 0x40 (PA6)
 }
 
 ///////////////////////
 // Utility functions //
 ///////////////////////
 
-// Delay by 'n' milliseconds (16 MHz CPU clock)
+// Delay by 'n' milliseconds via SysTick, sleeping in between (16 MHz CPU clock)
 void delayMs(int n)
 {
-    int i, j;
+    int i;
     for (i = 0 ; i < n; i++)
-        for (j = 0; j < 3180; j++)
-            {} // do nothing for 1 ms
+        SysTick_Wait(16000); // sleep for 16,000 * 62.5 ns = 1 ms
 }
 
 //////////////////
@@ -251,8 +237,8 @@ void delayMs(int n)
 int main(void)
 {
     // Setup phase
-    Setup_Port_A_Pins();
-    Setup_Port_B_Pins();
+    SysTick_Init();
+    Setup_GPIO_Pins();
 
     // Running task phase
     // NOTE: Change TASK_NUM above based on which lab task to run and recompile
@@ -1,5 +1,10 @@
+#include <stddef.h>
+
 #include "mcu/tm4c123gh6pm.h"
 #include "mcu/mcu_utils.h"
+#include "gpio/gpio.h"
+#include "nvic/Interrupt.h"
+#include "power/power.h"
 #include "keypad_driver.h"
 
 
@@ -11,82 +16,20 @@ const unsigned char KEYMAP[4][4] = {
 };
 
 
-void Keypad_Init(void) {
-    Setup_Keypad_GPIO_Row_Pins();
-    Setup_Keypad_GPIO_Column_Pins();
-}
-
-
-void Setup_Keypad_GPIO_Column_Pins(void) {
-    // Enable Port C clock
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R2;
-
-    // Wait until Port C clock is fully initialized
-    while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R2) == 0);
-
-    // Unlock Port C configuration
-    GPIO_PORTC_LOCK_R = GPIO_LOCK_KEY;
-
-    // Set commit register to only work with pins PC4 - PC7
-    GPIO_PORTC_CR_R = KEYPAD_ALL_COLS;
-
-    // Set all LED pins (PC4 - PC7) as inputs
-    GPIO_PORTC_DIR_R |= ~KEYPAD_ALL_COLS;
-
-    // Disable all analog functionality for PC4 - PC7
-    GPIO_PORTC_AMSEL_R &= ~KEYPAD_ALL_COLS;
-
-    // Enable digital functionality for PC4 - PC7
-    GPIO_PORTC_DEN_R |= KEYPAD_ALL_COLS;
-
-    // Disable all alternate functionality for PC4 - PC7
-    GPIO_PORTC_AFSEL_R &= ~KEYPAD_ALL_COLS;
-
-    // Disable all special functionality for PC4 - PC7
-    GPIO_PORTC_PCTL_R &= ~KEYPAD_ALL_COLS;
-
-    // Enable pull-up resistors for PC4 - PC7
-    GPIO_PORTC_PUR_R |= KEYPAD_ALL_COLS;
-
-    // Lock Port C configuration
-    GPIO_PORTC_LOCK_R = 0;
-}
-
-
-void Setup_Keypad_GPIO_Row_Pins(void) {
-    // Enable Port E clock
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R4;
-
-    // Wait until Port E clock is fully initialized
-    while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R4) == 0);
-
-    // Unlock Port E configuration
-    GPIO_PORTE_LOCK_R = GPIO_LOCK_KEY;
-
-    // Set commit register to only work with pins PE0 - PE3
-    GPIO_PORTE_CR_R = KEYPAD_ALL_ROWS;
-
-    // Set all LED pins (PE0 - PE3) as outputs
-    GPIO_PORTE_DIR_R |= KEYPAD_ALL_ROWS;
-
-    // Disable all analog functionality for PE0 - PE3
-    GPIO_PORTE_AMSEL_R &= ~KEYPAD_ALL_ROWS;
-
-    // Enable digital functionality for PE0 - PE3
-    GPIO_PORTE_DEN_R |= KEYPAD_ALL_ROWS;
-
-    // Disable all alternate functionality for PE0 - PE3
-    GPIO_PORTE_AFSEL_R &= ~KEYPAD_ALL_ROWS;
+// Pin configuration for the keypad rows (PE0 - PE3) & columns (PC4 - PC7)
+// - Rows are open-drain outputs, pulling the selected row to GND
+// - Columns are inputs with pull-up resistors, reading low when a key on the selected row is pressed
+const GPIO_PinConfig KEYPAD_PIN_CONFIG[] = {
+    {GPIO_PORT_E, KEYPAD_ALL_ROWS, GPIO_OUTPUT | GPIO_OPEN_DRAIN, 0},
+    {GPIO_PORT_C, KEYPAD_ALL_COLS, GPIO_INPUT | GPIO_PULL_UP, 0},
+    GPIO_PIN_CONFIG_END
+};
 
-    // Disable all special functionality for PE0 - PE3
-    GPIO_PORTE_PCTL_R &= ~KEYPAD_ALL_ROWS;
+// Set by GPIOC_Handler when a column falls (i.e. a key got pressed), cleared by Keypad_Wait_For_Key()
+static volatile int keypadColumnFell = 0;
 
-    // Enable open-drain mode for PE0 - PE3
-    GPIO_PORTE_ODR_R |= KEYPAD_ALL_ROWS;
-
-    // Lock Port E configuration
-    GPIO_PORTE_LOCK_R = 0;
-}
+// Active object running Keypad_Read_Key_Thread(), sent KEYPAD_SIGNAL_COLUMN by GPIOC_Handler
+static Active *keypadOwner = NULL;
 
 
 unsigned char getKey(void) {
@@ -94,10 +37,10 @@ unsigned char getKey(void) {
     unsigned char colPins;
 
     // Set all rows to GND
-    GPIO_PORTE_DATA_R = 0x0F;
+    GPIO_WRITE_PINS(GPIO_PORT_E, KEYPAD_ALL_ROWS, 0x00);
 
     // Read the key inputs on PC4 - PC7
-    k_col = (GPIO_PORTC_DATA_R & 0xF0);
+    k_col = GPIO_READ_PINS(GPIO_PORT_C, KEYPAD_ALL_COLS);
 
     // If no key is pressed, return early
     if (k_col == 0xF0) {
@@ -107,13 +50,13 @@ unsigned char getKey(void) {
     while (1) {
         for (k_row = 0; k_row <= 3; k_row++) {
             // Set k_row-th to GND
-            GPIO_PORTE_DATA_R = (0x0F & ~(1 << k_row));
+            GPIO_WRITE_PINS(GPIO_PORT_E, KEYPAD_ALL_ROWS, (0x0F & ~(1 << k_row)));
 
             // Delay 10 us to handle debounce from mechanical key
             Delay_Micro(10);
 
             // Read each column from PC4 to PC7
-            colPins = (GPIO_PORTC_DATA_R & 0xF0) >> 4;
+            colPins = GPIO_READ_PINS(GPIO_PORT_C, KEYPAD_ALL_COLS) >> 4;
             for (k_col = 0; k_col <= 3; k_col++) {
                 // Check that the k_col-th column has a key pressed
                 if (colPins == (0x0F & ~(1 << k_col))) {
@@ -124,3 +67,93 @@ unsigned char getKey(void) {
         }
     }
 }
+
+
+// Setup falling edge interrupts on the columns (PC4 - PC7), so that a key press can wake up the core
+// NOTE: The keypad pins (KEYPAD_PIN_CONFIG) must be configured via GPIO_Init_Pins() beforehand
+void Keypad_Init_Wakeup(void) {
+    // Set interrupt trigger for PC4 - PC7 to be edge sensitive
+    GPIO_REG(GPIO_PORT_C, GPIO_O_IS) &= ~KEYPAD_ALL_COLS;
+
+    // Set interrupt trigger for PC4 - PC7 to be fired from the falling edge only (key pressed)
+    GPIO_REG(GPIO_PORT_C, GPIO_O_IBE) &= ~KEYPAD_ALL_COLS;
+    GPIO_REG(GPIO_PORT_C, GPIO_O_IEV) &= ~KEYPAD_ALL_COLS;
+
+    // Clear any prior interrupts for PC4 - PC7
+    GPIO_REG(GPIO_PORT_C, GPIO_O_ICR) = KEYPAD_ALL_COLS;
+
+    // Unmask the interrupt for PC4 - PC7
+    GPIO_REG(GPIO_PORT_C, GPIO_O_IM) |= KEYPAD_ALL_COLS;
+
+    // Set interrupt priority for GPIO Port C to level 5 & enable it
+    NVIC_SET_PRIORITY(GPIOC_IRQn, 5);
+    NVIC_ENABLE_IRQ(GPIOC_IRQn);
+}
+
+
+// NOTE: This is meant to be implicitly overriden
+void GPIOC_Handler(void) {
+    // Clear the PC4 - PC7 interrupt flags (ICR is write-1-to-clear, so a direct store is enough)
+    GPIO_REG(GPIO_PORT_C, GPIO_O_ICR) = KEYPAD_ALL_COLS;
+
+    keypadColumnFell = 1;
+
+    if (keypadOwner != NULL)
+        Active_Post(keypadOwner, KEYPAD_SIGNAL_COLUMN, 0, NULL);
+}
+
+
+// Sleep until a key is pressed, then return it
+// NOTE: Requires Keypad_Init_Wakeup() beforehand, and must not be called with interrupts disabled
+unsigned char Keypad_Wait_For_Key(void) {
+    unsigned char key;
+
+    while (1) {
+        // Set all rows to GND, so that pressing any key pulls its column low
+        keypadColumnFell = 0;
+        GPIO_WRITE_PINS(GPIO_PORT_E, KEYPAD_ALL_ROWS, 0x00);
+
+        // Sleep until a column falls, unless a key is already being held down
+        __disable_irq();
+        while (!keypadColumnFell && GPIO_READ_PINS(GPIO_PORT_C, KEYPAD_ALL_COLS) == KEYPAD_ALL_COLS)
+            Power_Sleep();
+        __enable_irq();
+
+        // Scan for the pressed key (which may have been released already by now)
+        key = getKey();
+        if (key != 0)
+            return key;
+    }
+}
+
+
+// Set the active object running Keypad_Read_Key_Thread(), to be resumed when a column falls
+void Keypad_Set_Owner(Active *owner) {
+    keypadOwner = owner;
+}
+
+
+// Same as Keypad_Wait_For_Key(), but giving the CPU back while waiting for a key & for the contacts to settle
+int Keypad_Read_Key_Thread(PT *pt, unsigned char *key) {
+    PT_BEGIN(pt);
+
+    while (1) {
+        // Set all rows to GND, so that pressing any key pulls its column low
+        keypadColumnFell = 0;
+        GPIO_WRITE_PINS(GPIO_PORT_E, KEYPAD_ALL_ROWS, 0x00);
+
+        // Wait until a column falls, unless a key is already being held down
+        PT_WAIT_UNTIL(pt, keypadColumnFell || GPIO_READ_PINS(GPIO_PORT_C, KEYPAD_ALL_COLS) != KEYPAD_ALL_COLS);
+
+        // Let the contacts settle before scanning
+        AWAIT_TICKS(pt, KEYPAD_DEBOUNCE_TICKS);
+
+        // Scan for the pressed key (which may have been released already by now)
+        // NOTE: The 10 us settling time per row is far below a tick, so the scan itself stays a busy wait
+        *key = getKey();
+        if (*key != 0)
+            break;
+    }
+
+    PT_END(pt);
+}
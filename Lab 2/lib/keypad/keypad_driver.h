@@ -1,6 +1,10 @@
 #ifndef KEYPAD__DRIVER
 #define KEYPAD__DRIVER
 
+#include "gpio/gpio.h"
+#include "active/active.h"
+#include "pt/pt.h"
+
 
 // Keypad pin definitions
 #define KEYPAD_ROW1		0x01 // = 0x01 (PE0)
@@ -13,19 +17,36 @@
 #define KEYPAD_COL2		0x20 // = 0x40 (PC5)
 #define KEYPAD_COL3		0x40 // = 0x20 (PC6)
 #define KEYPAD_COL4		0x80 // = 0x10 (PC7)
-#define KEYPAD_ALL_COLS 0x0F // = 0x80 (PC7) | 0x40 (PC6) | 0x20 (PC5) | 0x10 (PC4)
+#define KEYPAD_ALL_COLS 0xF0 // = 0x80 (PC7) | 0x40 (PC6) | 0x20 (PC5) | 0x10 (PC4)
 
 #define KEYPAD_ALL_PINS (KEYPAD_ALL_ROWS | KEYPAD_ALL_COLS)
 
 
+// Signal of the event posted to the active object running Keypad_Read_Key_Thread() when a column falls
+// NOTE: That active object must not use it for anything else
+#define KEYPAD_SIGNAL_COLUMN 0xFEu
+
+// Ticks (ms) to wait for the contacts to settle after a column falls, before scanning the rows
+#define KEYPAD_DEBOUNCE_TICKS 20
+
 // Constant definitions for Keypad device driver
 extern const unsigned char KEYMAP[4][4];
 
+// Pin configuration table for Keypad device driver (to be passed to GPIO_Init_Pins())
+extern const GPIO_PinConfig KEYPAD_PIN_CONFIG[];
+
 // Function signatures for Keypad device driver
-extern void Keypad_Init(void);
-extern void Setup_Keypad_GPIO_Column_Pins(void);
-extern void Setup_Keypad_GPIO_Row_Pins(void);
 extern unsigned char getKey(void);
+extern void Keypad_Init_Wakeup(void);
+extern unsigned char Keypad_Wait_For_Key(void);
+
+// Set the active object running Keypad_Read_Key_Thread(), to be resumed when a column falls
+extern void Keypad_Set_Owner(Active *owner);
+
+// Protothread version of Keypad_Wait_For_Key() (see "pt/pt.h"), giving the CPU back until a key is pressed &
+// setting 'key' to it before ending
+// NOTE: Requires Keypad_Init_Wakeup() & Keypad_Set_Owner() beforehand, and assumes 1 ms ticks
+extern int Keypad_Read_Key_Thread(PT *pt, unsigned char *key);
 
 
 #endif /* KEYPAD__DRIVER */
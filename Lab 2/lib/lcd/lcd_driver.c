@@ -1,5 +1,6 @@
 #include "mcu/tm4c123gh6pm.h"
 #include "mcu/mcu_utils.h"
+#include "gpio/gpio.h"
 #include "lcd_driver.h"
 
 
@@ -17,10 +18,8 @@
  */
 
 
+// NOTE: The LCD pins (LCD_PIN_CONFIG) must be configured via GPIO_Init_Pins() beforehand
 void LCD_4Bits_Init(void) {
-    // Setup LCD GPIO Pins
-    Setup_LCD_GPIO_Pins();
-
     // Sets cursor to beginning of display and unshifts display if set before
     LCD_4Bits_Cmd(LCD_RETURN_HOME); // 0x02
 
@@ -39,37 +38,11 @@ void LCD_4Bits_Init(void) {
 }
 
 
-void Setup_LCD_GPIO_Pins(void) {
-    // Enable Port B clock
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R1;
-
-    // Wait until Port B clock is fully initialized
-    while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R1) == 0);
-
-    // Unlock Port B configuration
-    GPIO_PORTB_LOCK_R = GPIO_LOCK_KEY;
-
-    // Set commit register to only work with pins PB0 - PB2 & PB4 - PB7
-    GPIO_PORTB_CR_R = LCD_ALL_PINS;
-
-    // Set all LED pins (PB0 - PB2 & PB4 - PB7) as outputs
-    GPIO_PORTB_DIR_R |= LCD_ALL_PINS;
-
-    // Disable all analog functionality for PB0 - PB2 & PB4 - PB7
-    GPIO_PORTB_AMSEL_R &= ~LCD_ALL_PINS;
-
-    // Enable digital functionality for PB0 - PB2 & PB4 - PB7
-    GPIO_PORTB_DEN_R |= LCD_ALL_PINS;
-
-    // Disable all alternate functionality for PB0 - PB2 & PB4 - PB7
-    GPIO_PORTB_AFSEL_R &= ~LCD_ALL_PINS;
-
-    // Disable all special functionality for PB0 - PB2 & PB4 - PB7
-    GPIO_PORTB_PCTL_R &= ~LCD_ALL_PINS;
-
-    // Lock Port B configuration
-    GPIO_PORTB_LOCK_R = 0;
-}
+// Pin configuration for the LCD control pins (PB0 - PB2) & data pins (PB4 - PB7)
+const GPIO_PinConfig LCD_PIN_CONFIG[] = {
+    {GPIO_PORT_B, LCD_ALL_PINS, GPIO_OUTPUT, 0},
+    GPIO_PIN_CONFIG_END
+};
 
 
 void LCD_Write4Bits(unsigned char data, unsigned char control) {
@@ -79,13 +52,15 @@ void LCD_Write4Bits(unsigned char data, unsigned char control) {
     unsigned char dataPacket = ((data & 0xF0) | (control & 0x0F));
 
     // Send both data and the control signals to LCD through the GPIODATA register. Secure the sent signals by EN.
-    GPIO_PORTB_DATA_R = (dataPacket | LCD_EN_ENABLE_MODE);
+    // NOTE: Only the LCD pins are written, leaving PB3 untouched
+    GPIO_WRITE_PINS(GPIO_PORT_B, LCD_ALL_PINS, (dataPacket | LCD_EN_ENABLE_MODE));
 
     // Allow some delay to let sent data be processed by LCD
     Delay_Micro(3);
 
     // Set back to the data without EN.
-    GPIO_PORTB_DATA_R ^= LCD_EN_ENABLE_MODE;
+    // NOTE: Only the EN pin is written, so the strobe cannot disturb any other pin on Port B
+    GPIO_CLEAR_PINS(GPIO_PORT_B, LCD_EN_PIN);
 }
 
 
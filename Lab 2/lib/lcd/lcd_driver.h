@@ -1,6 +1,8 @@
 #ifndef LCD__DRIVER
 #define LCD__DRIVER
 
+#include "gpio/gpio.h"
+
 // LCD Datasheet: https://www.sparkfun.com/datasheets/LCD/HD44780.pdf
 
 // LCD pin definitions
@@ -70,9 +72,11 @@
 #define LCD_EN_DISABLE_MODE	0x00u
 
 
+// Pin configuration table for LCD device driver (to be passed to GPIO_Init_Pins())
+extern const GPIO_PinConfig LCD_PIN_CONFIG[];
+
 // Function signatures for LCD device driver
 extern void LCD_4Bits_Init(void);
-extern void Setup_LCD_GPIO_Pins(void);
 extern void LCD_Write4Bits(unsigned char data, unsigned char control);
 extern void LCD_Write8Bits_4BitMode(unsigned char data, unsigned char control);
 extern void LCD_4Bits_Cmd(unsigned char command);
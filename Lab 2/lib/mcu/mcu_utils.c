@@ -1,3 +1,6 @@
+#include <stdint.h>
+
+#include "systick/SysTick.h"
 #include "mcu_utils.h"
 
 ///////////////////////
@@ -5,6 +8,7 @@
 ///////////////////////
 
 // Delay by 'n' microseconds (16 MHz CPU clock)
+// NOTE: Too short to be worth sleeping through, so this stays a busy loop
 void Delay_Micro(int n) {
 	int i, j;
 	for (i = 0; i < n; i++) {
@@ -13,11 +17,12 @@ void Delay_Micro(int n) {
 	}
 }
 
-// Delay by 'n' milliseconds (16 MHz CPU clock)
+// Delay by 'n' milliseconds via SysTick, sleeping in between (16 MHz CPU clock)
+// NOTE: Requires SysTick_Init() beforehand
 void Delay_Milli(int n) {
-	int i, j;
+	int i;
 	for (i = 0; i < n; i++) {
-		for (j = 0; j < 3180; j++)
-			{} // do nothing for 1 ms
+		// Wait for duration of 16,000 * 62.5 ns
+		SysTick_Wait(16000);
 	}
 }
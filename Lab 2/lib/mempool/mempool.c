@@ -0,0 +1,150 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "nvic/Interrupt.h"
+#include "mempool.h"
+
+
+// Free blocks hold the link to the next free block in their first word
+typedef struct MemPool_Block {
+    struct MemPool_Block *next;
+} MemPool_Block;
+
+typedef struct {
+    uint8_t *start;                 // First block
+    uint8_t *end;                   // Just past the last block
+    unsigned int blockSize;
+    unsigned int blockCount;
+    MemPool_Block *freeList;
+    unsigned int freeBlocks;
+    unsigned int minFreeBlocks;
+    unsigned long failedAllocs;
+} MemPool;
+
+// Block storage, declared as 64-bit words so every block is 8-byte aligned (for doubles & 64-bit integers)
+static uint64_t smallStorage[MEMPOOL_SMALL_BLOCK_SIZE / 8 * MEMPOOL_SMALL_BLOCK_COUNT];
+static uint64_t mediumStorage[MEMPOOL_MEDIUM_BLOCK_SIZE / 8 * MEMPOOL_MEDIUM_BLOCK_COUNT];
+static uint64_t largeStorage[MEMPOOL_LARGE_BLOCK_SIZE / 8 * MEMPOOL_LARGE_BLOCK_COUNT];
+
+// Pools sorted by block size, smallest first
+static MemPool pools[MEMPOOL_COUNT];
+
+
+// Chain every block of 'storage' into the free list of 'pool'
+static void MemPool_Setup(MemPool *pool, uint64_t *storage, unsigned int blockSize, unsigned int blockCount) {
+    unsigned int i;
+
+    pool->start = (uint8_t *) storage;
+    pool->end = pool->start + blockSize * blockCount;
+    pool->blockSize = blockSize;
+    pool->blockCount = blockCount;
+    pool->freeList = NULL;
+    pool->freeBlocks = blockCount;
+    pool->minFreeBlocks = blockCount;
+    pool->failedAllocs = 0;
+
+    // Link the blocks back to front, so they get handed out in address order
+    for (i = blockCount; i > 0; i--) {
+        MemPool_Block *block = (MemPool_Block *) (pool->start + (i - 1) * blockSize);
+        block->next = pool->freeList;
+        pool->freeList = block;
+    }
+}
+
+
+// Setup the free lists of every pool
+void MemPool_Init(void) {
+    uint32_t saved = Interrupt_Framework_Save();
+
+    MemPool_Setup(&pools[0], smallStorage, MEMPOOL_SMALL_BLOCK_SIZE, MEMPOOL_SMALL_BLOCK_COUNT);
+    MemPool_Setup(&pools[1], mediumStorage, MEMPOOL_MEDIUM_BLOCK_SIZE, MEMPOOL_MEDIUM_BLOCK_COUNT);
+    MemPool_Setup(&pools[2], largeStorage, MEMPOOL_LARGE_BLOCK_SIZE, MEMPOOL_LARGE_BLOCK_COUNT);
+
+    Interrupt_Framework_Restore(saved);
+}
+
+
+// Take a block of at least 'size' bytes (8-byte aligned), returning NULL if every pool big enough is empty
+void *MemPool_Alloc(unsigned int size) {
+    MemPool_Block *block;
+    MemPool *pool;
+    uint32_t saved;
+    unsigned int best, i;
+
+    // Find the best fitting pool (requests that don't fit anywhere get counted against the largest)
+    for (best = 0; best < MEMPOOL_COUNT - 1; best++) {
+        if (size <= pools[best].blockSize)
+            break;
+    }
+
+    saved = Interrupt_Framework_Save();
+
+    if (size <= pools[best].blockSize) {
+        for (i = best; i < MEMPOOL_COUNT; i++) {
+            pool = &pools[i];
+            block = pool->freeList;
+
+            if (block != NULL) {
+                pool->freeList = block->next;
+                pool->freeBlocks--;
+
+                if (pool->freeBlocks < pool->minFreeBlocks)
+                    pool->minFreeBlocks = pool->freeBlocks;
+
+                Interrupt_Framework_Restore(saved);
+                return block;
+            }
+        }
+    }
+
+    pools[best].failedAllocs++;
+
+    Interrupt_Framework_Restore(saved);
+    return NULL;
+}
+
+
+// Give a block from MemPool_Alloc() back to its pool (NULL is ignored)
+// NOTE: The pool is found from the block's address, so the size doesn't have to be passed back in
+void MemPool_Free(void *block) {
+    uint8_t *address = (uint8_t *) block;
+    MemPool *pool;
+    uint32_t saved;
+    unsigned int i;
+
+    for (i = 0; i < MEMPOOL_COUNT; i++) {
+        pool = &pools[i];
+
+        if (address >= pool->start && address < pool->end) {
+            saved = Interrupt_Framework_Save();
+
+            ((MemPool_Block *) block)->next = pool->freeList;
+            pool->freeList = (MemPool_Block *) block;
+            pool->freeBlocks++;
+
+            Interrupt_Framework_Restore(saved);
+            return;
+        }
+    }
+}
+
+
+// Usage statistics of pool 'pool' (0 = smallest, MEMPOOL_COUNT - 1 = largest)
+void MemPool_Get_Stats(unsigned int pool, MemPool_Stats *stats) {
+    uint32_t saved;
+
+    if (pool >= MEMPOOL_COUNT)
+        return;
+
+    // Take a consistent snapshot, since a handler could allocate in between the reads
+    saved = Interrupt_Framework_Save();
+
+    stats->blockSize = pools[pool].blockSize;
+    stats->blockCount = pools[pool].blockCount;
+    stats->freeBlocks = pools[pool].freeBlocks;
+    stats->minFreeBlocks = pools[pool].minFreeBlocks;
+    stats->failedAllocs = pools[pool].failedAllocs;
+
+    Interrupt_Framework_Restore(saved);
+}
@@ -0,0 +1,66 @@
+#ifndef MCU_MEMPOOL
+#define MCU_MEMPOOL
+
+#include <stdint.h>
+
+// Fixed-block memory pools in static RAM, for passing variable data between interrupt handlers & the main code
+// without a heap (the startup file reserves none)
+// - MemPool_Alloc() takes a block from the smallest pool whose blocks fit, and MemPool_Free() gives it back
+// - Each pool keeps its free blocks in a linked list threaded through the blocks themselves, so both are
+//   O(1) and run with interrupts disabled for only a few instructions (safe to call from any handler at or
+//   below INTERRUPT_FRAMEWORK_PRIORITY, see "Interrupt.h")
+//
+// Pool sizes (in bytes, multiples of 8) & block counts, smallest first
+// NOTE: Overridable per project, i.e. via the C/C++ "Define" field in the Keil project options
+#ifndef MEMPOOL_SMALL_BLOCK_SIZE
+#define MEMPOOL_SMALL_BLOCK_SIZE    16
+#endif
+
+#ifndef MEMPOOL_SMALL_BLOCK_COUNT
+#define MEMPOOL_SMALL_BLOCK_COUNT   16
+#endif
+
+#ifndef MEMPOOL_MEDIUM_BLOCK_SIZE
+#define MEMPOOL_MEDIUM_BLOCK_SIZE   64
+#endif
+
+#ifndef MEMPOOL_MEDIUM_BLOCK_COUNT
+#define MEMPOOL_MEDIUM_BLOCK_COUNT  8
+#endif
+
+#ifndef MEMPOOL_LARGE_BLOCK_SIZE
+#define MEMPOOL_LARGE_BLOCK_SIZE    256
+#endif
+
+#ifndef MEMPOOL_LARGE_BLOCK_COUNT
+#define MEMPOOL_LARGE_BLOCK_COUNT   2
+#endif
+
+#define MEMPOOL_COUNT 3
+
+// Usage statistics of 1 pool
+typedef struct {
+    unsigned int blockSize;
+    unsigned int blockCount;
+    unsigned int freeBlocks;        // Right now
+    unsigned int minFreeBlocks;     // Low watermark since MemPool_Init(), to size the block counts with
+    unsigned long failedAllocs;     // Requests that didn't fit into this pool or any larger one
+} MemPool_Stats;
+
+
+// Setup the free lists of every pool
+// NOTE: Must be done before the first MemPool_Alloc(), including from any interrupt handler
+extern void MemPool_Init(void);
+
+// Take a block of at least 'size' bytes (8-byte aligned), returning NULL if every pool big enough is empty
+// NOTE: Falls back to the next larger pool when the best fitting one is empty
+extern void *MemPool_Alloc(unsigned int size);
+
+// Give a block from MemPool_Alloc() back to its pool (NULL is ignored)
+extern void MemPool_Free(void *block);
+
+// Usage statistics of pool 'pool' (0 = smallest, MEMPOOL_COUNT - 1 = largest)
+extern void MemPool_Get_Stats(unsigned int pool, MemPool_Stats *stats);
+
+
+#endif /* MCU_MEMPOOL */
@@ -0,0 +1,135 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "ringbuf.h"
+
+// Full memory barrier: no memory access may be moved across it, by the compiler or the CPU
+// NOTE: The Cortex-M4 doesn't reorder its own accesses, so this mostly stops the compiler, but it keeps the
+// code correct on multi-core host machines as well
+#ifdef __ARMCC_VERSION
+#define RINGBUF_BARRIER() __dmb(0xF)
+#else
+#define RINGBUF_BARRIER() __sync_synchronize()
+#endif
+
+
+// Copy 'count' elements between 'elements' & the ring starting at slot 'index', wrapping around its end
+// (at most 2 memcpy() calls, so bulk transfers run at memcpy speed)
+static void RingBuf_Copy_In(RingBuf *ring, unsigned int index, const uint8_t *elements, unsigned int count) {
+    unsigned int slot = index & (ring->capacity - 1);
+    unsigned int first = ring->capacity - slot;
+
+    if (first > count)
+        first = count;
+
+    memcpy(ring->storage + slot * ring->elementSize, elements, first * ring->elementSize);
+    memcpy(ring->storage, elements + first * ring->elementSize, (count - first) * ring->elementSize);
+}
+
+
+static void RingBuf_Copy_Out(const RingBuf *ring, unsigned int index, uint8_t *elements, unsigned int count) {
+    unsigned int slot = index & (ring->capacity - 1);
+    unsigned int first = ring->capacity - slot;
+
+    if (first > count)
+        first = count;
+
+    memcpy(elements, ring->storage + slot * ring->elementSize, first * ring->elementSize);
+    memcpy(elements + first * ring->elementSize, ring->storage, (count - first) * ring->elementSize);
+}
+
+
+// Setup 'ring' on top of 'storage' (capacity * elementSize bytes), returning 0 if 'capacity' isn't a power of 2
+int RingBuf_Init(RingBuf *ring, void *storage, unsigned int elementSize, unsigned int capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0 || elementSize == 0)
+        return 0;
+
+    ring->storage = (uint8_t *) storage;
+    ring->capacity = capacity;
+    ring->elementSize = elementSize;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->highWater = 0;
+
+    return 1;
+}
+
+
+// Producer side: queue 1 element, returning 0 if the ring is full
+int RingBuf_Push(RingBuf *ring, const void *element) {
+    return RingBuf_Push_Many(ring, element, 1) == 1;
+}
+
+
+// Producer side: queue up to 'count' elements, returning how many were queued
+unsigned int RingBuf_Push_Many(RingBuf *ring, const void *elements, unsigned int count) {
+    unsigned int head = ring->head;
+    unsigned int tail = ring->tail;
+    unsigned int space = ring->capacity - (head - tail);
+
+    if (count > space)
+        count = space;
+
+    if (count == 0)
+        return 0;
+
+    // Only write the slots once the consumer is done reading them out (it releases them via the tail)
+    RINGBUF_BARRIER();
+    RingBuf_Copy_In(ring, head, (const uint8_t *) elements, count);
+
+    // Publish the new elements only after they have been written
+    RINGBUF_BARRIER();
+    ring->head = head + count;
+
+    if (head + count - tail > ring->highWater)
+        ring->highWater = head + count - tail;
+
+    return count;
+}
+
+
+// Consumer side: take the oldest element, returning 0 if the ring is empty
+int RingBuf_Pop(RingBuf *ring, void *element) {
+    return RingBuf_Pop_Many(ring, element, 1) == 1;
+}
+
+
+// Consumer side: take up to 'maxCount' of the oldest elements, returning how many were taken
+unsigned int RingBuf_Pop_Many(RingBuf *ring, void *elements, unsigned int maxCount) {
+    unsigned int tail = ring->tail;
+    unsigned int available = ring->head - tail;
+
+    if (maxCount > available)
+        maxCount = available;
+
+    if (maxCount == 0)
+        return 0;
+
+    // Make sure the elements are read only after the index that published them
+    RINGBUF_BARRIER();
+    RingBuf_Copy_Out(ring, tail, (uint8_t *) elements, maxCount);
+
+    // Release the slots only after the elements have been read out
+    RINGBUF_BARRIER();
+    ring->tail = tail + maxCount;
+
+    return maxCount;
+}
+
+
+// Number of queued elements
+unsigned int RingBuf_Count(const RingBuf *ring) {
+    return ring->head - ring->tail;
+}
+
+
+// Number of free slots
+unsigned int RingBuf_Free(const RingBuf *ring) {
+    return ring->capacity - (ring->head - ring->tail);
+}
+
+
+// Most elements ever queued at once since RingBuf_Init()
+unsigned int RingBuf_High_Water(const RingBuf *ring) {
+    return ring->highWater;
+}
@@ -12,18 +12,46 @@
  *   - Bit test: (arg & (1 << pinN) == 1)
  */
 
+#include <stdint.h>
+
 // Include the Device header
 #include "lib/mcu/tm4c123gh6pm.h"
 #include "lib/mcu/mcu_utils.h"
+#include "lib/systick/SysTick.h"
+#include "lib/power/power.h"
 #include "lib/lcd/lcd_driver.h"
 #include "lib/keypad/keypad_driver.h"
+#include "lib/gpio/gpio.h"
+#include "lib/mempool/mempool.h"
+#include "lib/active/active.h"
+#include "lib/pt/pt.h"
 
 void Run_Task_1(void);
 void Run_Task_2(void);
+void Task_2_Handler(Active *self, const Active_Event *event);
+int Task_2_Thread(PT *pt);
 
 // Used for defining which task from the lab to run. Change number and recompile as necessary.
 #define TASK_NUM 1
 
+// Active objects (see "active.h") for task 2, ticking every 1 ms at the default 16 MHz clock
+#define SYS_CLOCK_HZ 16000000UL
+#define ACTIVE_TICK_HZ 1000UL
+#define TASK_2_PRIORITY 0
+#define TASK_2_QUEUE_CAPACITY 4
+
+
+//////////////////////
+// Global Variables //
+//////////////////////
+
+
+// Task 2 active object, running the keypad & LCD logic as a protothread (see "pt.h")
+Active task2;
+static Active_Event task2Queue[TASK_2_QUEUE_CAPACITY];
+static PT task2Thread;
+static PT keypadThread;
+
 
 ////////////////////////
 // Lab Task functions //
@@ -101,12 +129,37 @@ void Run_Task_1(void) {
  *  - Column 4 pin: PC7
  */
 void Run_Task_2(void) {
-    unsigned char key;
-    int key_count = 0;
-
-    // Initialize keypad & LCD
-    Keypad_Init();
+    // Initialize LCD & wake-up on key press (keypad otherwise only needs its pins configured)
     LCD_4Bits_Init();
+    Keypad_Init_Wakeup();
+
+    // Run the task as an active object, resumed by key presses & its own delays
+    MemPool_Init();
+    Active_Init(SYS_CLOCK_HZ, ACTIVE_TICK_HZ);
+    Active_Start(&task2, TASK_2_PRIORITY, task2Queue, TASK_2_QUEUE_CAPACITY, Task_2_Handler);
+    Keypad_Set_Owner(&task2);
+
+    // Sleep whenever no interrupt or active object is running (never returns)
+    Active_Run();
+}
+
+
+// Handle 1 event of task 2 by resuming its protothread
+void Task_2_Handler(Active *self, const Active_Event *event) {
+    if (event->signal == ACTIVE_SIGNAL_START)
+        PT_INIT(&task2Thread, self);
+
+    PT_RUN(&task2Thread, Task_2_Thread, event);
+}
+
+
+// Same steps as the original polling loop, but every delay gives the CPU back instead of waiting it out
+// NOTE: Static variables, since local variables don't survive a wait
+int Task_2_Thread(PT *pt) {
+    static unsigned char key;
+    static int key_count = 0;
+
+    PT_BEGIN(pt);
 
     // Clear the LCD screen
     LCD_4Bits_Cmd(LCD_CLEAR_DISPLAY);
@@ -115,11 +168,11 @@ void Run_Task_2(void) {
     LCD_4Bits_Cmd(LCD_SET_DDRAM_ADDR + LCD_LINE1_START);
 
     // Allow some delay, so the slow LCD will catch up with the fast MCU.
-    Delay_Milli(500);
+    AWAIT_TICKS(pt, 500);
 
     for (;;) {
-        key = getKey();	// call the function to get a key input
-        Delay_Milli(800);	// give the mechanic key some time to debounce.
+        PT_SPAWN(pt, &keypadThread, Keypad_Read_Key_Thread(&keypadThread, &key));	// wait until a key is pressed & get its input
+        AWAIT_TICKS(pt, 800);	// give the mechanic key some time to debounce.
 
         if (key != 0) {
             key_count++;
@@ -136,9 +189,11 @@ void Run_Task_2(void) {
 
             // Display the key input on your LCD.
             LCD_4Bits_Data(key);
-            Delay_Milli(500);
+            AWAIT_TICKS(pt, 500);
         }
     }
+
+    PT_END(pt);
 }
 
 
@@ -148,6 +203,22 @@ void Run_Task_2(void) {
 
 
 int main() {
+    // Pin configuration tables of every driver in use
+    const GPIO_PinConfig *const pinTables[] = { LCD_PIN_CONFIG, KEYPAD_PIN_CONFIG };
+
+    // Only Port C keeps its clock while sleeping, to detect key presses on the keypad columns, and Timer 2 to
+    // keep ticking (task 2)
+    const Power_SleepClocks sleepClocks = { (1UL << GPIO_PORT_C), SYSCTL_SCGCTIMER_S2, 0, 0, 0, 0, 0 };
+
+    // Initialize SysTick for the millisecond delays (running at the default 16 MHz clock)
+    SysTick_Init();
+
+    // Configure the pins for the LCD (PB0 - PB2 & PB4 - PB7) and keypad (PE0 - PE3 & PC4 - PC7) in a single pass
+    GPIO_Init_Pins(pinTables, sizeof(pinTables) / sizeof(pinTables[0]));
+
+    // Gate the clocks of every other peripheral while sleeping
+    Power_Init(&sleepClocks);
+
     // Running task phase
     // NOTE: Change TASK_NUM above based on which lab task to run and recompile
 #if TASK_NUM == 1
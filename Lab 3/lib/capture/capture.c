@@ -0,0 +1,167 @@
+#include <stdint.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "nvic/Interrupt.h"
+#include "gpio/gpio.h"
+#include "ringbuf/ringbuf.h"
+#include "capture.h"
+
+#define CAPTURE_PORT GPIO_PORT_C
+#define CAPTURE_PIN  0x10u  // = 0x10 (PC4)
+
+// Capture input pin, routed to Wide Timer 0A (PCTL value 7 = WT0CCP0)
+const GPIO_PinConfig CAPTURE_PIN_CONFIG[] = {
+    {CAPTURE_PORT, CAPTURE_PIN, GPIO_INPUT | GPIO_ALT_FUNC, 7},
+    GPIO_PIN_CONFIG_END
+};
+
+// 1 captured edge, with 'gap' set if edges were dropped right before it (so it mustn't be paired with older ones)
+typedef struct {
+    uint32_t time;
+    uint8_t rising;
+    uint8_t gap;
+} Capture_Edge;
+
+// Single-producer / single-consumer ring buffer (see ringbuf/ringbuf.h)
+// - WTIMER0A_Handler produces, Capture_Update() consumes
+static Capture_Edge edgeStorage[CAPTURE_BUFFER_EDGES];
+static RingBuf edgeRing;
+
+// Only written by WTIMER0A_Handler
+static volatile int edgeGap = 0;
+static volatile unsigned long droppedEdges = 0;
+
+static int captureBothEdges;
+static uint32_t captureSysClockHz;
+static uint32_t timeoutCycles;
+
+// Only touched by Capture_Update() & Capture_Get()
+static Capture_Measurement measurement;
+static uint32_t lastRise, lastEdge;
+static int haveRise = 0, highOpen = 0, haveEdge = 0;
+
+
+// Start capturing 'edges' on Wide Timer 0A
+void Capture_Init(uint32_t sysClockHz, int edges) {
+    captureBothEdges = (edges == CAPTURE_EDGES_BOTH);
+    captureSysClockHz = sysClockHz;
+    timeoutCycles = sysClockHz / 1000 * CAPTURE_TIMEOUT_MS;
+
+    RingBuf_Init(&edgeRing, edgeStorage, sizeof(Capture_Edge), CAPTURE_BUFFER_EDGES);
+
+    // Enable clock for Wide Timer 0
+    SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R0;
+
+    // Wait until Wide Timer 0 clock is fully initialized
+    while ((SYSCTL_PRWTIMER_R & SYSCTL_PRWTIMER_R0) == 0);
+
+    // Disable Timer A during setup
+    WTIMER0_CTL_R = 0;
+
+    // 32-bit (split) edge-time capture, counting up through the full range so the count wraps at 2^32
+    WTIMER0_CFG_R = TIMER_CFG_16_BIT;
+    WTIMER0_TAMR_R = (TIMER_TAMR_TAMR_CAP | TIMER_TAMR_TACMR | TIMER_TAMR_TACDIR);
+    WTIMER0_TAILR_R = 0xFFFFFFFF;
+    WTIMER0_TAPR_R = 0;
+
+    // Interrupt on every captured edge
+    WTIMER0_ICR_R = TIMER_ICR_CAECINT;
+    WTIMER0_IMR_R = TIMER_IMR_CAEIM;
+
+    // Set interrupt priority for Wide Timer 0A to level 2 (the handler is short, and a capture not read
+    // before the next edge gets overwritten) & enable it
+    NVIC_SET_PRIORITY(WTIMER0A_IRQn, 2);
+    NVIC_ENABLE_IRQ(WTIMER0A_IRQn);
+
+    // Start Timer A on the selected edges
+    WTIMER0_CTL_R = (captureBothEdges ? TIMER_CTL_TAEVENT_BOTH : TIMER_CTL_TAEVENT_POS) |
+                    TIMER_CTL_TASTALL | TIMER_CTL_TAEN;
+}
+
+
+// Fold every queued edge into the measurement, returning how many were handled
+unsigned int Capture_Update(void) {
+    Capture_Edge edge;
+    uint64_t periodSum = 0, highSum = 0;
+    unsigned int periodCount = 0, highCount = 0, count = 0;
+
+    while (RingBuf_Pop(&edgeRing, &edge)) {
+        count++;
+
+        // Differences across dropped edges would span an unknown number of periods
+        if (edge.gap)
+            haveRise = highOpen = 0;
+
+        if (edge.rising) {
+            if (haveRise) {
+                periodSum += edge.time - lastRise;
+                periodCount++;
+            }
+
+            lastRise = edge.time;
+            haveRise = highOpen = 1;
+        } else if (highOpen) {
+            highSum += edge.time - lastRise;
+            highCount++;
+            highOpen = 0;
+        }
+
+        lastEdge = edge.time;
+        haveEdge = 1;
+    }
+
+    measurement.edges += count;
+    measurement.droppedEdges = droppedEdges;
+
+    if (periodCount != 0) {
+        measurement.periodCycles = (uint32_t) (periodSum / periodCount);
+        measurement.frequency_mHz = (uint32_t) ((uint64_t) captureSysClockHz * 1000 / measurement.periodCycles);
+    }
+
+    if (highCount != 0 && measurement.periodCycles != 0) {
+        measurement.highCycles = (uint32_t) (highSum / highCount);
+        measurement.dutyPermille = (unsigned int) ((uint64_t) measurement.highCycles * 1000 / measurement.periodCycles);
+
+        if (measurement.dutyPermille > 1000)
+            measurement.dutyPermille = 1000;
+    }
+
+    // No edge for too long: the signal stopped (stuck high or low), so start over once it comes back
+    if (count == 0 && haveEdge && (uint32_t) (WTIMER0_TAV_R - lastEdge) > timeoutCycles) {
+        measurement.periodCycles = 0;
+        measurement.frequency_mHz = 0;
+        measurement.highCycles = 0;
+        measurement.dutyPermille = (captureBothEdges && GPIO_READ_PINS(CAPTURE_PORT, CAPTURE_PIN)) ? 1000 : 0;
+
+        haveRise = highOpen = haveEdge = 0;
+    }
+
+    return count;
+}
+
+
+// Latest measurement (as of the last Capture_Update())
+void Capture_Get(Capture_Measurement *result) {
+    *result = measurement;
+}
+
+
+// NOTE: This is meant to be implicitly overriden
+void WTIMER0A_Handler(void) {
+    Capture_Edge edge;
+
+    // Clear the capture flag (ICR is write-1-to-clear, so a direct store is enough)
+    WTIMER0_ICR_R = TIMER_ICR_CAECINT;
+
+    // The count latched at the edge, and the pin level now to tell which edge it was (it has settled since)
+    edge.time = WTIMER0_TAR_R;
+    edge.rising = (uint8_t) (!captureBothEdges || GPIO_READ_PINS(CAPTURE_PORT, CAPTURE_PIN) != 0);
+    edge.gap = (uint8_t) edgeGap;
+
+    if (RingBuf_Push(&edgeRing, &edge)) {
+        edgeGap = 0;
+    } else {
+        edgeGap = 1;
+        droppedEdges++;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef MCU_CAPTURE
+#define MCU_CAPTURE
+
+#include <stdint.h>
+
+#include "gpio/gpio.h"
+
+// Edge-time capture on Wide Timer 0A (input WT0CCP0 = PC4), for measuring the frequency, period & duty cycle
+// of a tachometer or encoder signal without polling the pin
+// - The timer latches its free-running count on every edge in hardware, so timestamps are exact to 1 system
+//   clock cycle no matter how late the handler runs, and the handler (WTIMER0A_Handler) only queues them into
+//   a ring buffer (see "ringbuf.h")
+// - Capture_Update() turns the queued timestamps into averaged measurements incrementally from the main code
+// - The timer counts up through all 32 bits, so differences taken by unsigned subtraction stay right across
+//   its wrap-around (every 2^32 cycles, ~86 s at 50 MHz). Signals without an edge for CAPTURE_TIMEOUT_MS read
+//   as stopped, long before a whole wrap-around could alias.
+//
+// Number of edges queued between updates (a power of 2)
+// NOTE: Edges that don't fit are dropped & counted, with the measurement picking up again from the next one,
+// so a signal too fast for the update rate just gets measured in bursts
+#ifndef CAPTURE_BUFFER_EDGES
+#define CAPTURE_BUFFER_EDGES 64
+#endif
+
+// Time without any edge after which the signal reads as stopped (at most 20 s at 80 MHz)
+#ifndef CAPTURE_TIMEOUT_MS
+#define CAPTURE_TIMEOUT_MS 250
+#endif
+
+// Edges to capture
+#define CAPTURE_EDGES_RISING 0  // Period & frequency, with 1 interrupt per period (fastest)
+#define CAPTURE_EDGES_BOTH   1  // Also the high time & duty cycle, with the handler reading the pin to tell
+                                // the edges apart, so pulses must outlast its latency (~1 us)
+
+// Latest measurement, averaged over the edges handled by the last Capture_Update() that saw any
+typedef struct {
+    uint32_t periodCycles;      // In system clock cycles (0 = stopped or not measured yet)
+    uint32_t highCycles;        // In system clock cycles (CAPTURE_EDGES_BOTH only)
+    uint32_t frequency_mHz;     // In mHz (0 = stopped)
+    unsigned int dutyPermille;  // High time per period, 0 - 1000 (CAPTURE_EDGES_BOTH only)
+    unsigned long edges;        // Edges handled since Capture_Init()
+    unsigned long droppedEdges; // Edges dropped since Capture_Init(), because the buffer was full
+} Capture_Measurement;
+
+// Capture input pin (PC4 as WT0CCP0), to be passed to GPIO_Init_Pins()
+extern const GPIO_PinConfig CAPTURE_PIN_CONFIG[];
+
+
+// Start capturing 'edges' (CAPTURE_EDGES_RISING or CAPTURE_EDGES_BOTH) on Wide Timer 0A
+// NOTE: The capture pin (CAPTURE_PIN_CONFIG) must be configured via GPIO_Init_Pins() beforehand
+extern void Capture_Init(uint32_t sysClockHz, int edges);
+
+// Fold every queued edge into the measurement, returning how many were handled
+// NOTE: Consumer side of the ring buffer, so only call it from 1 place (i.e. the main loop)
+extern unsigned int Capture_Update(void);
+
+// Latest measurement (as of the last Capture_Update())
+extern void Capture_Get(Capture_Measurement *result);
+
+
+#endif /* MCU_CAPTURE */
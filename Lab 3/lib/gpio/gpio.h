@@ -0,0 +1,118 @@
+#ifndef MCU_GPIO
+#define MCU_GPIO
+
+#include <stdint.h>
+
+// GPIO port indices
+#define GPIO_PORT_A     0
+#define GPIO_PORT_B     1
+#define GPIO_PORT_C     2
+#define GPIO_PORT_D     3
+#define GPIO_PORT_E     4
+#define GPIO_PORT_F     5
+#define GPIO_PORT_COUNT 6
+
+// GPIO port base addresses on the APB bus (pg. 658 of datasheet)
+// NOTE: Ports A - D are contiguous starting at 0x40004000, while ports E & F start at 0x40024000
+#define GPIO_PORT_APB_BASE(port) \
+    ((port) < GPIO_PORT_E ? (0x40004000UL + ((unsigned long) (port) << 12)) \
+                          : (0x40024000UL + ((unsigned long) ((port) - GPIO_PORT_E) << 12)))
+
+// GPIO port base addresses on the AHB bus (pg. 658 of datasheet)
+// NOTE: The AHB aperture allows back-to-back single-cycle accesses, while every APB access takes
+// 2 or more cycles, so AHB roughly doubles the maximum pin toggle / DAC update rate
+#define GPIO_PORT_AHB_BASE(port) (0x40058000UL + ((unsigned long) (port) << 12))
+
+// Ports to access through the AHB aperture instead of APB (bit n = port index n, i.e. 0x22 = Ports F & B)
+// NOTE: Change and recompile as necessary (0x00 = legacy APB for all ports). The selection is applied
+// to SYSCTL_GPIOHBCTL_R by GPIO_Init_Pins(), and every GPIO_REG() / GPIO_*_PINS() access follows it.
+// The GPIO_PORTx_*_R macros from the device header always use APB and must not be used for these ports.
+#ifndef GPIO_AHB_PORTS
+#define GPIO_AHB_PORTS 0x3Fu
+#endif
+
+// Base address of a GPIO port on its selected bus
+// NOTE: When 'port' is a constant, the bus selection is resolved at compile-time
+#define GPIO_PORT_BASE(port) \
+    ((GPIO_AHB_PORTS & (1u << (port))) ? GPIO_PORT_AHB_BASE(port) : GPIO_PORT_APB_BASE(port))
+
+// GPIO register offsets relative to the port base address (pg. 660 - 661 of datasheet)
+#define GPIO_O_DATA     0x000
+#define GPIO_O_DIR      0x400
+#define GPIO_O_IS       0x404
+#define GPIO_O_IBE      0x408
+#define GPIO_O_IEV      0x40C
+#define GPIO_O_IM       0x410
+#define GPIO_O_RIS      0x414
+#define GPIO_O_MIS      0x418
+#define GPIO_O_ICR      0x41C
+#define GPIO_O_AFSEL    0x420
+#define GPIO_O_ODR      0x50C
+#define GPIO_O_PUR      0x510
+#define GPIO_O_PDR      0x514
+#define GPIO_O_DEN      0x51C
+#define GPIO_O_LOCK     0x520
+#define GPIO_O_CR       0x524
+#define GPIO_O_AMSEL    0x528
+#define GPIO_O_PCTL     0x52C
+
+// Access a register of a GPIO port by port index
+// NOTE: When 'port' is a constant, this resolves to the same fixed address as the GPIO_PORTx_*_R macros
+#define GPIO_REG(port, offset) (*((volatile unsigned long *) (GPIO_PORT_BASE(port) + (offset))))
+
+
+// Masked GPIODATA access (pg. 654 - 655 of datasheet)
+//   Address bits [9:2] of a GPIODATA access act as a pin mask, so a store to (base + (pins << 2))
+//   only changes the pins in 'pins' and a load only returns those pins (the rest read as 0).
+//   This makes every pin update a single store with no read-modify-write, which means it is
+//   safe to use from both main code and interrupt handlers on the same port.
+#define GPIO_DATA_MASKED(port, pins) \
+    (*((volatile unsigned long *) (GPIO_PORT_BASE(port) + GPIO_O_DATA + ((unsigned long) (pins) << 2))))
+
+// Write 'value' to only the given pins (i.e. GPIO_WRITE_PINS(GPIO_PORT_A, 0xC0, 0x80) sets PA7 & clears PA6)
+#define GPIO_WRITE_PINS(port, pins, value)  (GPIO_DATA_MASKED(port, pins) = (value))
+
+// Drive the given pins high
+#define GPIO_SET_PINS(port, pins)           (GPIO_DATA_MASKED(port, pins) = 0xFF)
+
+// Drive the given pins low
+#define GPIO_CLEAR_PINS(port, pins)         (GPIO_DATA_MASKED(port, pins) = 0x00)
+
+// Read only the given pins (all other bits read as 0)
+#define GPIO_READ_PINS(port, pins)          (GPIO_DATA_MASKED(port, pins))
+
+
+// Pin configuration flags
+#define GPIO_INPUT          0x00u // Digital input (default)
+#define GPIO_OUTPUT         0x01u // Digital output
+#define GPIO_PULL_UP        0x02u // Enable internal pull-up resistor
+#define GPIO_PULL_DOWN      0x04u // Enable internal pull-down resistor
+#define GPIO_OPEN_DRAIN     0x08u // Enable open-drain mode (outputs only)
+#define GPIO_ANALOG         0x10u // Analog input (disables digital functionality)
+#define GPIO_ALT_FUNC       0x20u // Alternate function selected by 'altFunc' (see GPIO_PCTL_* in datasheet)
+
+// Declarative description of a group of pins on the same port sharing the same configuration
+typedef struct {
+    // Port index (GPIO_PORT_A - GPIO_PORT_F)
+    uint8_t port;
+    // Pins being configured (i.e. 0x11 = Px4 | Px0)
+    uint8_t pins;
+    // Combination of GPIO_* configuration flags
+    uint8_t flags;
+    // Value for the 4-bit PCTL field of every pin, if GPIO_ALT_FUNC is set
+    uint8_t altFunc;
+} GPIO_PinConfig;
+
+// Marks the end of a pin configuration table
+#define GPIO_PIN_CONFIG_END {0, 0, 0, 0}
+
+
+// Configure the pins of every given pin configuration table at once
+//   All entries are merged per port first, then each port's clock is enabled with a single write
+//   and each configuration register is written only once per port. Pins not mentioned in any
+//   table are left untouched. This also selects the bus aperture of every port (GPIO_AHB_PORTS),
+//   so it must be called before any other GPIO access.
+extern void GPIO_Init_Pins(const GPIO_PinConfig *const tables[], unsigned int tableCount);
+
+
+#endif /* MCU_GPIO */
@@ -0,0 +1,150 @@
+#include <stdint.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "nvic/Interrupt.h"
+#include "gpio/gpio.h"
+#include "capture/capture.h"
+#include "pid/pid.h"
+#include "motor.h"
+
+// Motor PWM pin, routed to PWM module 1 (PCTL value 5 = M1PWM3)
+const GPIO_PinConfig MOTOR_PIN_CONFIG[] = {
+    {GPIO_PORT_A, 0x80u, GPIO_OUTPUT | GPIO_ALT_FUNC, 5},
+    GPIO_PIN_CONFIG_END
+};
+
+// Only touched by TIMER0A_Handler, or with interrupts disabled
+static PID speedPid;
+static Motor_Status status;
+static uint32_t pwmCounts;
+
+static volatile uint32_t setpoint_mHz = 0;
+
+
+// Output 'counts' out of 'pwmCounts' high per PWM period (0 = always low)
+// NOTE: The generator counts down from the load value, going high at the load & low at the compare value, and
+// takes a new compare value at its next zero count, so the duty cycle never changes mid-period
+static void Motor_Set_Duty(uint32_t counts) {
+    if (counts == 0) {
+        PWM1_ENABLE_R &= ~PWM_ENABLE_PWM3EN;
+    } else {
+        PWM1_1_CMPB_R = pwmCounts - counts;
+        PWM1_ENABLE_R |= PWM_ENABLE_PWM3EN;
+    }
+
+    status.dutyPermille = (unsigned int) ((uint64_t) counts * 1000 / pwmCounts);
+}
+
+
+// Setup the PWM output at 'pwmHz' (stopped), the tachometer capture & the control loop at 'loopHz'
+void Motor_Init(uint32_t sysClockHz, uint32_t pwmHz, uint32_t loopHz, int32_t kp, int32_t ki, int32_t kd) {
+    pwmCounts = sysClockHz / pwmHz;
+
+    // The duty cycle can range from 0 to every count of the period
+    PID_Init(&speedPid, kp, ki, kd, 0, (int32_t) pwmCounts);
+
+    // The loop owns the capture driver from now on
+    Capture_Init(sysClockHz, CAPTURE_EDGES_RISING);
+
+    // Enable clock for PWM module 1, clocked straight from the system clock (no PWM divider)
+    SYSCTL_RCGCPWM_R |= SYSCTL_RCGCPWM_R1;
+    SYSCTL_RCC_R &= ~SYSCTL_RCC_USEPWMDIV;
+
+    // Wait until PWM module 1 clock is fully initialized
+    while ((SYSCTL_PRPWM_R & SYSCTL_PRPWM_R1) == 0);
+
+    // Count-down mode, output B high at the load value & low at compare B (on the way down)
+    PWM1_1_CTL_R = 0;
+    PWM1_1_GENB_R = (PWM_1_GENB_ACTLOAD_ONE | PWM_1_GENB_ACTCMPBD_ZERO);
+    PWM1_1_LOAD_R = pwmCounts - 1;
+    PWM1_1_CMPB_R = pwmCounts - 1;
+    PWM1_1_CTL_R = PWM_1_CTL_ENABLE;
+    Motor_Set_Duty(0);
+
+    // Enable clock for Timer 0
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R0;
+
+    // Wait until Timer 0 clock is fully initialized
+    while ((SYSCTL_PRTIMER_R & SYSCTL_PRTIMER_R0) == 0);
+
+    // Disable Timer A during setup
+    TIMER0_CTL_R = 0;
+
+    // 32-bit periodic mode, interrupting once per loop iteration
+    TIMER0_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER0_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+    TIMER0_TAILR_R = sysClockHz / loopHz - 1;
+    TIMER0_ICR_R = TIMER_ICR_TATOCINT;
+    TIMER0_IMR_R = TIMER_IMR_TATOIM;
+
+    // Set interrupt priority for Timer 0A to level 3 (just below the capture, whose edges it consumes) & enable it
+    NVIC_SET_PRIORITY(TIMER0A_IRQn, 3);
+    NVIC_ENABLE_IRQ(TIMER0A_IRQn);
+
+    // Start Timer A
+    TIMER0_CTL_R = (TIMER_CTL_TASTALL | TIMER_CTL_TAEN);
+}
+
+
+// Hold the speed at 'speed_mHz' from the next loop iteration on
+void Motor_Set_Speed(uint32_t speed_mHz) {
+    setpoint_mHz = speed_mHz;
+}
+
+
+// Change the gains, keeping the integral
+void Motor_Set_Gains(int32_t kp, int32_t ki, int32_t kd) {
+    uint32_t primask = Interrupt_Disable_Save();
+
+    PID_Set_Gains(&speedPid, kp, ki, kd);
+
+    Interrupt_Restore(primask);
+}
+
+
+// Latest state of the loop
+void Motor_Get_Status(Motor_Status *result) {
+    uint32_t primask = Interrupt_Disable_Save();
+
+    *result = status;
+
+    Interrupt_Restore(primask);
+}
+
+
+// NOTE: This is meant to be implicitly overriden
+// Runs 1 iteration of the speed loop: measure, compute & apply the new duty cycle
+void TIMER0A_Handler(void) {
+    Capture_Measurement speed;
+    uint32_t setpoint = setpoint_mHz, elapsed;
+    int32_t duty;
+
+    // Clear the time-out flag (ICR is write-1-to-clear, so a direct store is enough)
+    TIMER0_ICR_R = TIMER_ICR_TATOCINT;
+
+    // Average tachometer frequency over the edges since the last iteration
+    Capture_Update();
+    Capture_Get(&speed);
+
+    if (setpoint == 0) {
+        // Stopped: start over from scratch once a new speed is set
+        PID_Reset(&speedPid);
+        duty = 0;
+    } else {
+        duty = PID_Update(&speedPid, (int32_t) setpoint, (int32_t) speed.frequency_mHz);
+    }
+
+    Motor_Set_Duty((uint32_t) duty);
+
+    status.setpoint_mHz = setpoint;
+    status.speed_mHz = speed.frequency_mHz;
+    status.saturations = speedPid.saturations;
+    status.loops++;
+
+    // The timer counts down from the load value since the time-out, so this includes the interrupt latency
+    elapsed = TIMER0_TAILR_R - TIMER0_TAV_R;
+    status.loopCycles = elapsed;
+
+    if (elapsed > status.maxLoopCycles)
+        status.maxLoopCycles = elapsed;
+}
@@ -0,0 +1,50 @@
+#ifndef MCU_MOTOR
+#define MCU_MOTOR
+
+#include <stdint.h>
+
+#include "gpio/gpio.h"
+#include "pid/pid.h"
+
+// Closed-loop DC motor speed control
+// - Drives the motor with hardware PWM on PA7 (M1PWM3, PWM module 1 generator 1), so the duty cycle holds
+//   without the core
+// - Measures the speed as the frequency of the tachometer signal on PC4 (see "capture.h")
+// - Runs a fixed-point PID loop (see "pid.h") at a fixed rate from TIMER0A_Handler, which also owns the
+//   capture driver (so Capture_Update() must not be called from anywhere else)
+// - Speeds are tachometer frequencies in mHz (i.e. 1 pulse per revolution -> 1000 mHz = 60 RPM)
+//
+// NOTE: Tune the gains with the plant model first (tools/motor_sim.c), since the loop drives the motor at full
+// power when no tachometer signal comes in
+
+// Latest state of the loop
+typedef struct {
+    uint32_t setpoint_mHz;
+    uint32_t speed_mHz;
+    unsigned int dutyPermille;  // PWM duty cycle, 0 - 1000
+    unsigned long loops;        // Loop iterations since Motor_Init()
+    unsigned long saturations;  // Iterations with the output clamped to 0 % or 100 %
+    uint32_t loopCycles;        // System clock cycles from the timer time-out to the new duty cycle, last &
+    uint32_t maxLoopCycles;     // worst case (interrupt latency included)
+} Motor_Status;
+
+// Motor PWM pin (PA7 as M1PWM3), to be passed to GPIO_Init_Pins() along with CAPTURE_PIN_CONFIG
+extern const GPIO_PinConfig MOTOR_PIN_CONFIG[];
+
+
+// Setup the PWM output at 'pwmHz' (stopped), the tachometer capture & the control loop at 'loopHz' with
+// gains 'kp', 'ki' & 'kd' (Q16.16 PWM duty counts per mHz, see PID_GAIN())
+// NOTE: The pins must be configured via GPIO_Init_Pins() beforehand
+extern void Motor_Init(uint32_t sysClockHz, uint32_t pwmHz, uint32_t loopHz, int32_t kp, int32_t ki, int32_t kd);
+
+// Hold the speed at 'speed_mHz' from the next loop iteration on (0 = stop, with the PWM output low)
+extern void Motor_Set_Speed(uint32_t speed_mHz);
+
+// Change the gains, keeping the integral (so the duty cycle doesn't jump)
+extern void Motor_Set_Gains(int32_t kp, int32_t ki, int32_t kd);
+
+// Latest state of the loop
+extern void Motor_Get_Status(Motor_Status *status);
+
+
+#endif /* MCU_MOTOR */
@@ -0,0 +1,71 @@
+#include <stdint.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "Interrupt.h"
+
+// Sources:
+// * Register mapping: pg. 134 - 137 of datasheet (https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf)
+// * Priority bit field locations: pg. 152 of datasheet (https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf)
+// * Formula calculations: https://www.airsupplylab.com/ti-tiva-series/tiva_lesson-14-interrupt.html
+//
+// NOTE: Prefer the NVIC_*_IRQ() macros in "Interrupt.h" whenever the interrupt number is a constant,
+// since these functions exist only for the case where it is computed at run-time.
+
+
+// Enable the specified interrupt (number)
+//   This works by writing the specific bit to the "interrupt enable register" holding it,
+//   with a interrupt number limit between 0 and 138. Enable register index: i = n >> 5 (same
+//   as i = n // 32), bit index: b = n & 0x1F (same as b = n % 32).
+void NVIC_EnableIRQn(int IRQn) {
+    NVIC_ENABLE_IRQ(IRQn);
+}
+
+
+// Disable the specified interrupt (number)
+//   Same indexing as above, but through the "interrupt clear enable registers".
+void NVIC_DisableIRQn(int IRQn) {
+    NVIC_DISABLE_IRQ(IRQn);
+}
+
+
+// Force the specified interrupt (number) into the pending state
+//   Same indexing as above, but through the "interrupt set pending registers".
+void NVIC_SetPendingIRQn(int IRQn) {
+    NVIC_SET_PENDING_IRQ(IRQn);
+}
+
+
+// Remove the pending state of the specified interrupt (number)
+//   Same indexing as above, but through the "interrupt clear pending registers".
+void NVIC_ClearPendingIRQn(int IRQn) {
+    NVIC_CLEAR_PENDING_IRQ(IRQn);
+}
+
+
+// Set the priority for the specified interrupt (number)
+//   This works by storing the priority into the interrupt's own byte of the "interrupt priority
+//   registers", with the highest priority being 0 and lowest being 7. Only bits[7:5] of the byte are
+//   implemented, so the byte store replaces the old priority without touching the 3 other
+//   interrupts sharing the same 32-bit register (byte address: 0xE000E400 + n).
+void NVIC_SetPriorityIRQn(int IRQn, int priority) {
+    NVIC_SET_PRIORITY(IRQn, priority);
+}
+
+
+// Split the 3 priority bits into 'preemptBits' upper bits of group priority & the rest as subpriority
+//   PRIGROUP (bits[10:8] of the "application interrupt & reset control register") is the bit position
+//   where the group priority ends: bits[7:PRIGROUP+1] are the group priority & the bits below it the
+//   subpriority. With only bits[7:5] implemented, PRIGROUP = 7 - preemptBits (4 and below all give 3
+//   group priority bits). The register ignores every write without the vector key in its upper half,
+//   & every other writable bit requests a reset, so a plain store of the key & the field is enough.
+void NVIC_SetPriorityGrouping(int preemptBits) {
+    uint32_t group;
+
+    if (preemptBits < 0)
+        preemptBits = 0;
+    else if (preemptBits > 3)
+        preemptBits = 3;
+
+    group = (uint32_t) (7 - preemptBits) << 8;
+    NVIC_APINT_R = NVIC_APINT_VECTKEY | group;
+}
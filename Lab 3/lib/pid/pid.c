@@ -0,0 +1,76 @@
+#include <stdint.h>
+
+#include "pid.h"
+
+
+// Setup 'pid' with gains 'kp', 'ki' & 'kd' and an output range of 'outMin' - 'outMax'
+void PID_Init(PID *pid, int32_t kp, int32_t ki, int32_t kd, int32_t outMin, int32_t outMax) {
+    PID_Set_Gains(pid, kp, ki, kd);
+    pid->outMin = outMin;
+    pid->outMax = outMax;
+    pid->saturations = 0;
+    PID_Reset(pid);
+}
+
+
+// Change the gains, keeping the integral
+void PID_Set_Gains(PID *pid, int32_t kp, int32_t ki, int32_t kd) {
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+}
+
+
+// Forget the integral & the last measurement
+void PID_Reset(PID *pid) {
+    pid->integral = 0;
+    pid->lastMeasurement = 0;
+    pid->started = 0;
+}
+
+
+// Compute the output for 1 period
+int32_t PID_Update(PID *pid, int32_t setpoint, int32_t measurement) {
+    int32_t error = setpoint - measurement;
+    int64_t integralMin = (int64_t) pid->outMin << PID_Q;
+    int64_t integralMax = (int64_t) pid->outMax << PID_Q;
+    int64_t proportional, derivative, integral, sum;
+    int32_t output;
+
+    proportional = (int64_t) pid->kp * error;
+
+    // No derivative on the first update, since there's no earlier measurement to compare with
+    derivative = pid->started ? -(int64_t) pid->kd * (measurement - pid->lastMeasurement) : 0;
+    pid->lastMeasurement = measurement;
+    pid->started = 1;
+
+    // Tentatively integrate, keeping the integral within the output range on its own
+    integral = pid->integral + (int64_t) pid->ki * error;
+
+    if (integral > integralMax)
+        integral = integralMax;
+    else if (integral < integralMin)
+        integral = integralMin;
+
+    sum = proportional + integral + derivative;
+
+    // Clamp the output, only keeping the new integral if it doesn't push further into the saturation
+    if (sum > integralMax) {
+        output = pid->outMax;
+        pid->saturations++;
+
+        if (integral < pid->integral)
+            pid->integral = integral;
+    } else if (sum < integralMin) {
+        output = pid->outMin;
+        pid->saturations++;
+
+        if (integral > pid->integral)
+            pid->integral = integral;
+    } else {
+        output = (int32_t) (sum >> PID_Q);
+        pid->integral = integral;
+    }
+
+    return output;
+}
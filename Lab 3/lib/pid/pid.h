@@ -0,0 +1,43 @@
+#ifndef MCU_PID
+#define MCU_PID
+
+#include <stdint.h>
+
+// Fixed-point PID controller, meant to run at a fixed rate (i.e. from a periodic timer interrupt)
+// - Gains are Q16.16 numbers (PID_GAIN(1.5) = 1.5) applied per update, so the integral & derivative gains
+//   already include the update period (ki = Ki * dt, kd = Kd / dt)
+// - Everything is integer math with 64-bit products (SMULL / SMLAL on the M4), so an update takes a few dozen
+//   cycles with no floating-point unit involved
+// - Anti-windup: the integral only grows while the output isn't saturated in the same direction, and is itself
+//   clamped to the output range, so the controller recovers right away once the error changes sign
+// - The derivative acts on the measurement rather than the error, so setpoint steps don't kick the output
+//
+// NOTE: The functions don't touch any hardware, so they can also be compiled on a host machine (i.e. for the
+// plant model, tools/motor_sim.c in Lab 3)
+#define PID_Q 16
+#define PID_GAIN(x) ((int32_t) ((x) * (1L << PID_Q)))
+
+typedef struct {
+    int32_t kp, ki, kd;         // Q16.16 gains
+    int32_t outMin, outMax;     // Output range
+    int64_t integral;           // Integral term (Q16.16, in output units)
+    int32_t lastMeasurement;
+    int started;                // Set once 'lastMeasurement' holds a real value
+    unsigned long saturations;  // Updates whose output got clamped
+} PID;
+
+
+// Setup 'pid' with gains 'kp', 'ki' & 'kd' (see PID_GAIN()) and an output range of 'outMin' - 'outMax'
+extern void PID_Init(PID *pid, int32_t kp, int32_t ki, int32_t kd, int32_t outMin, int32_t outMax);
+
+// Change the gains, keeping the integral (so the output doesn't jump)
+extern void PID_Set_Gains(PID *pid, int32_t kp, int32_t ki, int32_t kd);
+
+// Forget the integral & the last measurement (i.e. when the controlled system was off for a while)
+extern void PID_Reset(PID *pid);
+
+// Compute the output for 1 period, from the 'setpoint' & the 'measurement' (in the same units)
+extern int32_t PID_Update(PID *pid, int32_t setpoint, int32_t measurement);
+
+
+#endif /* MCU_PID */
@@ -0,0 +1,51 @@
+#ifndef MCU_RINGBUF
+#define MCU_RINGBUF
+
+#include <stdint.h>
+
+// Lock-free single-producer / single-consumer ring buffer of fixed-size elements
+// - The producer (i.e. an interrupt handler) only calls the Push functions & the consumer (i.e. the main
+//   code) only calls the Pop functions, so neither side ever has to disable interrupts
+// - The indices are free-running (only wrapped when indexing), so 'head - tail' is always the number of
+//   queued elements & all of the capacity can be used
+// - Each index is only ever written by one side (head by the producer, tail by the consumer), and a memory
+//   barrier makes sure the data is in place before the index that publishes it is updated
+//
+// NOTE: The functions don't touch any hardware, so they can also be compiled on a host machine (i.e. for
+// the host-side stress test, tools/ringbuf_stress.c in Lab 5)
+typedef struct {
+    uint8_t *storage;                // Capacity * element size bytes
+    unsigned int capacity;           // In elements, a power of 2
+    unsigned int elementSize;        // In bytes
+    volatile unsigned int head;      // Written by the producer only
+    volatile unsigned int tail;      // Written by the consumer only
+    volatile unsigned int highWater; // Most elements ever queued at once, written by the producer only
+} RingBuf;
+
+
+// Setup 'ring' on top of 'storage' (capacity * elementSize bytes), returning 0 if 'capacity' isn't a power of 2
+// NOTE: Must be done before either side starts using the ring
+extern int RingBuf_Init(RingBuf *ring, void *storage, unsigned int elementSize, unsigned int capacity);
+
+// Producer side: queue 1 element, returning 0 if the ring is full
+extern int RingBuf_Push(RingBuf *ring, const void *element);
+
+// Producer side: queue up to 'count' elements, returning how many were queued
+extern unsigned int RingBuf_Push_Many(RingBuf *ring, const void *elements, unsigned int count);
+
+// Consumer side: take the oldest element, returning 0 if the ring is empty
+extern int RingBuf_Pop(RingBuf *ring, void *element);
+
+// Consumer side: take up to 'maxCount' of the oldest elements, returning how many were taken
+extern unsigned int RingBuf_Pop_Many(RingBuf *ring, void *elements, unsigned int maxCount);
+
+// Number of queued elements & free slots
+// NOTE: Exact for the calling side; the other side can only make the ring emptier (producer) or fuller (consumer)
+extern unsigned int RingBuf_Count(const RingBuf *ring);
+extern unsigned int RingBuf_Free(const RingBuf *ring);
+
+// Most elements ever queued at once since RingBuf_Init(), to size the capacity with
+extern unsigned int RingBuf_High_Water(const RingBuf *ring);
+
+
+#endif /* MCU_RINGBUF */
@@ -18,13 +18,33 @@
 #include "lib/seg-7/seg-7.h"
 #include "lib/pll/PLL.h"
 #include "lib/systick/SysTick.h"
+#include "lib/power/power.h"
+#include "lib/gpio/gpio.h"
+#include "lib/capture/capture.h"
+#include "lib/pid/pid.h"
+#include "lib/motor/motor.h"
 
 // Task pin definitions
 #define OUTPUT_LED_SEG_PINS	0xFFu // = 0x80 (PB7) | 0x40 (PB6) | 0x20 (PB5) | 0x10 (PB4) | 0x08 (PB3) | 0x04 (PB2) | 0x02 (PB1) | 0x01 (PB0)
 #define OUTPUT_DC_PWM_PIN   0x80u // = 0x80 (PA7)
 
-void Setup_Port_A_Pins(void);
-void Setup_Port_B_Pins(void);
+// Debug flags
+#define MEASURE_MOTOR_SPEED 0  // Controls if the motor's tachometer signal (on PC4) is measured while it runs, with the results in 'motorSpeed' (see "capture.h")
+#define CLOSED_LOOP_MOTOR 0  // Controls if the motor is held at MOTOR_TARGET_SPEED_MHZ by a PID loop on hardware PWM instead of the fixed software PWM, with the results in 'motorStatus' (needs the tachometer signal, see "motor.h")
+
+// Constant definitions
+#define SYS_CLOCK_HZ 50000000UL
+
+// Closed-loop motor control: PWM frequency, loop rate, target tachometer frequency & PID gains
+// NOTE: The gains come from the plant model (tools/motor_sim.c), so re-tune them there for another motor
+#define MOTOR_PWM_HZ 20000UL
+#define MOTOR_LOOP_HZ 200UL
+#define MOTOR_TARGET_SPEED_MHZ 50000UL
+#define MOTOR_KP PID_GAIN(0.01)
+#define MOTOR_KI PID_GAIN(0.0005)
+#define MOTOR_KD PID_GAIN(0)
+
+void Setup_GPIO_Pins(void);
 
 void SysTick_Wait_200ms(uint32_t delay);
 void SysTick_Wait_200us(uint32_t delay);
@@ -33,77 +53,45 @@ void Run_Task_1(void);
 void Run_Task_2(void);
 
 
-//////////////////////////
-// GPIO Setup functions //
-//////////////////////////
-
-
-void Setup_Port_A_Pins(void) {
-    // Enable Port A clock
-	SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R0;
-
-	// Wait until Port A clock is fully initialized
-	while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R0) == 0);
-
-	// Unlock Port A configuration
-	GPIO_PORTA_LOCK_R = GPIO_LOCK_KEY;
-
-	// Set commit register to only work with pin PA7
-	GPIO_PORTA_CR_R = OUTPUT_DC_PWM_PIN;
-
-	// Set PA7 pin as output
-	GPIO_PORTA_DIR_R |= OUTPUT_DC_PWM_PIN;
-
-	// Disable all analog functionality for PA7
-	GPIO_PORTA_AMSEL_R &= ~OUTPUT_DC_PWM_PIN;
-
-	// Enable digital functionality for PA7
-	GPIO_PORTA_DEN_R |= OUTPUT_DC_PWM_PIN;
-
-	// Disable all alternate functionality for PA7
-	GPIO_PORTA_AFSEL_R &= ~OUTPUT_DC_PWM_PIN;
-
-	// Disable all special functionality for PA7
-	GPIO_PORTA_PCTL_R &= ~OUTPUT_DC_PWM_PIN;
-
-    // Lock Port A configuration
-    GPIO_PORTA_LOCK_R = 0;
-}
-
-
-void Setup_Port_B_Pins(void) {
-    // Enable Port B clock
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R1;
-
-    // Wait until Port B clock is fully initialized
-    while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R1) == 0);
-
-    // Unlock Port B configuration
-    GPIO_PORTB_LOCK_R = GPIO_LOCK_KEY;
-
-    // Set commit register to only work with pins PB0 - PB7
-    GPIO_PORTB_CR_R = OUTPUT_LED_SEG_PINS;
+//////////////////////
+// Global Variables //
+//////////////////////
 
-    // Set all LED pins (PB0 - PB7) as outputs
-    GPIO_PORTB_DIR_R |= OUTPUT_LED_SEG_PINS;
 
-    // Disable all analog functionality for PB0 - PB7
-    GPIO_PORTB_AMSEL_R &= ~OUTPUT_LED_SEG_PINS;
+// Speed of the motor, from its tachometer signal (inspect via debugger)
+Capture_Measurement motorSpeed;
 
-    // Enable digital functionality for PB0 - PB7
-    GPIO_PORTB_DEN_R |= OUTPUT_LED_SEG_PINS;
+// State of the closed-loop speed control, including the loop's execution time (inspect via debugger)
+Motor_Status motorStatus;
 
-    // Disable all alternate functionality for PB0 - PB7
-    GPIO_PORTB_AFSEL_R &= ~OUTPUT_LED_SEG_PINS;
 
-    // Disable all special functionality for PB0 - PB7
-    GPIO_PORTB_PCTL_R &= ~OUTPUT_LED_SEG_PINS;
+//////////////////////////
+// GPIO Setup functions //
+//////////////////////////
 
-    // Enable pull-up resistors for PB0 - PB7
-    GPIO_PORTB_PUR_R |= OUTPUT_LED_SEG_PINS;
 
-    // Lock Port B configuration
-    GPIO_PORTB_LOCK_R = 0;
+// Pin configuration for the DC motor PWM pin (PA7) and 7-segment LEDs (PB0 - PB7)
+// NOTE: With CLOSED_LOOP_MOTOR, PA7 gets routed to the PWM module instead (MOTOR_PIN_CONFIG)
+const GPIO_PinConfig TASK_PIN_CONFIG[] = {
+#if !CLOSED_LOOP_MOTOR
+    {GPIO_PORT_A, OUTPUT_DC_PWM_PIN,   GPIO_OUTPUT, 0},
+#endif
+    {GPIO_PORT_B, OUTPUT_LED_SEG_PINS, GPIO_OUTPUT | GPIO_PULL_UP, 0},
+    GPIO_PIN_CONFIG_END
+};
+
+
+void Setup_GPIO_Pins(void) {
+#if CLOSED_LOOP_MOTOR
+    const GPIO_PinConfig *const pinTables[] = { TASK_PIN_CONFIG, CAPTURE_PIN_CONFIG, MOTOR_PIN_CONFIG };
+#elif MEASURE_MOTOR_SPEED
+    const GPIO_PinConfig *const pinTables[] = { TASK_PIN_CONFIG, CAPTURE_PIN_CONFIG };
+#else
+    const GPIO_PinConfig *const pinTables[] = { TASK_PIN_CONFIG };
+#endif
+
+    // Configure Ports A, B & C (tachometer input, only when it's measured) in a single pass
+    GPIO_Init_Pins(pinTables, sizeof(pinTables) / sizeof(pinTables[0]));
 }
 
 
@@ -139,7 +127,7 @@ void SysTick_Wait_200us(uint32_t delay) {
 void display_seg_7_countdown(void) {
     int32_t i;
     for (i = 9; i >= 0; i--) {
-        GPIO_PORTB_DATA_R = SEG_7_PATTERNS[i];
+        GPIO_WRITE_PINS(GPIO_PORT_B, OUTPUT_LED_SEG_PINS, SEG_7_PATTERNS[i]);
         SysTick_Wait_200ms(5);
     }
 }
@@ -150,12 +138,30 @@ void run_dc_motor_pwm(void) {
     // PWM Duty cycle = 80% over 1 ms period
     while (1) {
         // Turn on PA7 for 0.8 ms
-        GPIO_PORTA_DATA_R =	0x80;
+        GPIO_SET_PINS(GPIO_PORT_A, OUTPUT_DC_PWM_PIN);
         SysTick_Wait_200us(1);
 
-        // Turn on PA6 for 0.2 ms
-        GPIO_PORTA_DATA_R =	0x00;
+        // Turn off PA7 for 0.2 ms
+        GPIO_CLEAR_PINS(GPIO_PORT_A, OUTPUT_DC_PWM_PIN);
         SysTick_Wait_200us(4);
+
+        #if MEASURE_MOTOR_SPEED
+            // Fold the tachometer edges captured during this period into the speed measurement
+            Capture_Update();
+            Capture_Get(&motorSpeed);
+        #endif
+    }
+}
+
+// Hold the DC motor at a set speed, with a PID loop adjusting the hardware PWM duty cycle (infinite loop)
+void run_dc_motor_closed_loop(void) {
+    Motor_Init(SYS_CLOCK_HZ, MOTOR_PWM_HZ, MOTOR_LOOP_HZ, MOTOR_KP, MOTOR_KI, MOTOR_KD);
+    Motor_Set_Speed(MOTOR_TARGET_SPEED_MHZ);
+
+    // The loop runs in TIMER0A_Handler, so only refresh the status now & then
+    while (1) {
+        SysTick_Wait_200ms(1);
+        Motor_Get_Status(&motorStatus);
     }
 }
 
@@ -170,17 +176,44 @@ void run_dc_motor_pwm(void) {
  * I/O Setup
  * - 7-segment LEDs: PB0 - PB7
  * - DC Motor PWM Pin: PA7
+ * - DC Motor Tachometer Pin: PC4
  */
 int main() {
+    #if CLOSED_LOOP_MOTOR
+        // Wide Timer 0 & Port C keep their clocks while sleeping to capture the tachometer edges, Timer 0 to run
+        // the loop, and PWM module 1 & Port A to keep driving the motor
+        const Power_SleepClocks sleepClocks = { (1UL << GPIO_PORT_A) | (1UL << GPIO_PORT_C), SYSCTL_SCGCTIMER_S0,
+                                                SYSCTL_SCGCWTIMER_S0, 0, 0, 0, SYSCTL_SCGCPWM_S1 };
+    #elif MEASURE_MOTOR_SPEED
+        // Wide Timer 0 & Port C keep their clocks while sleeping to capture the tachometer edges
+        const Power_SleepClocks sleepClocks = { (1UL << GPIO_PORT_C), 0, SYSCTL_SCGCWTIMER_S0, 0, 0, 0, 0 };
+    #else
+        // No peripheral has to wake up the core (only SysTick, which is part of the core), and the output pins
+        // keep their levels without a clock, so every peripheral clock can be gated while sleeping
+        const Power_SleepClocks sleepClocks = { 0, 0, 0, 0, 0, 0, 0 };
+    #endif
+
     // Initialize PLL & SysTick
     PLL_Init(SYSDIV2_50_00_Mhz);
     SysTick_Init();
 
     // Initialize GPIO pins
-    Setup_Port_A_Pins();
-    Setup_Port_B_Pins();
+    Setup_GPIO_Pins();
+
+    #if MEASURE_MOTOR_SPEED && !CLOSED_LOOP_MOTOR
+        // Timestamp both edges of the tachometer signal, for its frequency & duty cycle
+        Capture_Init(SYS_CLOCK_HZ, CAPTURE_EDGES_BOTH);
+    #endif
+
+    // Sleep in between the countdown steps & PWM edges, with the peripheral clocks gated
+    Power_Init(&sleepClocks);
 
     // Run all sub-tasks
     display_seg_7_countdown();
-    run_dc_motor_pwm();
+
+    #if CLOSED_LOOP_MOTOR
+        run_dc_motor_closed_loop();
+    #else
+        run_dc_motor_pwm();
+    #endif
 }
@@ -0,0 +1,173 @@
+/*
+ * Host-side plant model & benchmark for the DC motor speed loop (lib/pid/pid.c, as run by lib/motor/motor.c)
+ *
+ * Simulates the motor as a first-order system (speed approaching a level set by the duty cycle, with a time
+ * constant & a dead band from static friction), its tachometer edges & the averaged frequency the capture
+ * driver would measure, and runs the real PID code against it at the loop rate of the board:
+ * - Step response: the speed is set at t = 0, a load disturbance slows the motor half way through, and every
+ *   loop iteration gets printed as CSV (time_ms,setpoint_mHz,speed_mHz,measured_mHz,duty_permille)
+ * - Summary (on stderr): rise time, overshoot, steady-state error & the saturated iterations, to tune with
+ * - Benchmark (on stderr): nanoseconds per PID_Update() on the host, as a sanity check of the integer math
+ *   (the cycles taken on the board, interrupt latency included, are in Motor_Status.loopCycles)
+ *
+ * Build (from the "Lab 3" folder):
+ *   gcc -std=gnu89 -Wall -O2 -I. -Ilib -o motor_sim tools/motor_sim.c lib/pid/pid.c
+ *
+ * Usage:
+ *   ./motor_sim [kp ki kd [setpoint in Hz]] > step.csv
+ *
+ * The gains are the Q16.16 values of PID_GAIN() as decimals (PWM counts per mHz, per loop iteration), and
+ * default to the ones in main.c.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pid/pid.h"
+
+// Board settings (see main.c)
+#define SYS_CLOCK_HZ 50000000.0
+#define PWM_HZ 20000.0
+#define LOOP_HZ 200.0
+#define DEFAULT_KP 0.01
+#define DEFAULT_KI 0.0005
+#define DEFAULT_KD 0.0
+#define DEFAULT_SETPOINT_HZ 50.0
+
+// Motor model: tachometer frequency at 100 % duty, time constant, dead band & the load disturbance
+#define MOTOR_MAX_HZ 120.0
+#define MOTOR_TAU_S 0.15
+#define MOTOR_DEAD_BAND 0.08
+#define LOAD_DROP_HZ 25.0
+
+// Capture driver model (see capture.h)
+#define CAPTURE_TIMEOUT_S 0.25
+
+#define SIM_STEP_S 0.00001
+#define SIM_TIME_S 3.0
+#define BENCHMARK_UPDATES 10000000L
+
+
+static double Now_Seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+// Steady-state tachometer frequency for 'duty' (0 - 1), with a load that takes 'load' Hz off
+static double Motor_Target_Hz(double duty, double load) {
+    double hz;
+
+    if (duty <= MOTOR_DEAD_BAND)
+        return 0;
+
+    hz = MOTOR_MAX_HZ * (duty - MOTOR_DEAD_BAND) / (1 - MOTOR_DEAD_BAND) - load;
+    return (hz > 0) ? hz : 0;
+}
+
+
+int main(int argc, char *argv[]) {
+    double kp = DEFAULT_KP, ki = DEFAULT_KI, kd = DEFAULT_KD, setpointHz = DEFAULT_SETPOINT_HZ;
+    double pwmCounts = SYS_CLOCK_HZ / PWM_HZ, loopPeriod = 1 / LOOP_HZ;
+    double t = 0, nextLoop = 0, speedHz = 0, phase = 0, duty = 0, load = 0;
+    double firstEdge = -1, lastEdge = -1, lastAnyEdge = -1, measuredHz = 0;
+    double riseTime = -1, peakHz = 0, errorSum = 0;
+    unsigned long edgesInWindow = 0, errorCount = 0;
+    int32_t setpoint, output = 0;
+    double start, elapsed;
+    volatile int32_t sink = 0;
+    PID pid;
+    long i;
+
+    if (argc >= 4) {
+        kp = atof(argv[1]);
+        ki = atof(argv[2]);
+        kd = atof(argv[3]);
+    }
+
+    if (argc >= 5)
+        setpointHz = atof(argv[4]);
+
+    setpoint = (int32_t) (setpointHz * 1000);
+    PID_Init(&pid, PID_GAIN(kp), PID_GAIN(ki), PID_GAIN(kd), 0, (int32_t) pwmCounts);
+
+    printf("time_ms,setpoint_mHz,speed_mHz,measured_mHz,duty_permille\n");
+
+    while (t < SIM_TIME_S) {
+        if (t >= nextLoop) {
+            // Capture driver: average frequency over the rising edges since the last iteration, holding the last
+            // value without a full period in between & dropping to 0 after the time-out
+            if (edgesInWindow >= 2)
+                measuredHz = (edgesInWindow - 1) / (lastEdge - firstEdge);
+            else if (lastAnyEdge < 0 || t - lastAnyEdge > CAPTURE_TIMEOUT_S)
+                measuredHz = 0;
+
+            // Keep pairing with the last edge of this window, like the driver does across updates
+            firstEdge = lastEdge;
+            edgesInWindow = (lastEdge >= 0) ? 1 : 0;
+
+            output = PID_Update(&pid, setpoint, (int32_t) (measuredHz * 1000));
+            duty = output / pwmCounts;
+
+            printf("%.0f,%ld,%.0f,%.0f,%.0f\n", t * 1000, (long) setpoint, speedHz * 1000, measuredHz * 1000,
+                   duty * 1000);
+
+            // Track the step response (before the load disturbance kicks in)
+            if (t < SIM_TIME_S / 2) {
+                if (riseTime < 0 && speedHz >= 0.9 * setpointHz)
+                    riseTime = t;
+
+                if (speedHz > peakHz)
+                    peakHz = speedHz;
+            }
+
+            if ((t > SIM_TIME_S / 2 - 0.5 && t < SIM_TIME_S / 2) || t > SIM_TIME_S - 0.5) {
+                errorSum += setpointHz - measuredHz;
+                errorCount++;
+            }
+
+            nextLoop += loopPeriod;
+        }
+
+        load = (t >= SIM_TIME_S / 2) ? LOAD_DROP_HZ : 0;
+
+        // First-order speed response, with 1 tachometer pulse per cycle of 'phase'
+        speedHz += (Motor_Target_Hz(duty, load) - speedHz) * SIM_STEP_S / MOTOR_TAU_S;
+        phase += speedHz * SIM_STEP_S;
+
+        if (phase >= 1) {
+            phase -= 1;
+            lastEdge = lastAnyEdge = t;
+
+            if (edgesInWindow++ == 0)
+                firstEdge = t;
+        }
+
+        t += SIM_STEP_S;
+    }
+
+    fprintf(stderr, "gains: kp %g, ki %g, kd %g (Q16.16: %ld, %ld, %ld)\n", kp, ki, kd,
+            (long) PID_GAIN(kp), (long) PID_GAIN(ki), (long) PID_GAIN(kd));
+    fprintf(stderr, "rise time (90%%): %.0f ms\n", riseTime * 1000);
+    fprintf(stderr, "overshoot: %.1f %%\n", (peakHz - setpointHz) * 100 / setpointHz);
+    fprintf(stderr, "steady-state error: %.3f Hz (mean over the last 0.5 s before & after the load step)\n",
+            errorCount ? errorSum / errorCount : 0);
+    fprintf(stderr, "saturated iterations: %lu\n", pid.saturations);
+
+    // Benchmark the update on its own, with the measurement varying so nothing gets optimized out
+    PID_Init(&pid, PID_GAIN(kp), PID_GAIN(ki), PID_GAIN(kd), 0, (int32_t) pwmCounts);
+    start = Now_Seconds();
+
+    for (i = 0; i < BENCHMARK_UPDATES; i++)
+        sink += PID_Update(&pid, setpoint, setpoint + (int32_t) (i & 0xFFF) - 0x800);
+
+    elapsed = Now_Seconds() - start;
+    fprintf(stderr, "PID_Update: %.1f ns per update on the host\n", elapsed * 1e9 / BENCHMARK_UPDATES);
+
+    return 0;
+}
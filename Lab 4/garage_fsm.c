@@ -0,0 +1,23 @@
+#include "garage_fsm.h"
+
+/////////////////////
+// State definiton //
+/////////////////////
+
+// Output: LED indicator pins (PA3 - PA5)
+// Time: Amount of time x 1 second (1 tick = 1 ms) to stay in the state before the door inputs are evaluated
+// Guard: Not used (always allowed to leave a state)
+// Next: Next state transition as specified by input from (PA7 | PA6)
+const SType FSM[GARAGE_NUM_STATES] = {
+    {0x00, SECONDS(1), 0, {empty, empty, enter, empty}},
+    {0x20, SECONDS(2), 0, {empty, hold , enter, hold }},
+    {0x10, SECONDS(4), 0, {leave, leave, leave, leave}},
+    {0x08, SECONDS(3), 0, {empty, leave, empty, leave}},
+};
+
+const char *const FSM_STATE_NAMES[GARAGE_NUM_STATES] = {
+    "empty",
+    "enter",
+    "hold",
+    "leave",
+};
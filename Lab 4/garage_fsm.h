@@ -0,0 +1,28 @@
+#ifndef GARAGE_FSM
+#define GARAGE_FSM
+
+#include "lib/fsm/fsm.h"
+
+// NOTE: The state table lives in its own file so that the host-side simulator (tools/fsm_sim)
+// can load the exact same table that runs on the board.
+
+// Number of states in the parking garage state machine
+#define GARAGE_NUM_STATES 4
+
+// Dwell time conversion (1 tick = 1 ms)
+#define SECONDS(n) ((n) * 1000)
+
+typedef FSM_State SType;
+
+// Parking garage state table (see state transition document for more information)
+extern const SType FSM[GARAGE_NUM_STATES];
+#define empty &FSM[0]
+#define enter &FSM[1]
+#define hold  &FSM[2]
+#define leave &FSM[3]
+
+// Display names of each state (same order as the table)
+extern const char *const FSM_STATE_NAMES[GARAGE_NUM_STATES];
+
+
+#endif /* GARAGE_FSM */
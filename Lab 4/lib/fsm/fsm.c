@@ -0,0 +1,71 @@
+#include <stdint.h>
+
+#include "fsm.h"
+
+// NOTE: This file holds the hardware-independent part of the engine (see "fsm_run.c" for the run loop),
+// so it can also be compiled on a host machine to simulate state tables.
+
+
+// Enter a state at tick 'now', applying its output
+static void FSM_Enter_State(FSM_Machine *fsm, const FSM_State *state, uint32_t now) {
+    fsm->Current = state;
+    fsm->EnteredAt = now;
+
+    if (fsm->WriteOutput != 0)
+        fsm->WriteOutput(state->Output);
+}
+
+
+// Set up a state machine and enter its initial state at tick 'now'
+void FSM_Init(FSM_Machine *fsm, const FSM_State *initial,
+              void (*writeOutput)(unsigned long output), unsigned long (*readInput)(void),
+              uint32_t now) {
+    fsm->WriteOutput = writeOutput;
+    fsm->ReadInput = readInput;
+
+    FSM_Enter_State(fsm, initial, now);
+}
+
+
+// Number of ticks left until the dwell time of the current state elapses at tick 'now' (0 = elapsed)
+// NOTE: Using the difference of ticks handles the tick counter wrapping around
+uint32_t FSM_Ticks_Until_Dwell_End(const FSM_Machine *fsm, uint32_t now) {
+    uint32_t elapsed = now - fsm->EnteredAt;
+
+    if (elapsed >= fsm->Current->Time)
+        return 0;
+
+    return fsm->Current->Time - elapsed;
+}
+
+
+// Evaluate the state machine at tick 'now'
+//   Unlike a blocking loop, the input is not sampled once per dwell time: after the dwell time has elapsed,
+//   every call re-reads the input, so a change is acted upon as soon as the next event arrives.
+int FSM_Step(FSM_Machine *fsm, uint32_t now) {
+    const FSM_State *current = fsm->Current;
+    const FSM_State *next;
+    unsigned long input;
+
+    // Stay in the state until its dwell time has elapsed
+    if (FSM_Ticks_Until_Dwell_End(fsm, now) != 0)
+        return 0;
+
+    // Find the next state based on input
+    input = fsm->ReadInput();
+    if (input >= FSM_NUM_INPUTS)
+        return 0;
+
+    next = current->Next[input];
+
+    // Self-loops keep the current state (and its output) without restarting the dwell time
+    if (next == 0 || next == current)
+        return 0;
+
+    // Only leave the state if the guard condition allows it
+    if (current->Guard != 0 && !current->Guard(current, input))
+        return 0;
+
+    FSM_Enter_State(fsm, next, now);
+    return 1;
+}
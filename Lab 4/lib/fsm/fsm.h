@@ -0,0 +1,64 @@
+#ifndef FSM_ENGINE
+#define FSM_ENGINE
+
+#include <stdint.h>
+
+// Maximum number of input combinations per state (i.e. 2 input pins -> 4 combinations)
+// NOTE: Change and recompile as necessary
+#ifndef FSM_NUM_INPUTS
+#define FSM_NUM_INPUTS 4
+#endif
+
+
+typedef struct FSM_State FSM_State;
+
+// Optional guard condition, checked before leaving 'from' on 'input' (return 0 to stay in 'from')
+typedef int (*FSM_Guard)(const FSM_State *from, unsigned long input);
+
+// Moore state definition
+struct FSM_State {
+    // Output applied once when the state is entered
+    unsigned long Output;
+    // Dwell time (in ticks) to stay in the state before its inputs are evaluated
+    unsigned long Time;
+    // Guard condition for leaving the state (NULL = always allowed)
+    FSM_Guard Guard;
+    // Next state transition as specified by the input
+    const FSM_State *Next[FSM_NUM_INPUTS];
+};
+
+// Running state machine instance
+typedef struct {
+    // Current state
+    const FSM_State *Current;
+    // Tick at which the current state was entered
+    uint32_t EnteredAt;
+    // Applies the output of a state (i.e. writes it to the output pins)
+    void (*WriteOutput)(unsigned long output);
+    // Reads the current input combination (index into 'Next')
+    unsigned long (*ReadInput)(void);
+} FSM_Machine;
+
+
+// Set up a state machine and enter its initial state at tick 'now'
+extern void FSM_Init(FSM_Machine *fsm, const FSM_State *initial,
+                     void (*writeOutput)(unsigned long output), unsigned long (*readInput)(void),
+                     uint32_t now);
+
+// Evaluate the state machine at tick 'now'
+//   Once the dwell time of the current state has elapsed, the input is read and the machine moves to
+//   the next state (if different and allowed by the guard). Returns 1 if a transition happened, else 0.
+extern int FSM_Step(FSM_Machine *fsm, uint32_t now);
+
+// Number of ticks left until the dwell time of the current state elapses at tick 'now' (0 = elapsed)
+extern uint32_t FSM_Ticks_Until_Dwell_End(const FSM_Machine *fsm, uint32_t now);
+
+// Signal that an input may have changed (meant to be called from the input interrupt handlers)
+extern void FSM_Post_Event(void);
+
+// Run the state machine forever, sleeping until either a tick or an input event arrives
+// NOTE: Requires SysTick in periodic mode (SysTick_Init_Periodic) as the tick source
+extern void FSM_Run(FSM_Machine *fsm);
+
+
+#endif /* FSM_ENGINE */
@@ -0,0 +1,34 @@
+#include <stdint.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "systick/SysTick.h"
+#include "power/power.h"
+#include "fsm.h"
+
+// Set by input interrupt handlers, cleared by the run loop once the event has been handled
+static volatile int fsmEventPending = 0;
+
+
+// Signal that an input may have changed (meant to be called from the input interrupt handlers)
+void FSM_Post_Event(void) {
+    fsmEventPending = 1;
+}
+
+
+// Run the state machine forever, sleeping until either a tick or an input event arrives
+void FSM_Run(FSM_Machine *fsm) {
+    while (1) {
+        // Evaluate the state machine with the latest tick & input
+        FSM_Step(fsm, SysTick_Get_Ticks());
+
+        // Sleep until the next interrupt (SysTick tick or input edge)
+        // NOTE: Interrupts are masked while checking for a pending event, so an event posted right after
+        // the check still wakes up WFI (a pending interrupt always ends WFI, even when masked by PRIMASK),
+        // and the handler runs inside Power_Sleep() before it returns.
+        __disable_irq();
+        if (!fsmEventPending)
+            Power_Sleep();
+        fsmEventPending = 0;
+        __enable_irq();
+    }
+}
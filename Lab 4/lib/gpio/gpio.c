@@ -0,0 +1,137 @@
+#include <stdint.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "gpio.h"
+
+// Merged register values for a single port
+typedef struct {
+    unsigned long used;
+    unsigned long dir;
+    unsigned long afsel;
+    unsigned long odr;
+    unsigned long pur;
+    unsigned long pdr;
+    unsigned long den;
+    unsigned long amsel;
+    unsigned long pctl;
+} GPIO_PortConfig;
+
+
+// Expand an 8-bit pin mask into the matching 4-bit-per-pin PCTL mask (i.e. 0x05 -> 0x00000F0F)
+static unsigned long GPIO_Pins_To_PCTL_Mask(unsigned long pins) {
+    unsigned long pctlMask = 0;
+    int pin;
+
+    for (pin = 0; pin < 8; pin++) {
+        if (pins & (1UL << pin))
+            pctlMask |= (0xFUL << (4 * pin));
+    }
+
+    return pctlMask;
+}
+
+
+// Merge a pin configuration entry into the configuration of its port
+static void GPIO_Merge_Pin_Config(GPIO_PortConfig *portConfig, const GPIO_PinConfig *entry) {
+    unsigned long pins = entry->pins;
+
+    portConfig->used |= pins;
+
+    if (entry->flags & GPIO_OUTPUT)
+        portConfig->dir |= pins;
+
+    if (entry->flags & GPIO_OPEN_DRAIN)
+        portConfig->odr |= pins;
+
+    if (entry->flags & GPIO_PULL_UP)
+        portConfig->pur |= pins;
+
+    if (entry->flags & GPIO_PULL_DOWN)
+        portConfig->pdr |= pins;
+
+    if (entry->flags & GPIO_ANALOG) {
+        // Analog pins are routed through the alternate function path with digital functionality disabled
+        portConfig->amsel |= pins;
+        portConfig->afsel |= pins;
+    } else {
+        portConfig->den |= pins;
+    }
+
+    if (entry->flags & GPIO_ALT_FUNC) {
+        portConfig->afsel |= pins;
+        portConfig->pctl |= GPIO_Pins_To_PCTL_Mask(pins) & (0x11111111UL * (entry->altFunc & 0xF));
+    }
+}
+
+
+// Apply the merged configuration of a port, writing each register only once
+static void GPIO_Apply_Port_Config(int port, const GPIO_PortConfig *portConfig) {
+    unsigned long used = portConfig->used;
+    unsigned long pctlMask = GPIO_Pins_To_PCTL_Mask(used);
+
+    // Unlock the port configuration
+    GPIO_REG(port, GPIO_O_LOCK) = GPIO_LOCK_KEY;
+
+    // Set commit register to only work with the used pins
+    GPIO_REG(port, GPIO_O_CR) = used;
+
+    // Update only the used pins of every configuration register (1 read + 1 write each)
+    GPIO_REG(port, GPIO_O_DIR)   = (GPIO_REG(port, GPIO_O_DIR)   & ~used) | portConfig->dir;
+    GPIO_REG(port, GPIO_O_AFSEL) = (GPIO_REG(port, GPIO_O_AFSEL) & ~used) | portConfig->afsel;
+    GPIO_REG(port, GPIO_O_PCTL)  = (GPIO_REG(port, GPIO_O_PCTL)  & ~pctlMask) | portConfig->pctl;
+    GPIO_REG(port, GPIO_O_ODR)   = (GPIO_REG(port, GPIO_O_ODR)   & ~used) | portConfig->odr;
+    GPIO_REG(port, GPIO_O_PUR)   = (GPIO_REG(port, GPIO_O_PUR)   & ~used) | portConfig->pur;
+    GPIO_REG(port, GPIO_O_PDR)   = (GPIO_REG(port, GPIO_O_PDR)   & ~used) | portConfig->pdr;
+    GPIO_REG(port, GPIO_O_AMSEL) = (GPIO_REG(port, GPIO_O_AMSEL) & ~used) | portConfig->amsel;
+    GPIO_REG(port, GPIO_O_DEN)   = (GPIO_REG(port, GPIO_O_DEN)   & ~used) | portConfig->den;
+
+    // Lock the port configuration
+    GPIO_REG(port, GPIO_O_LOCK) = 0;
+}
+
+
+// Configure the pins of every given pin configuration table at once
+void GPIO_Init_Pins(const GPIO_PinConfig *const tables[], unsigned int tableCount) {
+    GPIO_PortConfig portConfigs[GPIO_PORT_COUNT];
+    const GPIO_PinConfig *entry;
+    unsigned long portClocks = 0;
+    unsigned int i;
+    int port;
+
+    // Start from an empty configuration for every port
+    for (port = 0; port < GPIO_PORT_COUNT; port++) {
+        portConfigs[port].used = 0;
+        portConfigs[port].dir = 0;
+        portConfigs[port].afsel = 0;
+        portConfigs[port].odr = 0;
+        portConfigs[port].pur = 0;
+        portConfigs[port].pdr = 0;
+        portConfigs[port].den = 0;
+        portConfigs[port].amsel = 0;
+        portConfigs[port].pctl = 0;
+    }
+
+    // Merge every table entry into the configuration of its port
+    for (i = 0; i < tableCount; i++) {
+        for (entry = tables[i]; entry->pins != 0; entry++) {
+            GPIO_Merge_Pin_Config(&portConfigs[entry->port], entry);
+            portClocks |= (1UL << entry->port);
+        }
+    }
+
+    // Enable the clocks of all used ports in one write
+    // NOTE: Bit n of RCGCGPIO/PRGPIO corresponds to port index n
+    SYSCTL_RCGCGPIO_R |= portClocks;
+
+    // Select the AHB or APB aperture of every port (bit n of GPIOHBCTL also corresponds to port index n)
+    SYSCTL_GPIOHBCTL_R = (SYSCTL_GPIOHBCTL_R & ~0x3FUL) | GPIO_AHB_PORTS;
+
+    // Wait until the clocks of all used ports are fully initialized
+    while ((SYSCTL_PRGPIO_R & portClocks) != portClocks);
+
+    // Apply the merged configuration of every used port
+    for (port = 0; port < GPIO_PORT_COUNT; port++) {
+        if (portConfigs[port].used != 0)
+            GPIO_Apply_Port_Config(port, &portConfigs[port]);
+    }
+}
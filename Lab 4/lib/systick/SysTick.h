@@ -1,13 +1,28 @@
 #ifndef MCU_SYSTICK
 #define MCU_SYSTICK
 
-// Configure SysTick with busy wait running at initialized bus clock (from PLL)
+// Minimum delay (in cycles) for SysTick_Wait() to sleep instead of busy waiting
+// NOTE: Entering & leaving the SysTick interrupt takes a few dozen cycles, so short delays are more accurate when busy waiting
+#ifndef SYSTICK_SLEEP_MIN_CYCLES
+#define SYSTICK_SLEEP_MIN_CYCLES 1000
+#endif
+
+
+// Configure SysTick for delays running at initialized bus clock (from PLL)
 extern void SysTick_Init(void);
 
 // Unit time delay based on system clock
 // NOTE: It's better to construct higher level functions with greater delays to reduce function calling overhead
 // Delay parameter units is 1 per cycle time (typically in nanoseconds)
+// NOTE: Sleeps until the SysTick interrupt for delays of at least SYSTICK_SLEEP_MIN_CYCLES
 extern void SysTick_Wait(uint32_t delay);
 
+// Configure SysTick to fire an interrupt every 'period' cycles, counting the elapsed periods (ticks)
+// NOTE: SysTick_Wait() reprograms the reload value, so it must not be used in this mode
+extern void SysTick_Init_Periodic(uint32_t period);
+
+// Get the number of periods elapsed since SysTick_Init_Periodic()
+extern uint32_t SysTick_Get_Ticks(void);
+
 
 #endif /* MCU_SYSTICK */
@@ -17,6 +17,11 @@
 #include "lib/mcu/tm4c123gh6pm.h"
 #include "lib/pll/PLL.h"
 #include "lib/systick/SysTick.h"
+#include "lib/power/power.h"
+#include "lib/gpio/gpio.h"
+#include "lib/nvic/Interrupt.h"
+#include "lib/fsm/fsm.h"
+#include "garage_fsm.h"
 
 // Task pin definitions
 #define OUTPUT_INDICATOR_LEDS 0x38u // = 0x20 (PA5) | 0x10 (PA4) | 0x08 (PA3)
@@ -25,92 +30,85 @@
 
 
 // Function Declarations
-void Setup_Port_A_Pins(void);
-void SysTick_Wait_200ms(uint32_t delay);
+void Setup_GPIO_Pins(void);
+void Setup_Port_A_Interrupts(void);
+void Write_Indicator_LEDs(unsigned long output);
+unsigned long Read_Door_Buttons(void);
 
 //////////////////////////
 // GPIO Setup functions //
 //////////////////////////
 
 
-void Setup_Port_A_Pins(void) {
-    // Enable Port A clock
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R0;
+// Pin configuration for the indicator LEDs (PA3 - PA5) and door buttons (PA6 & PA7)
+const GPIO_PinConfig TASK_PIN_CONFIG[] = {
+    {GPIO_PORT_A, OUTPUT_INDICATOR_LEDS, GPIO_OUTPUT, 0},
+    // Enable pull-down resistors for PA7 & PA6 (active high logic)
+    {GPIO_PORT_A, INPUT_DOOR_BUTTONS,    GPIO_INPUT | GPIO_PULL_DOWN, 0},
+    GPIO_PIN_CONFIG_END
+};
 
-    // Wait until Port A clock is fully initialized
-    while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R0) == 0);
 
-    // Unlock Port A configuration
-    GPIO_PORTA_LOCK_R = GPIO_LOCK_KEY;
+void Setup_GPIO_Pins(void) {
+    const GPIO_PinConfig *const pinTables[] = { TASK_PIN_CONFIG };
 
-    // Set commit register to only work with PA7 - PA3
-    GPIO_PORTA_CR_R = PORTA_WORKING_PINS;
+    // Configure Port A in a single pass
+    GPIO_Init_Pins(pinTables, sizeof(pinTables) / sizeof(pinTables[0]));
+}
 
-    // Set output indicator LEDs (PA7 & PA6) pin as output and rest as inputs
-    GPIO_PORTA_DIR_R |= OUTPUT_INDICATOR_LEDS;
 
-    // Disable all analog functionality for PA7 - PA3
-    GPIO_PORTA_AMSEL_R &= ~PORTA_WORKING_PINS;
+////////////////////////////////
+// Interrupt Setup & Handlers //
+////////////////////////////////
 
-    // Enable digital functionality for PA7 - PA3
-    GPIO_PORTA_DEN_R |= PORTA_WORKING_PINS;
 
-    // Disable all alternate functionality for PA7 - PA3
-    GPIO_PORTA_AFSEL_R &= ~PORTA_WORKING_PINS;
+void Setup_Port_A_Interrupts(void) {
+    // Set interrupt trigger for PA6 & PA7 to be edge sensitive
+    GPIO_REG(GPIO_PORT_A, GPIO_O_IS) &= ~INPUT_DOOR_BUTTONS;
 
-    // Disable all special functionality for PA7 - PA3
-    GPIO_PORTA_PCTL_R &= ~PORTA_WORKING_PINS;
+    // Set interrupt trigger for PA6 & PA7 to be fired from both edges (door sensor pressed & released)
+    GPIO_REG(GPIO_PORT_A, GPIO_O_IBE) |= INPUT_DOOR_BUTTONS;
 
-    // Enable pull-down resistors for PA7 & PA6 (active high logic)
-    GPIO_PORTA_PDR_R |= INPUT_DOOR_BUTTONS;
+    // Clear any prior interrupts for PA6 & PA7
+    GPIO_REG(GPIO_PORT_A, GPIO_O_ICR) = INPUT_DOOR_BUTTONS;
 
-    // Lock Port A configuration
-    GPIO_PORTA_LOCK_R = 0;
-}
+    // Unmask the interrupt for PA6 & PA7
+    GPIO_REG(GPIO_PORT_A, GPIO_O_IM) |= INPUT_DOOR_BUTTONS;
+
+    // Set interrupt priority for GPIO Port A to level 5 & enable it
+    NVIC_SET_PRIORITY(GPIOA_IRQn, 5);
+    NVIC_ENABLE_IRQ(GPIOA_IRQn);
 
+    // Globally enable interrupt requests (IRQs) by clearing priority mask
+    __enable_irq();
+}
 
-//////////////////////
-// Timing Functions //
-//////////////////////
 
+// NOTE: This is meant to be implicitly overriden
+void GPIOA_Handler(void) {
+    // Clear the PA6 & PA7 interrupt flags (ICR is write-1-to-clear, so a direct store is enough)
+    GPIO_REG(GPIO_PORT_A, GPIO_O_ICR) = INPUT_DOOR_BUTTONS;
 
-// Wait for delay x 200 ms via SysTick (assuming 50 MHz clock -> 1 cycle = 20 ns)
-void SysTick_Wait_200ms(uint32_t delay) {
-    uint32_t i;
-    for (i = 0 ; i < delay; i++) {
-        // Wait for duration of 10,000,000 * 20 ns
-        SysTick_Wait(10000000);
-    }
+    // Wake up the state machine to re-evaluate the door inputs
+    FSM_Post_Event();
 }
 
-/////////////////////
-// State definiton //
-/////////////////////
-
-struct State {
-    // Output to set for LED indicator pins (PA3 - PA5)
-    unsigned long Output;
-    // Amount of time x 1 second to wait before next state transition
-    unsigned long Time;
-    // Next state transition as specified by input from (PA7 | PA6)
-    struct State *Next[4];
-};
 
-typedef struct State SType;
+/////////////////////////
+// State I/O functions //
+/////////////////////////
 
-SType FSM[4];
-#define empty &FSM[0]
-#define enter &FSM[1]
-#define hold  &FSM[2]
-#define leave &FSM[3]
 
-// See state transition document for more information
-SType FSM[4] = {
-    {0x00, 1, {empty, empty, enter, empty}},
-    {0x20, 2, {empty, hold , enter, hold }},
-    {0x10, 4, {leave, leave, leave, leave}},
-    {0x08, 3, {empty, leave, empty, leave}},
-};
+// Set LED indicators based on current state
+void Write_Indicator_LEDs(unsigned long output) {
+    GPIO_WRITE_PINS(GPIO_PORT_A, OUTPUT_INDICATOR_LEDS, output);
+}
+
+
+// Read from door input buttons (PA7 | PA6)
+unsigned long Read_Door_Buttons(void) {
+    return GPIO_READ_PINS(GPIO_PORT_A, INPUT_DOOR_BUTTONS) >> 6;
+}
 
 
 //////////////////
@@ -119,29 +117,26 @@ SType FSM[4] = {
 
 
 int main() {
-    // Define state variables & set initial state to 'empty'
-    unsigned long Input;
-    SType *Pt;
-    Pt = empty;
-
-    // Initialize PLL & SysTick
-    PLL_Init(SYSDIV2_50_00_Mhz);
-    SysTick_Init();
+    // Define state machine & set initial state to 'empty'
+    FSM_Machine garage;
 
-    // Initialize GPIO pins
-    Setup_Port_A_Pins();
+    // Only Port A keeps its clock while sleeping, to detect the door input edges
+    const Power_SleepClocks sleepClocks = { (1UL << GPIO_PORT_A), 0, 0, 0, 0, 0, 0 };
 
-    while (1) {
-        // Set LED indicators based on current state
-        GPIO_PORTA_DATA_R = Pt -> Output;
+    // Initialize PLL & SysTick (1 tick per 1 ms, assuming 50 MHz clock -> 50,000 * 20 ns)
+    PLL_Init(SYSDIV2_50_00_Mhz);
+    SysTick_Init_Periodic(50000);
 
-        // Wait for specified amount of time (in seconds)
-        SysTick_Wait_200ms((Pt -> Time) * 5);
+    // Initialize GPIO pins & door input interrupts
+    Setup_GPIO_Pins();
+    Setup_Port_A_Interrupts();
 
-        // Read from door input buttons
-        Input = (GPIO_PORTA_DATA_R & 0xC0) >> 6;
+    // Gate the clocks of every other peripheral while sleeping
+    Power_Init(&sleepClocks);
 
-        // Transition to next state based on input
-        Pt = Pt -> Next[Input];
-    }
+    // Run the state machine, sleeping in between SysTick ticks & door input edges
+    // NOTE: Once the dwell time of a state has passed, a door input change is acted upon within the
+    // interrupt latency instead of waiting for the next full dwell time
+    FSM_Init(&garage, empty, Write_Indicator_LEDs, Read_Door_Buttons, SysTick_Get_Ticks());
+    FSM_Run(&garage);
 }
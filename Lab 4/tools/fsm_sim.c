@@ -0,0 +1,340 @@
+/*
+ * Host-side simulator for the Lab 4 parking garage state machine
+ *
+ * Runs the same state table (garage_fsm.c) through the same engine (lib/fsm/fsm.c) as the board,
+ * using simulated 1 ms ticks instead of SysTick, and reports:
+ * - Which transitions (state + input -> next state) were taken, and which were never taken
+ * - Dwell times per state (min / max / average), over the visits that ended with a transition (visits cut
+ *   short by the end of a trace are only counted, since they say nothing about the dwell time)
+ * - Worst-case latency from an input change to the output change it caused
+ *
+ * Build (from the "Lab 4" folder):
+ *   gcc -std=gnu89 -Wall -I. -Ilib -o fsm_sim tools/fsm_sim.c lib/fsm/fsm.c garage_fsm.c
+ *
+ * Usage:
+ *   ./fsm_sim replay <trace file>
+ *     Replays a timestamped input trace. Each line is "<time in ms> <input>" (sorted by time), where
+ *     the input (0 - 3 = PA7 | PA6) holds until the next line. Lines starting with '#' are ignored.
+ *     The simulation ends once the last input has been held for the longest dwell time in the table.
+ *
+ *   ./fsm_sim enumerate <depth> [hold time in ms]
+ *     Runs every input sequence of length <depth> (up to MAX_ENUM_DEPTH), each input held for the
+ *     hold time (default: longest dwell time, so every state gets to evaluate every input).
+ *
+ * The exit code is 1 if any transition of the table was never taken, so it can be used in scripts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "garage_fsm.h"
+
+#define MAX_TRACE_STEPS 4096
+#define MAX_ENUM_DEPTH  12
+#define NO_TIME         0xFFFFFFFFUL
+
+// Single step of an input trace (input applied from 'time' until the next step)
+typedef struct {
+    unsigned long time;
+    unsigned long input;
+} TraceStep;
+
+// Statistics gathered over every simulated trace
+typedef struct {
+    unsigned long transitionCount[GARAGE_NUM_STATES][FSM_NUM_INPUTS];
+    unsigned long dwellVisits[GARAGE_NUM_STATES];
+    unsigned long dwellTruncated[GARAGE_NUM_STATES];    // Visits still going at the end of a trace
+    unsigned long dwellMin[GARAGE_NUM_STATES];
+    unsigned long dwellMax[GARAGE_NUM_STATES];
+    double dwellTotal[GARAGE_NUM_STATES];
+    unsigned long latencySamples;
+    unsigned long latencyMax;
+    double latencyTotal;
+    unsigned long tracesRun;
+} SimStats;
+
+
+// Simulated I/O
+static unsigned long simInput = 0;
+static unsigned long simOutput = 0;
+
+static SimStats stats;
+static TraceStep trace[MAX_TRACE_STEPS];
+
+
+static void Sim_Write_Output(unsigned long output) {
+    simOutput = output;
+}
+
+
+static unsigned long Sim_Read_Input(void) {
+    return simInput;
+}
+
+
+static int State_Index(const FSM_State *state) {
+    return (int) (state - FSM);
+}
+
+
+static unsigned long Longest_Dwell_Time(void) {
+    unsigned long longest = 0;
+    int i;
+
+    for (i = 0; i < GARAGE_NUM_STATES; i++) {
+        if (FSM[i].Time > longest)
+            longest = FSM[i].Time;
+    }
+
+    return longest;
+}
+
+
+static void Stats_Init(void) {
+    int i;
+
+    memset(&stats, 0, sizeof(stats));
+    for (i = 0; i < GARAGE_NUM_STATES; i++)
+        stats.dwellMin[i] = NO_TIME;
+}
+
+
+static void Stats_Record_Dwell(int state, unsigned long dwell) {
+    stats.dwellVisits[state]++;
+    stats.dwellTotal[state] += dwell;
+
+    if (dwell < stats.dwellMin[state])
+        stats.dwellMin[state] = dwell;
+    if (dwell > stats.dwellMax[state])
+        stats.dwellMax[state] = dwell;
+}
+
+
+static void Stats_Record_Latency(unsigned long latency) {
+    stats.latencySamples++;
+    stats.latencyTotal += latency;
+
+    if (latency > stats.latencyMax)
+        stats.latencyMax = latency;
+}
+
+
+// Simulate a single input trace starting from the 'empty' state at tick 0
+//   Instead of stepping through every tick, time jumps straight to the next tick where the outcome can
+//   change (an input change or the end of a dwell time). Since the board evaluates the state machine on
+//   every tick and input edge, this gives the same result as a tick-by-tick simulation.
+static void Simulate_Trace(const TraceStep *steps, int numSteps, unsigned long endTime, int verbose) {
+    FSM_Machine fsm;
+    unsigned long now = 0, next, outputBefore, enteredAt;
+    unsigned long inputChangedAt = NO_TIME;
+    uint32_t dwellLeft;
+    int step = 0, from, sameTickSteps = 0;
+
+    simInput = 0;
+    simOutput = 0;
+    FSM_Init(&fsm, empty, Sim_Write_Output, Sim_Read_Input, 0);
+
+    while (now <= endTime) {
+        // Apply every input change scheduled up to this tick
+        while (step < numSteps && steps[step].time <= now) {
+            if (steps[step].input != simInput)
+                inputChangedAt = now;
+
+            simInput = steps[step].input;
+            step++;
+        }
+
+        // Evaluate the state machine
+        from = State_Index(fsm.Current);
+        enteredAt = fsm.EnteredAt;
+        outputBefore = simOutput;
+
+        if (FSM_Step(&fsm, (uint32_t) now)) {
+            stats.transitionCount[from][simInput]++;
+            Stats_Record_Dwell(from, now - enteredAt);
+
+            if (verbose)
+                printf("%8lu ms: %-5s --(%lu)--> %-5s output = 0x%02lX\n", now, FSM_STATE_NAMES[from],
+                       simInput, FSM_STATE_NAMES[State_Index(fsm.Current)], simOutput);
+
+            // Measure the latency from the last input change to the output change it caused
+            if (simOutput != outputBefore && inputChangedAt != NO_TIME) {
+                Stats_Record_Latency(now - inputChangedAt);
+                inputChangedAt = NO_TIME;
+            }
+
+            // A state with no dwell time is evaluated again on the same tick (bounded in case of a cycle)
+            if (fsm.Current->Time == 0 && ++sameTickSteps <= GARAGE_NUM_STATES)
+                continue;
+        }
+        sameTickSteps = 0;
+
+        // Jump to the next input change or the end of the current dwell time, whichever comes first
+        next = (step < numSteps) ? steps[step].time : NO_TIME;
+        dwellLeft = FSM_Ticks_Until_Dwell_End(&fsm, (uint32_t) now);
+        if (dwellLeft != 0 && now + dwellLeft < next)
+            next = now + dwellLeft;
+
+        if (next == NO_TIME || next > endTime)
+            break;
+
+        now = next;
+    }
+
+    // The final visit is cut short by the end of the trace, so it only gets counted
+    stats.dwellTruncated[State_Index(fsm.Current)]++;
+    stats.tracesRun++;
+}
+
+
+// Load a "<time in ms> <input>" trace file, returning the number of steps (or -1 on error)
+static int Load_Trace(const char *path) {
+    char line[128];
+    int numSteps = 0;
+    FILE *file = fopen(path, "r");
+
+    if (file == NULL) {
+        fprintf(stderr, "Could not open trace file '%s'\n", path);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+            continue;
+
+        if (numSteps >= MAX_TRACE_STEPS) {
+            fprintf(stderr, "Trace is longer than %d steps\n", MAX_TRACE_STEPS);
+            fclose(file);
+            return -1;
+        }
+
+        if (sscanf(line, "%lu %lu", &trace[numSteps].time, &trace[numSteps].input) != 2
+                || trace[numSteps].input >= FSM_NUM_INPUTS
+                || (numSteps > 0 && trace[numSteps].time < trace[numSteps - 1].time)) {
+            fprintf(stderr, "Invalid trace line %d: %s", numSteps + 1, line);
+            fclose(file);
+            return -1;
+        }
+
+        numSteps++;
+    }
+
+    fclose(file);
+    return numSteps;
+}
+
+
+// Run every input sequence of length 'depth', each input held for 'holdTime' ms
+static void Enumerate_Sequences(int depth, unsigned long holdTime) {
+    unsigned long sequence, numSequences = 1, code;
+    int i;
+
+    for (i = 0; i < depth; i++)
+        numSequences *= FSM_NUM_INPUTS;
+
+    for (sequence = 0; sequence < numSequences; sequence++) {
+        code = sequence;
+        for (i = 0; i < depth; i++) {
+            trace[i].time = i * holdTime;
+            trace[i].input = code % FSM_NUM_INPUTS;
+            code /= FSM_NUM_INPUTS;
+        }
+
+        Simulate_Trace(trace, depth, depth * holdTime, 0);
+    }
+}
+
+
+// Print the report, returning the number of transitions that were never taken
+static int Print_Report(void) {
+    int state, input, uncovered = 0, covered = 0;
+    const FSM_State *next;
+
+    printf("\nTransitions (%lu traces):\n", stats.tracesRun);
+    for (state = 0; state < GARAGE_NUM_STATES; state++) {
+        for (input = 0; input < FSM_NUM_INPUTS; input++) {
+            next = FSM[state].Next[input];
+
+            if (next == 0 || next == &FSM[state]) {
+                printf("  %-5s --(%d)--> %-5s  (self-loop)\n", FSM_STATE_NAMES[state], input, FSM_STATE_NAMES[state]);
+            } else if (stats.transitionCount[state][input] == 0) {
+                printf("  %-5s --(%d)--> %-5s  NEVER TAKEN\n", FSM_STATE_NAMES[state], input, FSM_STATE_NAMES[State_Index(next)]);
+                uncovered++;
+            } else {
+                printf("  %-5s --(%d)--> %-5s  %lu\n", FSM_STATE_NAMES[state], input,
+                       FSM_STATE_NAMES[State_Index(next)], stats.transitionCount[state][input]);
+                covered++;
+            }
+        }
+    }
+    printf("Transition coverage: %d / %d\n", covered, covered + uncovered);
+
+    printf("\nDwell times (ms):\n");
+    printf("  %-5s %10s %10s %10s %10s %12s\n", "state", "visits", "cut short", "min", "max", "average");
+    for (state = 0; state < GARAGE_NUM_STATES; state++) {
+        if (stats.dwellVisits[state] == 0 && stats.dwellTruncated[state] == 0) {
+            printf("  %-5s %10s\n", FSM_STATE_NAMES[state], "unreached");
+            continue;
+        }
+
+        if (stats.dwellVisits[state] == 0) {
+            printf("  %-5s %10lu %10lu %10s\n", FSM_STATE_NAMES[state], 0UL, stats.dwellTruncated[state], "never left");
+            continue;
+        }
+
+        printf("  %-5s %10lu %10lu %10lu %10lu %12.1f\n", FSM_STATE_NAMES[state], stats.dwellVisits[state],
+               stats.dwellTruncated[state], stats.dwellMin[state], stats.dwellMax[state],
+               stats.dwellTotal[state] / stats.dwellVisits[state]);
+    }
+
+    printf("\nInput-to-output latency (ms):\n");
+    if (stats.latencySamples == 0) {
+        printf("  no output changes caused by input changes\n");
+    } else {
+        printf("  samples: %lu, average: %.1f, worst case: %lu\n", stats.latencySamples,
+               stats.latencyTotal / stats.latencySamples, stats.latencyMax);
+    }
+
+    return uncovered;
+}
+
+
+static void Print_Usage(const char *program) {
+    fprintf(stderr, "Usage:\n");
+    fprintf(stderr, "  %s replay <trace file>\n", program);
+    fprintf(stderr, "  %s enumerate <depth> [hold time in ms]\n", program);
+}
+
+
+int main(int argc, char *argv[]) {
+    unsigned long holdTime = Longest_Dwell_Time();
+    int numSteps, depth;
+
+    Stats_Init();
+
+    if (argc == 3 && strcmp(argv[1], "replay") == 0) {
+        numSteps = Load_Trace(argv[2]);
+        if (numSteps < 0)
+            return 2;
+
+        // Hold the last input long enough for every state to evaluate it
+        Simulate_Trace(trace, numSteps, (numSteps > 0 ? trace[numSteps - 1].time : 0) + holdTime, 1);
+    } else if ((argc == 3 || argc == 4) && strcmp(argv[1], "enumerate") == 0) {
+        depth = atoi(argv[2]);
+        if (argc == 4)
+            holdTime = strtoul(argv[3], NULL, 10);
+
+        if (depth < 1 || depth > MAX_ENUM_DEPTH || holdTime == 0) {
+            fprintf(stderr, "Depth must be between 1 and %d, and the hold time above 0\n", MAX_ENUM_DEPTH);
+            return 2;
+        }
+
+        Enumerate_Sequences(depth, holdTime);
+    } else {
+        Print_Usage(argv[0]);
+        return 2;
+    }
+
+    return Print_Report() > 0 ? 1 : 0;
+}
@@ -0,0 +1,225 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "nvic/Interrupt.h"
+#include "power/power.h"
+#include "mempool/mempool.h"
+#include "ringbuf/ringbuf.h"
+#include "active.h"
+
+
+// Registered active objects by priority & the set of the ones with events queued (bit n = priority n)
+static Active *actives[ACTIVE_MAX_OBJECTS];
+static volatile uint32_t readySet = 0;
+
+// Armed timers & the tick count, only changed in framework critical sections or from TIMER2A_Handler
+static Active_Timer *timers = NULL;
+static volatile uint32_t ticks = 0;
+
+// Tick rate given to Active_Init(), kept for Active_Set_Clock()
+static uint32_t activeTickHz;
+
+
+// Setup the dispatcher (PendSV) & the time base for timers, ticking 'tickHz' times per second (Timer 2A)
+void Active_Init(uint32_t sysClockHz, uint32_t tickHz) {
+    // Give PendSV the lowest priority (7), so every interrupt handler preempts the active objects
+    NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R & ~NVIC_SYS_PRI3_PENDSV_M) | (7UL << NVIC_SYS_PRI3_PENDSV_S);
+
+    activeTickHz = tickHz;
+
+    // Enable clock for Timer 2
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R2;
+
+    // Wait until Timer 2 clock is fully initialized
+    while ((SYSCTL_PRTIMER_R & SYSCTL_PRTIMER_R2) == 0);
+
+    // Disable Timer A during setup
+    TIMER2_CTL_R = 0;
+
+    // 32-bit periodic mode, interrupting once per tick
+    TIMER2_CFG_R = 0;
+    TIMER2_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+    TIMER2_TAILR_R = sysClockHz / tickHz - 1;
+    TIMER2_ICR_R = TIMER_ICR_TATOCINT;
+    TIMER2_IMR_R = TIMER_IMR_TATOIM;
+
+    // Set interrupt priority for Timer 2A (level 6 by default, just above the dispatcher) & enable it
+    NVIC_SET_PRIORITY(TIMER2A_IRQn, ACTIVE_TICK_PRIORITY);
+    NVIC_ENABLE_IRQ(TIMER2A_IRQn);
+
+    // Start Timer A
+    TIMER2_CTL_R = (TIMER_CTL_TASTALL | TIMER_CTL_TAEN);
+}
+
+
+// Keep ticking 'tickHz' times per second on a new system clock frequency
+void Active_Set_Clock(uint32_t sysClockHz) {
+    // With TAILD clear (as setup above), a new interval load value takes effect right away
+    TIMER2_TAILR_R = sysClockHz / activeTickHz - 1;
+}
+
+
+// Register 'active' & post it the ACTIVE_SIGNAL_START event
+int Active_Start(Active *active, unsigned int priority, Active_Event *queueStorage,
+                 unsigned int queueCapacity, Active_Handler handler) {
+    if (priority >= ACTIVE_MAX_OBJECTS || actives[priority] != NULL)
+        return 0;
+
+    if (!RingBuf_Init(&active->queue, queueStorage, sizeof(Active_Event), queueCapacity))
+        return 0;
+
+    active->handler = handler;
+    active->priority = priority;
+    active->droppedEvents = 0;
+    actives[priority] = active;
+
+    return Active_Post(active, ACTIVE_SIGNAL_START, 0, NULL);
+}
+
+
+// Queue an event for 'target', returning 0 (and freeing 'data') if its queue is full
+int Active_Post(Active *target, uint8_t signal, uint32_t param, void *data) {
+    Active_Event event;
+    uint32_t saved;
+    int queued;
+
+    event.signal = signal;
+    event.param = param;
+    event.data = data;
+
+    // The ring buffer takes a single producer, so posters (any handler) take turns in a critical section
+    // (masking the handlers up to INTERRUPT_FRAMEWORK_PRIORITY, see "Interrupt.h")
+    saved = Interrupt_Framework_Save();
+
+    queued = RingBuf_Push(&target->queue, &event);
+    if (queued)
+        readySet |= (1UL << target->priority);
+    else
+        target->droppedEvents++;
+
+    Interrupt_Framework_Restore(saved);
+
+    if (!queued) {
+        MemPool_Free(data);
+        return 0;
+    }
+
+    // Run the dispatcher once no other interrupt handler is running
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    return 1;
+}
+
+
+// NOTE: This is meant to be implicitly overriden
+// Dispatch every queued event, always picking the most urgent active object first
+void PendSV_Handler(void) {
+    Active_Event event;
+    Active *active;
+    uint32_t saved;
+
+    while (1) {
+        saved = Interrupt_Framework_Save();
+
+        if (readySet == 0) {
+            Interrupt_Framework_Restore(saved);
+            return;
+        }
+
+        // Lowest set bit = most urgent (count trailing zeros by reversing the bits & counting leading zeros)
+        active = actives[__clz(__rbit(readySet))];
+
+        RingBuf_Pop(&active->queue, &event);
+        if (RingBuf_Count(&active->queue) == 0)
+            readySet &= ~(1UL << active->priority);
+
+        Interrupt_Framework_Restore(saved);
+
+        // Run to completion with interrupts enabled, then release the event's data
+        active->handler(active, &event);
+        MemPool_Free(event.data);
+    }
+}
+
+
+// Post 'signal' to 'target' after 'ticks' ticks, then every 'period' ticks (0 = only once)
+void Active_Timer_Arm(Active_Timer *timer, Active *target, uint8_t signal, uint32_t ticks, uint32_t period) {
+    uint32_t saved = Interrupt_Framework_Save();
+
+    timer->target = target;
+    timer->signal = signal;
+    timer->remaining = (ticks == 0) ? 1 : ticks;
+    timer->period = period;
+
+    if (!timer->armed) {
+        timer->armed = 1;
+        timer->next = timers;
+        timers = timer;
+    }
+
+    Interrupt_Framework_Restore(saved);
+}
+
+
+void Active_Timer_Disarm(Active_Timer *timer) {
+    Active_Timer **link;
+    uint32_t saved = Interrupt_Framework_Save();
+
+    for (link = &timers; *link != NULL; link = &(*link)->next) {
+        if (*link == timer) {
+            *link = timer->next;
+            timer->armed = 0;
+            break;
+        }
+    }
+
+    Interrupt_Framework_Restore(saved);
+}
+
+
+// Number of ticks since Active_Init()
+uint32_t Active_Get_Ticks(void) {
+    return ticks;
+}
+
+
+// NOTE: This is meant to be implicitly overriden
+void TIMER2A_Handler(void) {
+    Active_Timer **link = &timers;
+    Active_Timer *timer;
+
+    // Clear the time-out flag (ICR is write-1-to-clear, so a direct store is enough)
+    TIMER2_ICR_R = TIMER_ICR_TATOCINT;
+
+    ticks++;
+
+    // Count down every armed timer, dropping the one-shot ones once they expire
+    // NOTE: Higher priority handlers may post but never arm timers, so the list is stable here
+    while ((timer = *link) != NULL) {
+        if (--timer->remaining == 0) {
+            Active_Post(timer->target, timer->signal, 0, NULL);
+
+            if (timer->period != 0) {
+                timer->remaining = timer->period;
+            } else {
+                *link = timer->next;
+                timer->armed = 0;
+                continue;
+            }
+        }
+
+        link = &timer->next;
+    }
+}
+
+
+// Hand the core over to the interrupt handlers & active objects for good, sleeping whenever they're idle
+// NOTE: Sleeps from this loop instead of sleeping on exit (see Power_Sleep_On_Exit()), so the power statistics
+// count the time spent sleeping. Each wake-up runs the pending handlers, and with them the dispatcher (PendSV),
+// before going back to sleep.
+void Active_Run(void) {
+    __disable_irq();
+
+    while (1)
+        Power_Sleep();
+}
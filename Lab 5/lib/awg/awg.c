@@ -0,0 +1,339 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dac/dac_dma.h"
+#include "awg.h"
+
+// Table buffers: 1 per name, plus 1 being loaded & 1 still finishing its last cycle after being replaced
+#define AWG_SLOT_COUNT (AWG_MAX_TABLES + 2)
+
+// Full cycles a replaced table may still be read by the uDMA (both ping-pong halves may hold it)
+#define AWG_RETIRE_CYCLES 2
+
+// Longest command token (a sample or a name, with room for the null terminator)
+#define AWG_TOKEN_SIZE 12
+
+typedef struct {
+    char name[AWG_NAME_LENGTH + 1];     // Empty = unnamed
+    unsigned int length;
+    int retired;                        // Was playing when replaced or switched away from, at 'retiredAt'
+    unsigned long retiredAt;            // (in DAC_DMA_Cycles())
+    uint8_t samples[AWG_MAX_SAMPLES];
+} AWG_Slot;
+
+typedef enum {
+    AWG_COMMAND_NONE,
+    AWG_COMMAND_TABLE,
+    AWG_COMMAND_PLAY,
+    AWG_COMMAND_STOP,
+    AWG_COMMAND_LIST,
+    AWG_COMMAND_INVALID
+} AWG_Command;
+
+static AWG_Slot slots[AWG_SLOT_COUNT];
+
+// Slot being built (-1 = none) & slot playing (-1 = stopped)
+static int loadSlot = -1;
+static int playSlot = -1;
+
+// Command line being parsed by AWG_Feed()
+static AWG_Command command = AWG_COMMAND_NONE;
+static const char *commandError = NULL;
+static unsigned int tokenIndex = 0;
+static char token[AWG_TOKEN_SIZE];
+static unsigned int tokenLength = 0;
+static char commandName[AWG_NAME_LENGTH + 1];
+static long commandAmplitude, commandOffset;
+static unsigned int commandSamples = 0;
+
+
+// Find the slot of the table named 'name' (-1 = none)
+static int AWG_Find(const char *name) {
+    int i;
+
+    for (i = 0; i < AWG_SLOT_COUNT; i++) {
+        if (slots[i].name[0] != '\0' && strcmp(slots[i].name, name) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+
+// Mark the playing slot as possibly still being read by the uDMA, from now on
+static void AWG_Retire_Play_Slot(void) {
+    if (playSlot >= 0) {
+        slots[playSlot].retired = 1;
+        slots[playSlot].retiredAt = DAC_DMA_Cycles();
+    }
+}
+
+
+// Switch playback to 'slot', which takes over at the end of the cycle in progress
+static void AWG_Play_Slot(int slot) {
+    if (slot == playSlot)
+        return;
+
+    AWG_Retire_Play_Slot();
+    playSlot = slot;
+    slots[slot].retired = 0;
+
+    DAC_DMA_Play(slots[slot].samples, slots[slot].length);
+}
+
+
+// Forget every table & the command in progress
+void AWG_Init(void) {
+    int i;
+
+    for (i = 0; i < AWG_SLOT_COUNT; i++) {
+        slots[i].name[0] = '\0';
+        slots[i].length = 0;
+        slots[i].retired = 0;
+    }
+
+    loadSlot = -1;
+    playSlot = -1;
+    command = AWG_COMMAND_NONE;
+    commandError = NULL;
+    tokenIndex = 0;
+    tokenLength = 0;
+}
+
+
+// Start building a table, returning the buffer for its DAC codes (NULL if no table buffer is free)
+uint8_t *AWG_Begin_Table(void) {
+    unsigned long cycles = DAC_DMA_Cycles();
+    int i;
+
+    for (i = 0; i < AWG_SLOT_COUNT; i++) {
+        if (slots[i].name[0] != '\0' || i == playSlot)
+            continue;
+
+        // NOTE: Subtracting the cycle counts also handles the wrap around
+        if (slots[i].retired && cycles - slots[i].retiredAt < AWG_RETIRE_CYCLES)
+            continue;
+
+        slots[i].retired = 0;
+        loadSlot = i;
+        return slots[i].samples;
+    }
+
+    loadSlot = -1;
+    return NULL;
+}
+
+
+// Name the table started by AWG_Begin_Table(), replacing any table with that name (even while playing)
+int AWG_Commit_Table(const char *name, unsigned int length) {
+    int slot = loadSlot;
+    int previous;
+
+    loadSlot = -1;
+
+    if (slot < 0 || name[0] == '\0' || strlen(name) > AWG_NAME_LENGTH || length < 2 || length > AWG_MAX_SAMPLES)
+        return 0;
+
+    previous = AWG_Find(name);
+
+    // Only replacing a table may take up the last name
+    if (previous < 0) {
+        int i, named = 0;
+
+        for (i = 0; i < AWG_SLOT_COUNT; i++)
+            named += (slots[i].name[0] != '\0');
+
+        if (named >= AWG_MAX_TABLES)
+            return 0;
+    }
+
+    strcpy(slots[slot].name, name);
+    slots[slot].length = length;
+
+    if (previous >= 0) {
+        slots[previous].name[0] = '\0';
+
+        // The new version takes over from the end of the cycle in progress
+        if (previous == playSlot)
+            AWG_Play_Slot(slot);
+    }
+
+    return 1;
+}
+
+
+// Play the table named 'name' from the end of the cycle in progress
+int AWG_Play(const char *name) {
+    int slot = AWG_Find(name);
+
+    if (slot < 0)
+        return 0;
+
+    AWG_Play_Slot(slot);
+    return 1;
+}
+
+
+// Stop playing right away
+void AWG_Stop(void) {
+    int i;
+
+    DAC_DMA_Stop();
+    playSlot = -1;
+
+    // Nothing reads the tables anymore
+    for (i = 0; i < AWG_SLOT_COUNT; i++)
+        slots[i].retired = 0;
+}
+
+
+// Parse a whole decimal number in 'str' into 'value', returning 0 if it isn't one
+static int AWG_Parse_Number(const char *str, long *value) {
+    char *end;
+
+    *value = strtol(str, &end, 10);
+    return end != str && *end == '\0';
+}
+
+
+// Handle the token just completed, which is token number 'tokenIndex' of the command line
+static void AWG_End_Token(void) {
+    long value;
+    uint8_t *samples;
+
+    token[tokenLength] = '\0';
+    tokenLength = 0;
+
+    if (commandError != NULL) {
+        tokenIndex++;
+        return;
+    }
+
+    if (tokenIndex == 0) {
+        if (strcmp(token, "table") == 0)
+            command = AWG_COMMAND_TABLE;
+        else if (strcmp(token, "play") == 0)
+            command = AWG_COMMAND_PLAY;
+        else if (strcmp(token, "stop") == 0)
+            command = AWG_COMMAND_STOP;
+        else if (strcmp(token, "list") == 0)
+            command = AWG_COMMAND_LIST;
+        else
+            commandError = "unknown command";
+
+        commandSamples = 0;
+        commandName[0] = '\0';
+    } else if (tokenIndex == 1 && (command == AWG_COMMAND_TABLE || command == AWG_COMMAND_PLAY)) {
+        if (strlen(token) > AWG_NAME_LENGTH)
+            commandError = "name too long";
+        else
+            strcpy(commandName, token);
+    } else if (command == AWG_COMMAND_TABLE && tokenIndex == 2) {
+        if (!AWG_Parse_Number(token, &commandAmplitude) || commandAmplitude < -255 || commandAmplitude > 255)
+            commandError = "bad amplitude";
+    } else if (command == AWG_COMMAND_TABLE && tokenIndex == 3) {
+        if (!AWG_Parse_Number(token, &commandOffset) || commandOffset < -255 || commandOffset > 255)
+            commandError = "bad offset";
+    } else if (command == AWG_COMMAND_TABLE) {
+        // Samples go straight into the table buffer, scaled once here
+        samples = (commandSamples == 0) ? AWG_Begin_Table() : slots[loadSlot].samples;
+
+        if (samples == NULL)
+            commandError = "no free table";
+        else if (!AWG_Parse_Number(token, &value) || value < -127 || value > 127)
+            commandError = "bad sample";
+        else if (commandSamples >= AWG_MAX_SAMPLES)
+            commandError = "too many samples";
+
+        if (commandError == NULL) {
+            value = commandOffset + value * commandAmplitude / 127;
+            samples[commandSamples++] = (uint8_t) (value < 0 ? 0 : (value > 255 ? 255 : value));
+        }
+    } else {
+        commandError = "too many arguments";
+    }
+
+    tokenIndex++;
+}
+
+
+// Run the command line just completed, answering through 'reply'
+static void AWG_End_Line(AWG_Writer reply) {
+    char line[AWG_NAME_LENGTH + 16];
+    int i;
+
+    if (tokenLength != 0)
+        AWG_End_Token();
+
+    // Ignore empty lines
+    if (tokenIndex == 0)
+        return;
+
+    if (commandError == NULL) {
+        switch (command) {
+            case AWG_COMMAND_TABLE:
+                if (commandName[0] == '\0' || commandSamples < 2)
+                    commandError = "need a name & at least 2 samples";
+                else if (!AWG_Commit_Table(commandName, commandSamples))
+                    commandError = "too many tables";
+                break;
+            case AWG_COMMAND_PLAY:
+                if (!AWG_Play(commandName))
+                    commandError = "no such table";
+                break;
+            case AWG_COMMAND_STOP:
+                AWG_Stop();
+                break;
+            case AWG_COMMAND_LIST:
+                for (i = 0; i < AWG_SLOT_COUNT; i++) {
+                    if (slots[i].name[0] != '\0') {
+                        sprintf(line, "%s,%u\r\n", slots[i].name, slots[i].length);
+                        reply(line);
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Drop a table left half-loaded
+    loadSlot = -1;
+
+    if (commandError != NULL) {
+        reply("error ");
+        reply(commandError);
+        reply("\r\n");
+    } else {
+        reply("ok\r\n");
+    }
+
+    command = AWG_COMMAND_NONE;
+    commandError = NULL;
+    tokenIndex = 0;
+}
+
+
+// Run the text commands in 'length' received bytes, answering through 'reply'
+void AWG_Feed(const char *data, unsigned int length, AWG_Writer reply) {
+    unsigned int i;
+    char c;
+
+    for (i = 0; i < length; i++) {
+        c = data[i];
+
+        if (c == '\n') {
+            AWG_End_Line(reply);
+        } else if (c == ' ' || c == ',' || c == '\t' || c == '\r') {
+            if (tokenLength != 0)
+                AWG_End_Token();
+        } else if (tokenLength < AWG_TOKEN_SIZE - 1) {
+            token[tokenLength++] = c;
+        } else if (commandError == NULL) {
+            commandError = "token too long";
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef MCU_AWG
+#define MCU_AWG
+
+#include <stdint.h>
+
+// Arbitrary waveform generator: named waveform tables in RAM, played on the DAC by the uDMA (see "dac_dma.h")
+// - Tables hold final DAC codes, so any scaling happens once while loading and playback needs no math at all
+// - Switching tables (or replacing the one playing) takes effect at the end of the cycle in progress
+// - Tables can be built by the code (AWG_Begin_Table() & AWG_Commit_Table()) or loaded over a serial link as
+//   text commands (AWG_Feed()), 1 per line with tokens separated by spaces or commas:
+//     table <name> <amplitude> <offset> <s0> <s1> ...   Load (or replace) a table of 2 - AWG_MAX_SAMPLES samples,
+//                                                       each sample (-127 - 127) becoming
+//                                                       offset + sample * amplitude / 127 (clamped to 0 - 255,
+//                                                       with amplitude & offset from -255 - 255)
+//     play <name>                                       Play a table from the end of the cycle in progress
+//     stop                                              Stop playing right away
+//     list                                              List the tables as "<name>,<length>" lines
+//   Every command is answered by an "ok" or "error <reason>" line
+//
+// Number of tables & most samples per table (at most UDMA_MAX_TRANSFERS)
+#ifndef AWG_MAX_TABLES
+#define AWG_MAX_TABLES 6
+#endif
+
+#ifndef AWG_MAX_SAMPLES
+#define AWG_MAX_SAMPLES 512
+#endif
+
+// Longest table name (in characters)
+#define AWG_NAME_LENGTH 8
+
+// Sends a null-terminated reply string (i.e. Uart_Write_String)
+typedef unsigned int (*AWG_Writer)(const char *str);
+
+
+// Forget every table & the command in progress
+// NOTE: DAC_DMA_Init() must have been called beforehand
+extern void AWG_Init(void);
+
+// Start building a table, returning the buffer for its (up to AWG_MAX_SAMPLES) DAC codes, or NULL if no
+// table buffer is free (i.e. while replaced tables are still finishing their last cycle)
+extern uint8_t *AWG_Begin_Table(void);
+
+// Name the table started by AWG_Begin_Table() after filling in 'length' DAC codes, replacing any table
+// with that name (even while playing), returning 0 if the name or length is invalid (the table is dropped)
+extern int AWG_Commit_Table(const char *name, unsigned int length);
+
+// Play the table named 'name' from the end of the cycle in progress, returning 0 if there's none
+extern int AWG_Play(const char *name);
+
+// Stop playing right away, leaving the last sample on the DAC
+extern void AWG_Stop(void);
+
+// Run the text commands in 'length' received bytes, answering through 'reply'
+// NOTE: Commands may be split across calls at any point
+extern void AWG_Feed(const char *data, unsigned int length, AWG_Writer reply);
+
+
+#endif /* MCU_AWG */
@@ -0,0 +1,185 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "nvic/Interrupt.h"
+#include "budget.h"
+
+// DWT control & cycle counter registers, and the trace enable bit of the debug control register (DEMCR, named
+// NVIC_DBG_INT_R by the MCU header), all missing from the MCU header
+#define DWT_CTRL_R              (*((volatile unsigned long *)0xE0001000))
+#define DWT_CYCCNT_R            (*((volatile unsigned long *)0xE0001004))
+#define DWT_CTRL_CYCCNTENA      0x00000001
+#define NVIC_DBG_INT_TRCENA     0x01000000
+
+// Entries of the vector table: the initial stack pointer & 15 system exceptions, then 139 interrupts, so
+// exception number = interrupt number + 16
+#define BUDGET_VECTORS 155
+#define BUDGET_EXCEPTION_OFFSET 16
+#define BUDGET_NO_SLOT 0xFFu
+
+typedef void (*Budget_Handler)(void);
+
+// Vector table in RAM
+// NOTE: The core requires the table to start on a boundary of its size rounded up to a power of 2 (1024 bytes)
+static unsigned long vectors[BUDGET_VECTORS] __attribute__((aligned(1024)));
+
+// Slot of the handler watched for each exception number (BUDGET_NO_SLOT = not watched)
+static uint8_t slotOf[BUDGET_VECTORS];
+
+// Results & original handler of each slot, the results only changed by the handler's own wrapper
+static Budget_Stats stats[BUDGET_MAX_HANDLERS];
+static Budget_Handler originals[BUDGET_MAX_HANDLERS];
+static unsigned int slotCount = 0;
+static Budget_Hook hook = NULL;
+
+// Cycles spent in watched handlers so far, so a wrapper can take out the time of the ones preempting its own
+// (only differences get used, so it's free to wrap around)
+static volatile uint32_t nestedCycles = 0;
+
+
+// Installed as the vector of every watched handler: run the original handler, then charge it its own time
+static void Budget_Wrapper(void) {
+    register uint32_t ipsrReg __asm("ipsr");
+    Budget_Stats *result;
+    uint32_t primask, start, nestedStart, elapsed, own;
+    unsigned int slot;
+
+    // The active exception number tells which handler this is
+    slot = slotOf[ipsrReg & 0xFF];
+
+    // Both timestamps at once, so a handler preempting in between can't be counted on only 1 side
+    primask = Interrupt_Disable_Save();
+    start = DWT_CYCCNT_R;
+    nestedStart = nestedCycles;
+    Interrupt_Restore(primask);
+
+    originals[slot]();
+
+    primask = Interrupt_Disable_Save();
+    elapsed = DWT_CYCCNT_R - start;
+    own = elapsed - (nestedCycles - nestedStart);
+
+    // Whatever this handler preempted gets all of its time taken out (including the time it took out itself)
+    nestedCycles = nestedStart + elapsed;
+    Interrupt_Restore(primask);
+
+    result = &stats[slot];
+    result->runs++;
+    result->lastCycles = own;
+
+    if (own > result->maxCycles)
+        result->maxCycles = own;
+
+    if (own > result->budgetCycles) {
+        result->overruns++;
+
+        if (hook != NULL)
+            hook(result);
+    }
+}
+
+
+// Start the cycle counter & move the vector table to RAM, calling 'overrunHook' on overruns
+void Budget_Init(Budget_Hook overrunHook) {
+    const volatile unsigned long *current = (const volatile unsigned long *) NVIC_VTABLE_R;
+    uint32_t primask;
+    unsigned int i;
+
+    // The DWT only runs with trace enabled (a counter already started, i.e. by Latency_Init(), keeps counting)
+    NVIC_DBG_INT_R |= NVIC_DBG_INT_TRCENA;
+    DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+
+    memset(slotOf, BUDGET_NO_SLOT, sizeof(slotOf));
+    memset(stats, 0, sizeof(stats));
+    slotCount = 0;
+    hook = overrunHook;
+
+    primask = Interrupt_Disable_Save();
+
+    // Copy the table in use (the one in flash out of reset), then switch over to the copy
+    for (i = 0; i < BUDGET_VECTORS; i++)
+        vectors[i] = current[i];
+
+    NVIC_VTABLE_R = (unsigned long) vectors;
+
+    // Make sure the next exception already fetches its vector from the copy
+    __dsb(0xF);
+
+    Interrupt_Restore(primask);
+}
+
+
+// Time the handler of interrupt 'IRQn' against 'budgetCycles' system clock cycles
+int Budget_Watch(int IRQn, const char *name, uint32_t budgetCycles) {
+    int exception = IRQn + BUDGET_EXCEPTION_OFFSET;
+    uint32_t primask;
+    unsigned int slot;
+
+    if (exception < BUDGET_EXCEPTION_OFFSET + BUDGET_PENDSV_IRQn || exception >= BUDGET_VECTORS)
+        return 0;
+
+    if (slotCount >= BUDGET_MAX_HANDLERS || slotOf[exception] != BUDGET_NO_SLOT)
+        return 0;
+
+    slot = slotCount++;
+
+    stats[slot].name = name;
+    stats[slot].IRQn = IRQn;
+    stats[slot].budgetCycles = budgetCycles;
+    originals[slot] = (Budget_Handler) vectors[exception];
+
+    // The vector only changes with a single store, so the handler can stay enabled meanwhile
+    primask = Interrupt_Disable_Save();
+
+    slotOf[exception] = (uint8_t) slot;
+    vectors[exception] = (unsigned long) Budget_Wrapper;
+
+    Interrupt_Restore(primask);
+    return 1;
+}
+
+
+// Copy the results of the handler watched in slot 'slot'
+int Budget_Get(unsigned int slot, Budget_Stats *result) {
+    uint32_t primask;
+
+    if (slot >= slotCount)
+        return 0;
+
+    primask = Interrupt_Disable_Save();
+
+    *result = stats[slot];
+
+    Interrupt_Restore(primask);
+    return 1;
+}
+
+
+// Overruns of every watched handler so far
+unsigned long Budget_Total_Overruns(void) {
+    unsigned long total = 0;
+    unsigned int slot;
+
+    for (slot = 0; slot < slotCount; slot++)
+        total += stats[slot].overruns;
+
+    return total;
+}
+
+
+// Write the results of every watched handler as lines of text with 'writeString'
+void Budget_Write(unsigned int (*writeString)(const char *str)) {
+    Budget_Stats result;
+    char line[96];
+    unsigned int slot;
+
+    for (slot = 0; Budget_Get(slot, &result); slot++) {
+        sprintf(line, "budget,%.16s,%lu,%lu,%lu,%lu,%lu\r\n", result.name, result.runs,
+                (unsigned long) result.budgetCycles, (unsigned long) result.lastCycles,
+                (unsigned long) result.maxCycles, result.overruns);
+        writeString(line);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef MCU_BUDGET
+#define MCU_BUDGET
+
+#include <stdint.h>
+
+// Execution-time budgets of interrupt handlers, counting every run that takes longer than its handler's budget
+// - Works on the handlers as they are: the vector table gets copied to RAM (VTOR), and the vector of every
+//   watched handler replaced by a wrapper that times the original one with the DWT cycle counter
+// - Only a handler's own time counts: time spent in watched handlers preempting it gets taken out (time in
+//   unwatched ones doesn't, so watch every handler that could preempt a budgeted one)
+// - An optional hook gets called on every overrun, from the handler's context right after it returns (i.e. to
+//   stop in the debugger)
+// - Costs ~30 cycles per watched handler run on top of the handler itself
+//
+// Example (the uDMA refill of the DAC within 8000 cycles):
+//   Budget_Init(NULL);
+//   Budget_Watch(TIMER5A_IRQn, "dac", 8000);
+//
+// Number of handlers that can be watched
+// NOTE: Overridable per project, i.e. via the C/C++ "Define" field in the Keil project options
+#ifndef BUDGET_MAX_HANDLERS
+#define BUDGET_MAX_HANDLERS 8
+#endif
+
+// Interrupt numbers of the system handlers that can be watched (the peripheral ones are in "Interrupt.h")
+#define BUDGET_PENDSV_IRQn  -2
+#define BUDGET_SYSTICK_IRQn -1
+
+typedef struct {
+    const char *name;
+    int IRQn;
+    uint32_t budgetCycles;
+    unsigned long runs;
+    unsigned long overruns;     // Runs that took longer than 'budgetCycles'
+    uint32_t lastCycles;        // Own time of the last run &
+    uint32_t maxCycles;         // the worst one (in system clock cycles)
+} Budget_Stats;
+
+// Called on every overrun, with the results of the handler so far
+typedef void (*Budget_Hook)(const Budget_Stats *stats);
+
+
+// Start the cycle counter & move the vector table to RAM, calling 'overrunHook' on overruns (NULL = none)
+// NOTE: Call once, before any Budget_Watch() (handlers may already be enabled, the switch is atomic)
+extern void Budget_Init(Budget_Hook overrunHook);
+
+// Time the handler of interrupt 'IRQn' against 'budgetCycles' system clock cycles, returning 0 if every slot is
+// taken (or the handler is already watched)
+// NOTE: 'name' must stay around (i.e. a string literal), & is cut to 16 characters in reports
+extern int Budget_Watch(int IRQn, const char *name, uint32_t budgetCycles);
+
+// Copy the results of the handler watched in slot 'slot' (0 - BUDGET_MAX_HANDLERS - 1, in the order of the
+// Budget_Watch() calls), returning 0 if the slot is unused
+extern int Budget_Get(unsigned int slot, Budget_Stats *result);
+
+// Overruns of every watched handler so far
+extern unsigned long Budget_Total_Overruns(void);
+
+// Write the results of every watched handler as lines of text with 'writeString' (i.e. Uart_Write_String):
+// "budget,<name>,<runs>,<budget>,<last>,<max>,<overruns>" (cycles)
+extern void Budget_Write(unsigned int (*writeString)(const char *str));
+
+
+#endif /* MCU_BUDGET */
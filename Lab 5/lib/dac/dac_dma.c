@@ -0,0 +1,183 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "gpio/gpio.h"
+#include "nvic/Interrupt.h"
+#include "udma/udma.h"
+#include "dac_dma.h"
+
+#define DAC_DMA_CHANNEL_BIT (1UL << DAC_DMA_CHANNEL)
+
+// Byte-wide transfers from an incrementing source (the table) to a fixed destination (the DAC data register),
+// 1 transfer per timer request
+#define DAC_DMA_CONTROL_FLAGS \
+    (UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_DSTSIZE_8 | UDMA_CHCTL_SRCINC_8 | UDMA_CHCTL_SRCSIZE_8 | \
+     UDMA_CHCTL_ARBSIZE_1 | UDMA_CHCTL_XFERMODE_PINGPONG)
+
+// Table being played (or to be played from the next cycle on), only changed with interrupts disabled
+static const uint8_t *volatile playTable = NULL;
+static volatile unsigned int playLength = 0;
+
+// Stream being played instead when 'streamFill' is set, with 'playLength' samples per block
+static uint8_t *volatile streamBuffer = NULL;
+static volatile DAC_DMA_Fill streamFill = NULL;
+
+static volatile unsigned long cycles = 0;
+static volatile unsigned long underruns = 0;
+
+
+// Point a control structure ('alternate' = 0 or 1) at 1 full cycle of the current table, or at its own block of
+// the stream once refilled
+static void DAC_DMA_Load(UDMA_Control *control, unsigned int alternate) {
+    const uint8_t *source = playTable;
+
+    if (streamFill != NULL) {
+        source = streamBuffer + alternate * playLength;
+        streamFill(streamBuffer + alternate * playLength, playLength);
+    }
+
+    control->srcEnd = source + playLength - 1;
+    control->dstEnd = &GPIO_DATA_MASKED(DAC_DMA_PORT, DAC_DMA_PINS);
+    control->control = UDMA_CONTROL_WORD(DAC_DMA_CONTROL_FLAGS, playLength);
+}
+
+
+// Load both control structures & (re)start the channel from the primary one
+static void DAC_DMA_Start_Channel(void) {
+    DAC_DMA_Load(UDMA_Get_Control(DAC_DMA_CHANNEL, 0), 0);
+    DAC_DMA_Load(UDMA_Get_Control(DAC_DMA_CHANNEL, 1), 1);
+
+    UDMA_ALTCLR_R = DAC_DMA_CHANNEL_BIT;
+    UDMA_ENASET_R = DAC_DMA_CHANNEL_BIT;
+}
+
+
+// Setup Timer 5A & the uDMA channel for playing samples at 'sampleRateHz' (without starting)
+void DAC_DMA_Init(uint32_t sysClockHz, uint32_t sampleRateHz) {
+    UDMA_Init();
+
+    // Route the channel to Timer 5A, accepting single & burst requests at the default priority
+    UDMA_ENACLR_R = DAC_DMA_CHANNEL_BIT;
+    UDMA_Assign_Channel(DAC_DMA_CHANNEL, DAC_DMA_CHANNEL_ENCODING);
+    UDMA_USEBURSTCLR_R = DAC_DMA_CHANNEL_BIT;
+    UDMA_REQMASKCLR_R = DAC_DMA_CHANNEL_BIT;
+    UDMA_PRIOCLR_R = DAC_DMA_CHANNEL_BIT;
+
+    // Enable clock for Timer 5
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R5;
+
+    // Wait until Timer 5 clock is fully initialized
+    while ((SYSCTL_PRTIMER_R & SYSCTL_PRTIMER_R5) == 0);
+
+    // Disable Timer A during setup
+    TIMER5_CTL_R = 0;
+
+    // 32-bit periodic mode, timing out once per sample
+    // NOTE: A time-out requests a uDMA transfer through the raw interrupt status alone, so the timer's own
+    // interrupt stays masked and its NVIC vector only fires for the uDMA completions (once per cycle)
+    TIMER5_CFG_R = 0;
+    TIMER5_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+    TIMER5_TAILR_R = sysClockHz / sampleRateHz - 1;
+    TIMER5_IMR_R = 0;
+
+    // Set interrupt priority for Timer 5A (level 3 by default, as it has a whole table cycle to queue the next
+    // one) & enable it
+    NVIC_SET_PRIORITY(TIMER5A_IRQn, DAC_DMA_PRIORITY);
+    NVIC_ENABLE_IRQ(TIMER5A_IRQn);
+}
+
+
+// Play 'length' samples from 'table' over & over
+void DAC_DMA_Play(const uint8_t *table, unsigned int length) {
+    uint32_t basepri;
+
+    if (table == NULL || length < 2 || length > UDMA_MAX_TRANSFERS)
+        return;
+
+    basepri = Interrupt_Mask_Save(DAC_DMA_PRIORITY);
+
+    playTable = table;
+    playLength = length;
+    streamFill = NULL;
+
+    // When already running, the handler picks up the new table for the next cycle it queues
+    if ((TIMER5_CTL_R & TIMER_CTL_TAEN) == 0) {
+        DAC_DMA_Start_Channel();
+        TIMER5_CTL_R = (TIMER_CTL_TASTALL | TIMER_CTL_TAEN);
+    }
+
+    Interrupt_Mask_Restore(basepri);
+}
+
+
+// Stream samples from 'fill', played from 2 blocks of 'blockLength' samples in 'buffer'
+void DAC_DMA_Stream(uint8_t *buffer, unsigned int blockLength, DAC_DMA_Fill fill) {
+    uint32_t basepri;
+
+    if (buffer == NULL || fill == NULL || blockLength < 2 || blockLength > UDMA_MAX_TRANSFERS)
+        return;
+
+    basepri = Interrupt_Mask_Save(DAC_DMA_PRIORITY);
+
+    streamBuffer = buffer;
+    playLength = blockLength;
+    streamFill = fill;
+
+    // Same as for tables: when already running, the handler switches over with the next block it queues
+    // NOTE: Only the half that finishes next gets its block filled, the other one keeps playing the old source
+    if ((TIMER5_CTL_R & TIMER_CTL_TAEN) == 0) {
+        DAC_DMA_Start_Channel();
+        TIMER5_CTL_R = (TIMER_CTL_TASTALL | TIMER_CTL_TAEN);
+    }
+
+    Interrupt_Mask_Restore(basepri);
+}
+
+
+// Stop playback right away, leaving the last sample on the DAC
+void DAC_DMA_Stop(void) {
+    uint32_t basepri = Interrupt_Mask_Save(DAC_DMA_PRIORITY);
+
+    TIMER5_CTL_R = 0;
+    UDMA_ENACLR_R = DAC_DMA_CHANNEL_BIT;
+
+    // Drop a completion that came in meanwhile
+    UDMA_CHIS_R = DAC_DMA_CHANNEL_BIT;
+    NVIC_CLEAR_PENDING_IRQ(TIMER5A_IRQn);
+
+    Interrupt_Mask_Restore(basepri);
+}
+
+
+// Number of full table cycles played since DAC_DMA_Init()
+unsigned long DAC_DMA_Cycles(void) {
+    return cycles;
+}
+
+
+// Number of times playback restarted after a gap
+unsigned long DAC_DMA_Underruns(void) {
+    return underruns;
+}
+
+
+// NOTE: This is meant to be implicitly overriden
+// Fires once per finished cycle (or block): refill the control structure that just finished while the other one plays
+void TIMER5A_Handler(void) {
+    // Clear the completion flag (CHIS is write-1-to-clear)
+    UDMA_CHIS_R = DAC_DMA_CHANNEL_BIT;
+
+    cycles++;
+
+    if ((UDMA_ENASET_R & DAC_DMA_CHANNEL_BIT) == 0) {
+        // Both halves ran out before this ran (the channel disables itself), so start over
+        underruns++;
+        DAC_DMA_Start_Channel();
+    } else if (UDMA_ALTSET_R & DAC_DMA_CHANNEL_BIT) {
+        // The alternate half is playing, so the primary one just finished
+        DAC_DMA_Load(UDMA_Get_Control(DAC_DMA_CHANNEL, 0), 0);
+    } else {
+        DAC_DMA_Load(UDMA_Get_Control(DAC_DMA_CHANNEL, 1), 1);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef MCU_DAC_DMA
+#define MCU_DAC_DMA
+
+#include <stdint.h>
+
+// Waveform playback on the 8-bit R-2R DAC without the core: Timer 5A requests a uDMA transfer every sample
+// period, which copies the next sample of a waveform table in RAM straight into the DAC's GPIO data register
+// - Runs in ping-pong mode, with the primary & alternate control structures each playing 1 full cycle of the
+//   table, so the core only steps in once per cycle (TIMER5A_Handler) to queue the next one
+// - A new table only takes over at a cycle boundary, so the output never shows a partial cycle
+// - Can also stream samples computed on the fly (DAC_DMA_Stream()), with the 2 halves playing 2 blocks of a
+//   buffer in turn while the handler has the block just played refilled
+// - Keeps running while the core sleeps, as long as Timer 5, the uDMA & the DAC port keep their clocks
+//
+// DAC port & pins (all 8, with the MSB on pin 7)
+#ifndef DAC_DMA_PORT
+#define DAC_DMA_PORT GPIO_PORT_B
+#endif
+
+#define DAC_DMA_PINS 0xFFu
+
+// Interrupt priority of TIMER5A_Handler (1 - 7, 0 = most urgent), which also bounds the critical sections of
+// this module (see Interrupt_Mask_Save()), so more urgent handlers never wait on them
+// NOTE: Overridable per project, i.e. via the C/C++ "Define" field in the Keil project options
+#ifndef DAC_DMA_PRIORITY
+#define DAC_DMA_PRIORITY 3
+#endif
+
+// uDMA channel 8, encoding 3 = Timer 5A (see Table 9-1 in the MCU datasheet)
+#define DAC_DMA_CHANNEL 8
+#define DAC_DMA_CHANNEL_ENCODING 3
+
+// Computes the next 'length' samples of a stream into 'block' (i.e. Mixer_Render, see "mixer.h")
+// NOTE: Called from TIMER5A_Handler, with the time the other block takes to play to finish
+typedef void (*DAC_DMA_Fill)(uint8_t *block, unsigned int length);
+
+
+// Setup Timer 5A & the uDMA channel for playing samples at 'sampleRateHz' (without starting)
+// NOTE: The DAC pins must be configured as outputs via GPIO_Init_Pins() beforehand
+extern void DAC_DMA_Init(uint32_t sysClockHz, uint32_t sampleRateHz);
+
+// Play 'length' samples (2 - UDMA_MAX_TRANSFERS) from 'table' over & over, right away if stopped, or else
+// from the end of the cycle in progress
+// NOTE: The table is read during playback, so it must stay unchanged until another one has taken over
+extern void DAC_DMA_Play(const uint8_t *table, unsigned int length);
+
+// Stream samples from 'fill', played from 2 blocks of 'blockLength' samples (2 - UDMA_MAX_TRANSFERS) in
+// 'buffer' (2 * blockLength bytes), right away if stopped, or else from the end of the cycle in progress
+// NOTE: A block counts as 1 cycle for DAC_DMA_Cycles(). Playing a table with DAC_DMA_Play() ends the stream.
+extern void DAC_DMA_Stream(uint8_t *buffer, unsigned int blockLength, DAC_DMA_Fill fill);
+
+// Stop playback right away, leaving the last sample on the DAC
+extern void DAC_DMA_Stop(void);
+
+// Number of full table cycles played since DAC_DMA_Init()
+extern unsigned long DAC_DMA_Cycles(void);
+
+// Number of times the handler didn't queue the next cycle in time, so playback restarted after a gap
+extern unsigned long DAC_DMA_Underruns(void);
+
+
+#endif /* MCU_DAC_DMA */
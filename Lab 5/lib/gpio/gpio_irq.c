@@ -0,0 +1,126 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "nvic/Interrupt.h"
+#include "gpio.h"
+#include "gpio_irq.h"
+
+// Interrupt number of each port (Ports A - E are contiguous, Port F comes much later)
+static const uint8_t GPIO_IRQ_NUMBERS[GPIO_PORT_COUNT] = {
+    GPIOA_IRQn, GPIOB_IRQn, GPIOC_IRQn, GPIOD_IRQn, GPIOE_IRQn, GPIOF_IRQn
+};
+
+// Callback of every pin, only changed with interrupts disabled
+static GPIO_Irq_Callback callbacks[GPIO_PORT_COUNT][8];
+
+
+// Call 'callback' on 'edges' of the given pins, then enable the port's interrupt at 'priority'
+void GPIO_Irq_Register(uint8_t port, uint8_t pins, uint8_t edges, GPIO_Irq_Callback callback,
+                       unsigned int priority) {
+    uint32_t primask;
+    unsigned int pin;
+
+    if (port >= GPIO_PORT_COUNT || callback == NULL)
+        return;
+
+    primask = Interrupt_Disable_Save();
+
+    // Edge sensitive, on both edges or only the selected one
+    GPIO_REG(port, GPIO_O_IS) &= ~pins;
+
+    if (edges == GPIO_IRQ_BOTH) {
+        GPIO_REG(port, GPIO_O_IBE) |= pins;
+    } else {
+        GPIO_REG(port, GPIO_O_IBE) &= ~pins;
+
+        if (edges & GPIO_IRQ_RISING)
+            GPIO_REG(port, GPIO_O_IEV) |= pins;
+        else
+            GPIO_REG(port, GPIO_O_IEV) &= ~pins;
+    }
+
+    for (pin = 0; pin < 8; pin++) {
+        if (pins & (1u << pin))
+            callbacks[port][pin] = callback;
+    }
+
+    // Drop edges seen during the setup, then unmask the pins
+    GPIO_REG(port, GPIO_O_ICR) = pins;
+    GPIO_REG(port, GPIO_O_IM) |= pins;
+
+    NVIC_SetPriorityIRQn(GPIO_IRQ_NUMBERS[port], (int) priority);
+    NVIC_EnableIRQn(GPIO_IRQ_NUMBERS[port]);
+
+    Interrupt_Restore(primask);
+}
+
+
+// Stop interrupting on the given pins
+void GPIO_Irq_Unregister(uint8_t port, uint8_t pins) {
+    uint32_t primask;
+    unsigned int pin;
+
+    if (port >= GPIO_PORT_COUNT)
+        return;
+
+    primask = Interrupt_Disable_Save();
+
+    GPIO_REG(port, GPIO_O_IM) &= ~pins;
+    GPIO_REG(port, GPIO_O_ICR) = pins;
+
+    for (pin = 0; pin < 8; pin++) {
+        if (pins & (1u << pin))
+            callbacks[port][pin] = NULL;
+    }
+
+    Interrupt_Restore(primask);
+}
+
+
+// Clear & dispatch every pending pin of 'port'
+// NOTE: Inlined into each handler with a constant 'port', so every register access is a fixed address
+static __inline void GPIO_Irq_Dispatch(uint8_t port) {
+    uint32_t pending = GPIO_REG(port, GPIO_O_MIS);
+    GPIO_Irq_Callback callback;
+    uint8_t pin;
+
+    // Only the bits written as 1 get cleared, so pins that weren't pending keep their flags
+    GPIO_REG(port, GPIO_O_ICR) = pending;
+
+    while (pending != 0) {
+        // Highest pending pin (31 - leading zeros), then drop its bit
+        pin = (uint8_t) (31 - __clz(pending));
+        pending &= ~(1UL << pin);
+
+        callback = callbacks[port][pin];
+        if (callback != NULL)
+            callback(port, pin);
+    }
+}
+
+
+// NOTE: These are meant to be implicitly overriden
+#if GPIO_IRQ_PORTS & (1u << GPIO_PORT_A)
+void GPIOA_Handler(void) { GPIO_Irq_Dispatch(GPIO_PORT_A); }
+#endif
+
+#if GPIO_IRQ_PORTS & (1u << GPIO_PORT_B)
+void GPIOB_Handler(void) { GPIO_Irq_Dispatch(GPIO_PORT_B); }
+#endif
+
+#if GPIO_IRQ_PORTS & (1u << GPIO_PORT_C)
+void GPIOC_Handler(void) { GPIO_Irq_Dispatch(GPIO_PORT_C); }
+#endif
+
+#if GPIO_IRQ_PORTS & (1u << GPIO_PORT_D)
+void GPIOD_Handler(void) { GPIO_Irq_Dispatch(GPIO_PORT_D); }
+#endif
+
+#if GPIO_IRQ_PORTS & (1u << GPIO_PORT_E)
+void GPIOE_Handler(void) { GPIO_Irq_Dispatch(GPIO_PORT_E); }
+#endif
+
+#if GPIO_IRQ_PORTS & (1u << GPIO_PORT_F)
+void GPIOF_Handler(void) { GPIO_Irq_Dispatch(GPIO_PORT_F); }
+#endif
@@ -0,0 +1,41 @@
+#ifndef MCU_GPIO_IRQ
+#define MCU_GPIO_IRQ
+
+#include <stdint.h>
+
+#include "gpio.h"
+
+// GPIO edge interrupts with 1 callback per pin, shared by every port
+// - Each port's handler reads its masked interrupt status (MIS) once, clears all of it with a single direct
+//   store to the write-1-to-clear ICR (no read-modify-write), then walks the set bits from the highest pin
+//   down with count-leading-zeros, calling the callback of each pin
+// - Flags are cleared before the callbacks run, so an edge arriving meanwhile pends the handler again
+//   instead of getting lost
+//
+// Ports whose handler (GPIOx_Handler) is defined by this module (bit n = port index n, i.e. 0x20 = Port F)
+// NOTE: Leave out ports that have their own handler elsewhere. Overridable per project, i.e. via the C/C++
+// "Define" field in the Keil project options.
+#ifndef GPIO_IRQ_PORTS
+#define GPIO_IRQ_PORTS 0x3Fu
+#endif
+
+// Edges to interrupt on
+#define GPIO_IRQ_FALLING    0x01u
+#define GPIO_IRQ_RISING     0x02u
+#define GPIO_IRQ_BOTH       (GPIO_IRQ_FALLING | GPIO_IRQ_RISING)
+
+// Called from the port's handler for an edge on pin 'pin' (0 - 7) of port 'port'
+typedef void (*GPIO_Irq_Callback)(uint8_t port, uint8_t pin);
+
+
+// Call 'callback' on 'edges' of the given pins (i.e. 0x11 = Px4 | Px0), then enable the port's interrupt at
+// 'priority' (0 - 7, shared by every pin of the port, so the last registration wins)
+// NOTE: The pins must be configured as inputs via GPIO_Init_Pins() beforehand
+extern void GPIO_Irq_Register(uint8_t port, uint8_t pins, uint8_t edges, GPIO_Irq_Callback callback,
+                              unsigned int priority);
+
+// Stop interrupting on the given pins (the port's interrupt stays enabled for any other pin)
+extern void GPIO_Irq_Unregister(uint8_t port, uint8_t pins);
+
+
+#endif /* MCU_GPIO_IRQ */
@@ -0,0 +1,204 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "latency.h"
+
+#ifdef __ARMCC_VERSION
+#include "mcu/tm4c123gh6pm.h"
+#include "nvic/Interrupt.h"
+
+// DWT control & cycle counter registers, and the trace enable bit of the debug control register (DEMCR, named
+// NVIC_DBG_INT_R by the MCU header), all missing from the MCU header
+#define DWT_CTRL_R              (*((volatile unsigned long *)0xE0001000))
+#define DWT_CYCCNT_R            (*((volatile unsigned long *)0xE0001004))
+#define DWT_CTRL_CYCCNTENA      0x00000001
+#define NVIC_DBG_INT_TRCENA     0x01000000
+
+// Samples get taken from interrupt handlers of any priority
+#define LATENCY_LOCK()          Interrupt_Disable_Save()
+#define LATENCY_UNLOCK(primask) Interrupt_Restore(primask)
+#define LATENCY_LEADING_ZEROS(x) __clz(x)
+#else
+// Host builds are single-threaded
+volatile uint32_t latencySimCycles = 0;
+
+#define LATENCY_LOCK()          0
+#define LATENCY_UNLOCK(primask) ((void) (primask))
+#define LATENCY_LEADING_ZEROS(x) ((unsigned int) __builtin_clz(x))
+#endif
+
+
+typedef struct {
+    Latency_Stats stats;
+    uint32_t last;      // Timestamp of the pending trigger (latency) or the last entry (jitter)
+    int pending;        // Set while 'last' is waiting to be paired with an entry
+} Latency_Channel;
+
+static Latency_Channel channels[LATENCY_MAX_CHANNELS];
+
+
+// Start the cycle counter & clear every channel
+void Latency_Init(void) {
+    #ifdef __ARMCC_VERSION
+        // The DWT only runs with trace enabled
+        NVIC_DBG_INT_R |= NVIC_DBG_INT_TRCENA;
+        DWT_CYCCNT_R = 0;
+        DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+    #endif
+
+    memset(channels, 0, sizeof(channels));
+}
+
+
+// Name 'channel' & clear its results, measuring latency or the jitter around 'periodCycles'
+void Latency_Setup_Channel(unsigned int channel, const char *name, uint32_t periodCycles) {
+    uint32_t primask;
+
+    if (channel >= LATENCY_MAX_CHANNELS)
+        return;
+
+    primask = LATENCY_LOCK();
+
+    memset(&channels[channel], 0, sizeof(channels[channel]));
+    channels[channel].stats.name = name;
+    channels[channel].stats.periodCycles = periodCycles;
+    channels[channel].stats.minCycles = 0xFFFFFFFF;
+
+    LATENCY_UNLOCK(primask);
+}
+
+
+// Record a trigger of 'channel' at 'timestamp'
+void Latency_Trigger_At(unsigned int channel, uint32_t timestamp) {
+    Latency_Channel *c;
+    uint32_t primask;
+
+    if (channel >= LATENCY_MAX_CHANNELS)
+        return;
+
+    c = &channels[channel];
+
+    primask = LATENCY_LOCK();
+
+    // The previous trigger never got to its handler (i.e. events merged or dropped on the way)
+    if (c->pending)
+        c->stats.missed++;
+
+    c->last = timestamp;
+    c->pending = 1;
+
+    LATENCY_UNLOCK(primask);
+}
+
+
+// Record a handler entry of 'channel' at 'timestamp', taking a sample
+void Latency_Enter_At(unsigned int channel, uint32_t timestamp) {
+    Latency_Channel *c;
+    uint32_t primask, sample;
+    unsigned int bucket;
+
+    if (channel >= LATENCY_MAX_CHANNELS)
+        return;
+
+    c = &channels[channel];
+
+    primask = LATENCY_LOCK();
+
+    if (!c->pending) {
+        // Latency channels need a trigger first, jitter channels a previous entry (which this becomes)
+        if (c->stats.periodCycles != 0) {
+            c->last = timestamp;
+            c->pending = 1;
+        }
+
+        LATENCY_UNLOCK(primask);
+        return;
+    }
+
+    // Unsigned subtraction, so the counter wrapping around in between doesn't matter
+    sample = timestamp - c->last;
+
+    if (c->stats.periodCycles == 0) {
+        c->pending = 0;
+    } else {
+        // Deviation from the period either way, with this entry starting the next period
+        sample = (sample > c->stats.periodCycles) ? sample - c->stats.periodCycles : c->stats.periodCycles - sample;
+        c->last = timestamp;
+    }
+
+    // Bucket = number of significant bits (0 -> 0, 1 -> 1, 2 - 3 -> 2, ...), clamped to the last one
+    bucket = (sample == 0) ? 0 : 32 - LATENCY_LEADING_ZEROS(sample);
+    if (bucket >= LATENCY_BUCKETS)
+        bucket = LATENCY_BUCKETS - 1;
+
+    c->stats.histogram[bucket]++;
+    c->stats.count++;
+    c->stats.totalCycles += sample;
+
+    if (sample < c->stats.minCycles)
+        c->stats.minCycles = sample;
+
+    if (sample > c->stats.maxCycles)
+        c->stats.maxCycles = sample;
+
+    LATENCY_UNLOCK(primask);
+}
+
+
+// Copy the results of 'channel' so far
+void Latency_Get(unsigned int channel, Latency_Stats *result) {
+    uint32_t primask;
+
+    if (channel >= LATENCY_MAX_CHANNELS)
+        return;
+
+    primask = LATENCY_LOCK();
+
+    *result = channels[channel].stats;
+
+    LATENCY_UNLOCK(primask);
+}
+
+
+// Write the results of every channel set up as lines of text with 'writeString'
+// NOTE: Only the summary gets copied with interrupts disabled (the whole Latency_Stats would take a big bite
+// out of the stack), so the buckets can be a few samples ahead of it
+void Latency_Write(unsigned int (*writeString)(const char *str)) {
+    const Latency_Stats *stats;
+    unsigned long count, missed, mean;
+    uint32_t primask, minCycles, maxCycles;
+    char line[96];
+    unsigned int channel, bucket;
+
+    for (channel = 0; channel < LATENCY_MAX_CHANNELS; channel++) {
+        stats = &channels[channel].stats;
+
+        if (stats->name == NULL)
+            continue;
+
+        primask = LATENCY_LOCK();
+
+        count = stats->count;
+        missed = stats->missed;
+        minCycles = count ? stats->minCycles : 0;
+        maxCycles = stats->maxCycles;
+        mean = count ? (unsigned long) (stats->totalCycles / count) : 0;
+
+        LATENCY_UNLOCK(primask);
+
+        sprintf(line, "latency,%.16s,%lu,%lu,%lu,%lu,%lu\r\n", stats->name, count, (unsigned long) minCycles, mean,
+                (unsigned long) maxCycles, missed);
+        writeString(line);
+
+        for (bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+            if (stats->histogram[bucket] == 0)
+                continue;
+
+            sprintf(line, "latency_bucket,%.16s,%lu,%lu\r\n", stats->name,
+                    (bucket == LATENCY_BUCKETS - 1) ? 0UL : (1UL << bucket) - 1, stats->histogram[bucket]);
+            writeString(line);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef MCU_LATENCY
+#define MCU_LATENCY
+
+#include <stdint.h>
+
+// Interrupt latency & jitter measurements, in system clock cycles
+// - Timestamps come from the cycle counter of the core's Data Watchpoint & Trace unit (DWT CYCCNT, wrapping
+//   after 2^32 cycles = ~86 s at 50 MHz), read with a single load, so taking one costs 1 - 2 cycles
+// - Each channel follows 1 interrupt (or event path), in 1 of 2 ways:
+//   - Latency: time from a trigger (LATENCY_TRIGGER(), i.e. where an event gets raised) to the handler entry
+//     (LATENCY_ENTER(), i.e. where it's finally acted on)
+//   - Jitter: deviation of the time between handler entries (LATENCY_ENTER() only) from the expected period
+// - Every sample lands in a power-of-2 histogram (bucket 0 = 0 cycles, bucket n = 2^(n-1) to 2^n - 1
+//   cycles, the last one taking everything above), next to the minimum, mean & worst case
+// - Host builds (no DWT) read a simulated cycle counter instead (latencySimCycles), advanced by the host code
+//
+// Example (how long a button press takes to get handled by an active object):
+//   Latency_Init();
+//   Latency_Setup_Channel(0, "button", 0);
+//   ... in the GPIO handler: LATENCY_TRIGGER(0); Active_Post(...);
+//   ... in the active object's handler: LATENCY_ENTER(0);
+//
+// Number of channels
+// NOTE: Overridable per project, i.e. via the C/C++ "Define" field in the Keil project options
+#ifndef LATENCY_MAX_CHANNELS
+#define LATENCY_MAX_CHANNELS 4
+#endif
+
+// Histogram buckets per channel (the last one covers 2^(LATENCY_BUCKETS - 2) cycles & above)
+#define LATENCY_BUCKETS 24
+
+// Current cycle count
+#ifdef __ARMCC_VERSION
+#define LATENCY_NOW() (*((volatile uint32_t *)0xE0001004))   // DWT CYCCNT (missing from the MCU header)
+#else
+extern volatile uint32_t latencySimCycles;
+#define LATENCY_NOW() (latencySimCycles)
+#endif
+
+// Stamp the trigger / handler entry of 'channel' right where this appears (the timestamp gets read before
+// the call, so the call itself isn't measured)
+#define LATENCY_TRIGGER(channel)    Latency_Trigger_At((channel), LATENCY_NOW())
+#define LATENCY_ENTER(channel)      Latency_Enter_At((channel), LATENCY_NOW())
+
+typedef struct {
+    const char *name;
+    uint32_t periodCycles;              // Expected time between entries (0 = latency channel)
+    unsigned long count;                // Samples taken
+    unsigned long missed;               // Latency: triggers overwritten before their entry, jitter: unused
+    uint32_t minCycles;
+    uint32_t maxCycles;                 // Worst case
+    uint64_t totalCycles;               // Sum of every sample (mean = totalCycles / count)
+    unsigned long histogram[LATENCY_BUCKETS];
+} Latency_Stats;
+
+
+// Start the cycle counter & clear every channel
+extern void Latency_Init(void);
+
+// Name 'channel' & clear its results, measuring latency ('periodCycles' = 0) or the jitter around a period of
+// 'periodCycles' (i.e. sysClockHz / rateHz)
+// NOTE: 'name' must stay around (i.e. a string literal), & is cut to 16 characters in reports
+extern void Latency_Setup_Channel(unsigned int channel, const char *name, uint32_t periodCycles);
+
+// Record a trigger of 'channel' at 'timestamp' (see LATENCY_TRIGGER())
+extern void Latency_Trigger_At(unsigned int channel, uint32_t timestamp);
+
+// Record a handler entry of 'channel' at 'timestamp', taking a sample (see LATENCY_ENTER())
+// NOTE: On latency channels, entries without a trigger since the last one are ignored
+extern void Latency_Enter_At(unsigned int channel, uint32_t timestamp);
+
+// Copy the results of 'channel' so far
+extern void Latency_Get(unsigned int channel, Latency_Stats *result);
+
+// Write the results of every channel set up as lines of text with 'writeString' (i.e. Uart_Write_String):
+// - "latency,<name>,<samples>,<min>,<mean>,<max>,<missed>" (cycles), then for every non-empty bucket
+// - "latency_bucket,<name>,<upper bound>,<samples>" (cycles, the last bucket's bound being 0 = none)
+extern void Latency_Write(unsigned int (*writeString)(const char *str));
+
+
+#endif /* MCU_LATENCY */
@@ -0,0 +1,179 @@
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "nvic/Interrupt.h"
+#include "mixer.h"
+
+// 4 signed byte adds at once: saturating (-128 - 127) or halving ((a + b) / 2, which can't overflow)
+#ifdef __ARMCC_VERSION
+#define MIXER_QADD8(a, b)   __qadd8((a), (b))
+#define MIXER_SHADD8(a, b)  __shadd8((a), (b))
+#else
+#define MIXER_QADD8(a, b)   Mixer_QAdd8((a), (b))
+#define MIXER_SHADD8(a, b)  Mixer_SHAdd8((a), (b))
+#endif
+
+// Flips the sign bit of every byte, turning signed samples (0 = silence) into DAC codes (128 = silence)
+#define MIXER_SIGNED_TO_DAC 0x80808080UL
+
+typedef struct {
+    int8_t wave[MIXER_WAVE_LENGTH];     // Scaled by the voice's gain (all 0 when silent)
+    uint32_t phase;                     // Position in the wave cycle, with 2^32 = 1 full cycle
+    uint32_t step;                      // Phase increment per sample (0 when silent)
+} Mixer_Voice;
+
+// Read by Mixer_Render() from TIMER5A_Handler
+static Mixer_Voice voices[MIXER_MAX_VOICES];
+static uint32_t mixerSampleRateHz;
+static volatile int mixerMode = MIXER_SATURATE;
+
+
+#ifndef __ARMCC_VERSION
+// Plain C versions of the SIMD instructions, for host builds
+static uint32_t Mixer_QAdd8(uint32_t a, uint32_t b) {
+    uint32_t result = 0;
+    int sum;
+    unsigned int i;
+
+    for (i = 0; i < 32; i += 8) {
+        sum = (int8_t) (a >> i) + (int8_t) (b >> i);
+
+        if (sum > 127)
+            sum = 127;
+        else if (sum < -128)
+            sum = -128;
+
+        result |= (uint32_t) (uint8_t) sum << i;
+    }
+
+    return result;
+}
+
+
+static uint32_t Mixer_SHAdd8(uint32_t a, uint32_t b) {
+    uint32_t result = 0;
+    int sum;
+    unsigned int i;
+
+    for (i = 0; i < 32; i += 8) {
+        sum = (int8_t) (a >> i) + (int8_t) (b >> i);
+
+        // Arithmetic shift, rounding towards -infinity like the instruction
+        sum = (sum >= 0) ? (sum / 2) : -((1 - sum) / 2);
+
+        result |= (uint32_t) (uint8_t) sum << i;
+    }
+
+    return result;
+}
+#endif
+
+
+// Step 'voice' through its next 4 samples, packed into 1 word (the first sample in the lowest byte)
+static __inline uint32_t Mixer_Voice_Word(Mixer_Voice *voice) {
+    uint32_t phase = voice->phase, step = voice->step, word;
+
+    word = (uint8_t) voice->wave[phase >> 24];
+    phase += step;
+    word |= (uint32_t) (uint8_t) voice->wave[phase >> 24] << 8;
+    phase += step;
+    word |= (uint32_t) (uint8_t) voice->wave[phase >> 24] << 16;
+    phase += step;
+    word |= (uint32_t) (uint8_t) voice->wave[phase >> 24] << 24;
+
+    voice->phase = phase + step;
+    return word;
+}
+
+
+// Silence every voice & mix with MIXER_SATURATE, at 'sampleRateHz' samples per second
+void Mixer_Init(uint32_t sampleRateHz) {
+    uint32_t primask = Interrupt_Disable_Save();
+
+    memset(voices, 0, sizeof(voices));
+    mixerSampleRateHz = sampleRateHz;
+    mixerMode = MIXER_SATURATE;
+
+    Interrupt_Restore(primask);
+}
+
+
+// Fill 'wave' with 1 full-scale sine cycle
+void Mixer_Build_Sine(int8_t *wave) {
+    unsigned int i;
+
+    for (i = 0; i < MIXER_WAVE_LENGTH; i++)
+        wave[i] = (int8_t) floorf(127.0f * sinf(2 * 3.14159265f * i / MIXER_WAVE_LENGTH) + 0.5f);
+}
+
+
+// Play 'wave' on 'voice' at 'frequencyHz' & 'gain'
+int Mixer_Set_Voice(unsigned int voice, const int8_t *wave, uint32_t frequencyHz, uint8_t gain) {
+    unsigned int i;
+
+    if (voice >= MIXER_MAX_VOICES || frequencyHz >= mixerSampleRateHz / 2)
+        return 0;
+
+    // Scale straight into the voice (the stack is too small for a copy), so a block rendered meanwhile may mix
+    // the old & new wave, like a gain change half way through a cycle
+    for (i = 0; i < MIXER_WAVE_LENGTH; i++)
+        voices[voice].wave[i] = (int8_t) (wave[i] * gain / 255);
+
+    // frequency / sample rate of a cycle per sample, in 2^32 phase units (a single store, so no locking needed)
+    voices[voice].step = (uint32_t) (((uint64_t) frequencyHz << 32) / mixerSampleRateHz);
+    return 1;
+}
+
+
+// Silence 'voice'
+void Mixer_Stop_Voice(unsigned int voice) {
+    uint32_t primask;
+
+    if (voice >= MIXER_MAX_VOICES)
+        return;
+
+    primask = Interrupt_Disable_Save();
+
+    memset(voices[voice].wave, 0, sizeof(voices[voice].wave));
+    voices[voice].step = 0;
+
+    Interrupt_Restore(primask);
+}
+
+
+// Sum the voices with MIXER_SATURATE or MIXER_AVERAGE
+void Mixer_Set_Mode(int mode) {
+    mixerMode = mode;
+}
+
+
+// Render the next 'length' samples of the mix as DAC codes into 'block'
+// NOTE: Silent voices get summed as well (as 0), so every block takes the same time
+void Mixer_Render(uint8_t *block, unsigned int length) {
+    uint32_t *out = (uint32_t *) block;
+    uint32_t mix, v0, v1, v2, v3;
+    unsigned int i;
+    int average = (mixerMode == MIXER_AVERAGE);
+
+    for (i = 0; i < length / 4; i++) {
+        v0 = Mixer_Voice_Word(&voices[0]);
+        v1 = Mixer_Voice_Word(&voices[1]);
+        v2 = Mixer_Voice_Word(&voices[2]);
+        v3 = Mixer_Voice_Word(&voices[3]);
+
+        if (average)
+            mix = MIXER_SHADD8(MIXER_SHADD8(v0, v1), MIXER_SHADD8(v2, v3));
+        else
+            mix = MIXER_QADD8(MIXER_QADD8(v0, v1), MIXER_QADD8(v2, v3));
+
+        mix ^= MIXER_SIGNED_TO_DAC;
+
+        #if MIXER_HALF_SCALE
+            // Halve every byte at once, masking off the bits shifted in from the byte above
+            mix = (mix >> 1) & 0x7F7F7F7FUL;
+        #endif
+
+        out[i] = mix;
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef MCU_MIXER
+#define MCU_MIXER
+
+#include <stdint.h>
+
+// Polyphonic waveform mixer: sums up to MIXER_MAX_VOICES voices, each a wave cycle stepped through by its own
+// phase accumulator (any frequency below half the sample rate), into a stream of DAC codes
+// - Meant to be streamed by the uDMA, i.e. DAC_DMA_Stream(buffer, length, Mixer_Render) (see "dac_dma.h")
+// - Gains get applied to a voice's own copy of its wave when it's set, so rendering needs no multiplications
+// - Renders 4 samples at a time, packed into 1 word per voice & summed with the M4's SIMD instructions (QADD8
+//   or SHADD8, 4 saturating / halving byte adds in 1 cycle), falling back to plain C when built for a host
+//
+// Example (a 2-tone test signal at 64 kHz):
+//   Mixer_Init(64000);
+//   Mixer_Build_Sine(sine);
+//   Mixer_Set_Voice(0, sine, 1000, 255);
+//   Mixer_Set_Voice(1, sine, 1500, 128);
+//   DAC_DMA_Stream(buffer, 256, Mixer_Render);
+//
+// Number of voices (the SHADD8 mix, see MIXER_AVERAGE, takes exactly 4)
+#define MIXER_MAX_VOICES 4
+
+// Samples per wave cycle, indexed by the top 8 bits of the phase accumulators
+#define MIXER_WAVE_LENGTH 256
+
+// How voices get summed
+#define MIXER_SATURATE 0    // At full scale, clipping at the rails (QADD8)
+#define MIXER_AVERAGE  1    // At a quarter scale each, never clipping (SHADD8 in pairs)
+
+// Halve the output range to 0 - 127, leaving the DAC's upper half unused (see the DAC clipping note in main.c)
+// NOTE: Overridable per project, i.e. via the C/C++ "Define" field in the Keil project options
+#ifndef MIXER_HALF_SCALE
+#define MIXER_HALF_SCALE 1
+#endif
+
+
+// Silence every voice & mix with MIXER_SATURATE, at 'sampleRateHz' samples per second
+extern void Mixer_Init(uint32_t sampleRateHz);
+
+// Fill 'wave' with 1 full-scale (-127 - 127) sine cycle of MIXER_WAVE_LENGTH samples
+extern void Mixer_Build_Sine(int8_t *wave);
+
+// Play 'wave' (MIXER_WAVE_LENGTH signed samples) on 'voice' at 'frequencyHz' & 'gain' (0 - 255 = 0 - 1),
+// returning 0 if the voice doesn't exist or the frequency isn't below half the sample rate
+// NOTE: The wave gets copied, so it doesn't need to stay around. The voice keeps its phase, so changing its
+// frequency or gain doesn't make the output jump.
+extern int Mixer_Set_Voice(unsigned int voice, const int8_t *wave, uint32_t frequencyHz, uint8_t gain);
+
+// Silence 'voice'
+extern void Mixer_Stop_Voice(unsigned int voice);
+
+// Sum the voices with MIXER_SATURATE or MIXER_AVERAGE
+extern void Mixer_Set_Mode(int mode);
+
+// Render the next 'length' samples (a multiple of 4) of the mix as DAC codes (silence = 128, or 64 with
+// MIXER_HALF_SCALE) into 'block' (4-byte aligned), a DAC_DMA_Fill
+extern void Mixer_Render(uint8_t *block, unsigned int length);
+
+
+#endif /* MCU_MIXER */
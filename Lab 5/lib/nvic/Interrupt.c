@@ -3,93 +3,69 @@
 #include "mcu/tm4c123gh6pm.h"
 #include "Interrupt.h"
 
-// Array for holding list of interrupt enable registers
-volatile unsigned long *const NVIC_ENABLE_REG[5] = {
-    &NVIC_EN0_R,
-    &NVIC_EN1_R,
-    &NVIC_EN2_R,
-    &NVIC_EN3_R,
-    &NVIC_EN4_R,
-};
-
-
-// Array for holding list of interrupt priority registers
-volatile unsigned long *const NVIC_PRIORITY_REG[35] = {
-    &NVIC_PRI0_R,
-    &NVIC_PRI1_R,
-    &NVIC_PRI2_R,
-    &NVIC_PRI3_R,
-    &NVIC_PRI4_R,
-    &NVIC_PRI5_R,
-    &NVIC_PRI6_R,
-    &NVIC_PRI7_R,
-    &NVIC_PRI8_R,
-    &NVIC_PRI9_R,
-    &NVIC_PRI10_R,
-    &NVIC_PRI11_R,
-    &NVIC_PRI12_R,
-    &NVIC_PRI13_R,
-    &NVIC_PRI14_R,
-    &NVIC_PRI15_R,
-    &NVIC_PRI16_R,
-    &NVIC_PRI17_R,
-    &NVIC_PRI18_R,
-    &NVIC_PRI19_R,
-    &NVIC_PRI20_R,
-    &NVIC_PRI21_R,
-    &NVIC_PRI22_R,
-    &NVIC_PRI23_R,
-    &NVIC_PRI24_R,
-    &NVIC_PRI25_R,
-    &NVIC_PRI26_R,
-    &NVIC_PRI27_R,
-    &NVIC_PRI28_R,
-    &NVIC_PRI29_R,
-    &NVIC_PRI30_R,
-    &NVIC_PRI31_R,
-    &NVIC_PRI32_R,
-    &NVIC_PRI33_R,
-    &NVIC_PRI34_R,
-};
-
 // Sources:
 // * Register mapping: pg. 134 - 137 of datasheet (https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf)
 // * Priority bit field locations: pg. 152 of datasheet (https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf)
 // * Formula calculations: https://www.airsupplylab.com/ti-tiva-series/tiva_lesson-14-interrupt.html
+//
+// NOTE: Prefer the NVIC_*_IRQ() macros in "Interrupt.h" whenever the interrupt number is a constant,
+// since these functions exist only for the case where it is computed at run-time.
 
 
 // Enable the specified interrupt (number)
-//   This works by finding the specified "interrupt enable register" and setting
-//   the specific bit, with a interrupt number limit between 0 and 138.
+//   This works by writing the specific bit to the "interrupt enable register" holding it,
+//   with a interrupt number limit between 0 and 138. Enable register index: i = n >> 5 (same
+//   as i = n // 32), bit index: b = n & 0x1F (same as b = n % 32).
 void NVIC_EnableIRQn(int IRQn) {
-    // Enable register index: i = n >> 5 (same as i = n // 32)
-    uint32_t idxEnableRegister = IRQn >> 5;
+    NVIC_ENABLE_IRQ(IRQn);
+}
+
+
+// Disable the specified interrupt (number)
+//   Same indexing as above, but through the "interrupt clear enable registers".
+void NVIC_DisableIRQn(int IRQn) {
+    NVIC_DISABLE_IRQ(IRQn);
+}
 
-    // Bit index: bit field = 1 << b, where b = 0 to 31 (same as b = n % 32)
-    uint32_t bitIndex = IRQn & 0x1F;
 
-    // Enable the target interrupt via the interrupt number within
-    *NVIC_ENABLE_REG[idxEnableRegister] |= (1 << bitIndex);
+// Force the specified interrupt (number) into the pending state
+//   Same indexing as above, but through the "interrupt set pending registers".
+void NVIC_SetPendingIRQn(int IRQn) {
+    NVIC_SET_PENDING_IRQ(IRQn);
+}
+
+
+// Remove the pending state of the specified interrupt (number)
+//   Same indexing as above, but through the "interrupt clear pending registers".
+void NVIC_ClearPendingIRQn(int IRQn) {
+    NVIC_CLEAR_PENDING_IRQ(IRQn);
 }
 
 
 // Set the priority for the specified interrupt (number)
-//   This works by finding the "interrupt priority register" and setting the priority
-//   via a 3-bit field section, with the lowest priority being 0 and highest being 7.
+//   This works by storing the priority into the interrupt's own byte of the "interrupt priority
+//   registers", with the highest priority being 0 and lowest being 7. Only bits[7:5] of the byte are
+//   implemented, so the byte store replaces the old priority without touching the 3 other
+//   interrupts sharing the same 32-bit register (byte address: 0xE000E400 + n).
 void NVIC_SetPriorityIRQn(int IRQn, int priority) {
-    // Priority register index: i = n >> 2 (same as i = n // 4)
-    uint32_t idxPriorityRegister = IRQn >> 2;
+    NVIC_SET_PRIORITY(IRQn, priority);
+}
+
 
-    // Register 3-bit section: s = 5 + 8 * p, where p = 0 to 3 (same as p = n % 4)
-    // * Section 0 = bits[ 7: 5] (5 + 8 * 0 => 5)
-    // * Section 1 = bits[15:13] (5 + 8 * 1 => 13)
-    // * Section 2 = bits[23:21] (5 + 8 * 2 => 21)
-    // * Section 3 = bits[31:29] (5 + 8 * 3 => 29)
-    uint32_t p = IRQn & 0x3U;
+// Split the 3 priority bits into 'preemptBits' upper bits of group priority & the rest as subpriority
+//   PRIGROUP (bits[10:8] of the "application interrupt & reset control register") is the bit position
+//   where the group priority ends: bits[7:PRIGROUP+1] are the group priority & the bits below it the
+//   subpriority. With only bits[7:5] implemented, PRIGROUP = 7 - preemptBits (4 and below all give 3
+//   group priority bits). The register ignores every write without the vector key in its upper half,
+//   & every other writable bit requests a reset, so a plain store of the key & the field is enough.
+void NVIC_SetPriorityGrouping(int preemptBits) {
+    uint32_t group;
 
-    // Clear the previously set priority in the 3-bit section for the target interrupt
-    *NVIC_PRIORITY_REG[idxPriorityRegister] &= ~(0xFF << (8 * p));
+    if (preemptBits < 0)
+        preemptBits = 0;
+    else if (preemptBits > 3)
+        preemptBits = 3;
 
-    // Save the new priority in the same 3-bit section for the target interrupt
-    *NVIC_PRIORITY_REG[idxPriorityRegister] |= (priority << (5 + 8 * p));
+    group = (uint32_t) (7 - preemptBits) << 8;
+    NVIC_APINT_R = NVIC_APINT_VECTKEY | group;
 }
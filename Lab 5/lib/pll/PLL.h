@@ -37,8 +37,26 @@
 #define SYSDIV2_3_125_Mhz 127
 
 
+// System clock frequency (in Hz) given by a SYSDIV2 divisor
+#define PLL_SYSDIV2_TO_HZ(sysdiv2_divisor) (400000000UL / ((unsigned long) (sysdiv2_divisor) + 1))
+
+// Fastest system clock allowed (see Table 5-6 in the MCU datasheet)
+#define PLL_SYSDIV2_MIN SYSDIV2_80_00_Mhz
+
+
 // Configure the system to get its clock from the PLL
 extern int PLL_Init(uint8_t sysdiv2_divisor);
 
+// Same as PLL_Init(), split in 2 halves so other setup can overlap the PLL lock time:
+// - PLL_Start() powers up the PLL & returns right away, with the system running off the 16 MHz crystal
+// - PLL_Wait_Lock() waits until the PLL is locked, then switches the system clock over to it
+extern void PLL_Start(uint8_t sysdiv2_divisor);
+extern void PLL_Wait_Lock(void);
+
+// Switch the system clock to another SYSDIV2 divisor at run-time, returning -1 if it's faster than 80 MHz
+// NOTE: PLL_Init() must have been called beforehand. The PLL stays locked, so this takes a handful of cycles
+// instead of waiting for a re-lock, but anything timed off the system clock has to be rescaled afterwards
+extern int PLL_Set_Divisor(uint8_t sysdiv2_divisor);
+
 
 #endif /* MCU_PLL */
@@ -0,0 +1,38 @@
+#include <stdint.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "udma.h"
+
+// Control table: primary control structures of every channel, followed by the alternate ones
+// NOTE: The controller requires the table to start on a 1024-byte boundary (ARMCC supports the GNU attribute)
+static UDMA_Control controlTable[2 * UDMA_CHANNEL_COUNT] __attribute__((aligned(1024)));
+
+
+// Enable the uDMA controller & point it at the control table
+void UDMA_Init(void) {
+    // Enable clock for the uDMA controller
+    SYSCTL_RCGCDMA_R |= SYSCTL_RCGCDMA_R0;
+
+    // Wait until the uDMA clock is fully initialized
+    while ((SYSCTL_PRDMA_R & SYSCTL_PRDMA_R0) == 0);
+
+    // Enable the controller & set the base address of the control table
+    UDMA_CFG_R = UDMA_CFG_MASTEN;
+    UDMA_CTLBASE_R = (unsigned long) controlTable;
+}
+
+
+// Route 'channel' to the peripheral with 'encoding'
+// NOTE: Each CHMAPn register holds 8 channels, 4 bits per channel
+void UDMA_Assign_Channel(unsigned int channel, unsigned int encoding) {
+    volatile unsigned long *chmap = &UDMA_CHMAP0_R + (channel >> 3);
+    unsigned int shift = (channel & 7) * 4;
+
+    *chmap = (*chmap & ~(0xFUL << shift)) | ((unsigned long) encoding << shift);
+}
+
+
+// Primary (alternate = 0) or alternate (alternate = 1) control structure of 'channel'
+UDMA_Control *UDMA_Get_Control(unsigned int channel, int alternate) {
+    return &controlTable[(alternate ? UDMA_CHANNEL_COUNT : 0) + channel];
+}
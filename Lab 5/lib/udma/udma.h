@@ -0,0 +1,42 @@
+#ifndef MCU_UDMA
+#define MCU_UDMA
+
+#include <stdint.h>
+
+// Micro direct memory access (uDMA) controller: moves data between memory & peripherals on its own, with the
+// core only getting involved once a whole block is done (Chapter 9 of the MCU datasheet)
+// - Each of the 32 channels is described by a primary & an alternate control structure in the control table,
+//   which the controller reads from RAM (so both can be rewritten while the other one is running)
+// - Most channels are shared by up to 5 peripherals, picked by the channel's encoding (see Table 9-1)
+
+// Number of channels
+#define UDMA_CHANNEL_COUNT 32
+
+// 1 control structure of the control table
+typedef struct {
+    volatile const void *srcEnd;    // Address of the last source item
+    volatile void *dstEnd;          // Address of the last destination item
+    volatile uint32_t control;      // UDMA_CHCTL_* flags & transfer size
+    uint32_t unused;
+} UDMA_Control;
+
+// Control word for 'count' transfers (1 - 1024) with the given UDMA_CHCTL_* flags
+#define UDMA_CONTROL_WORD(flags, count) ((flags) | (((uint32_t) (count) - 1) << UDMA_CHCTL_XFERSIZE_S))
+
+// Maximum number of transfers per control structure
+#define UDMA_MAX_TRANSFERS 1024
+
+
+// Enable the uDMA controller & point it at the control table
+// NOTE: Safe to call more than once (i.e. by every driver using a channel)
+extern void UDMA_Init(void);
+
+// Route 'channel' to the peripheral with 'encoding' (see Table 9-1 in the MCU datasheet)
+// NOTE: The channel must be disabled
+extern void UDMA_Assign_Channel(unsigned int channel, unsigned int encoding);
+
+// Primary (alternate = 0) or alternate (alternate = 1) control structure of 'channel'
+extern UDMA_Control *UDMA_Get_Control(unsigned int channel, int alternate);
+
+
+#endif /* MCU_UDMA */
@@ -13,12 +13,24 @@
  */
 
 #include <stdint.h>
+#include <stddef.h>
 #include <math.h>
 
 #include "lib/mcu/tm4c123gh6pm.h"
 #include "lib/pll/PLL.h"
 #include "lib/systick/SysTick.h"
+#include "lib/power/power.h"
 #include "lib/nvic/Interrupt.h"
+#include "lib/gpio/gpio.h"
+#include "lib/gpio/gpio_irq.h"
+#include "lib/mempool/mempool.h"
+#include "lib/active/active.h"
+#include "lib/dac/dac_dma.h"
+#include "lib/uart/uart.h"
+#include "lib/awg/awg.h"
+#include "lib/mixer/mixer.h"
+#include "lib/latency/latency.h"
+#include "lib/budget/budget.h"
 
 // Task pin definitions
 #define INPUT_BUTTON_PINS	0x11u // = 0x10 (PF4) | 0x01 (PF0)
@@ -26,17 +38,106 @@
 
 // Debug flags
 #define TEST_DAC_OUTPUTS 0  // Controls if the DEBUG stair voltage waveform is to be generated (see relevant function for more info)
+#define BENCHMARK_GPIO_THROUGHPUT 0  // Controls if the DEBUG GPIO throughput benchmark is run on startup (see relevant function for more info)
+#define DAC_DMA_OUTPUT 1  // Controls if the waveforms are played from tables by the uDMA instead of being computed every tick, with more tables loadable over UART (see "dac_dma.h" & "awg.h")
+#define MIXER_OUTPUT 0  // Controls if a multi-tone test signal mixed from several voices is streamed by the uDMA instead of the tables being played (needs DAC_DMA_OUTPUT, see "mixer.h")
+#define MEASURE_LATENCY 0  // Controls if the button to output mode latency & the DAC sample jitter get measured (see "latency.h")
+#define CHECK_ISR_BUDGETS 0  // Controls if every interrupt handler gets timed against its execution-time budget, counting overruns (see "budget.h")
+#define BREAK_ON_ISR_OVERRUN 0  // Controls if the debugger stops right after any handler overruns its budget (needs CHECK_ISR_BUDGETS & a debugger attached)
+
+#if MIXER_OUTPUT && !DAC_DMA_OUTPUT
+    #error "MIXER_OUTPUT streams through the uDMA, so it needs DAC_DMA_OUTPUT set to 1"
+#endif
 
 // Constant definitions
 #define SAWTOOTH_PERIOD 256
 #define SINE_PERIOD 60
+#define STAIR_PERIOD 480
+#define BENCHMARK_ITERATIONS 1000
+
+// Active objects (see "active.h"), ticking every 1 ms
+#define SYS_CLOCK_HZ 50000000UL
+#define ACTIVE_TICK_HZ 1000UL
+#define WAVEFORM_PRIORITY 0
+#define WAVEFORM_QUEUE_CAPACITY 8
+
+// DAC sample rate when played by the uDMA, matching the 1 ms ticks by default
+// NOTE: Raise for higher frequency output, since no sample involves the core (i.e. 256 kHz plays the sawtooth
+// at 1 kHz). The uDMA keeps up well into the hundreds of kHz.
+#if MIXER_OUTPUT
+    #define DAC_SAMPLE_RATE_HZ 64000UL
+#else
+    #define DAC_SAMPLE_RATE_HZ 1000UL
+#endif
+
+// Samples per block streamed from the mixer (4 ms at 64 kHz, of which rendering takes about 2%)
+#define MIXER_BLOCK_LENGTH 256
+
+// Baud rate of the waveform table commands (see "awg.h")
+#define UART_BAUD_RATE 115200UL
+
+// Time between updates of the sleep vs. active statistics when the DAC is played by the uDMA (in ms)
+#define POWER_STATS_PERIOD_MS 3840
+
+// Interrupt priority map (0 = most urgent, 7 = least urgent), checked at compile-time below:
+// - 3: Timer 5A, queuing the next DAC table cycle / mixer block for the uDMA (DAC_DMA_PRIORITY, "dac_dma.h")
+// - 5: UART 0, moving bytes between the FIFOs & the buffers (UART_PRIORITY, "uart.h")
+// - 5: Port F, the button presses (BUTTON_PRIORITY, below)
+// - 6: Timer 2A, the event framework tick (ACTIVE_TICK_PRIORITY, "active.h")
+// - 7: PendSV, running the active objects
+// The event framework's critical sections (posting events, see "Interrupt.h") only mask levels 5 - 7, as set by
+// INTERRUPT_FRAMEWORK_PRIORITY=5 in the C/C++ "Define" field of the Keil project options, so the DAC keeps
+// getting fed during the bookkeeping of the buttons, the UART & the ticks
+// NOTE: All 3 priority bits are used for preemption (no subpriorities)
+#define BUTTON_PRIORITY 5
+#define PRIORITY_PREEMPT_BITS 3
+
+// Execution-time budget of each interrupt handler (in system clock cycles, see "budget.h"), at about twice the
+// expected worst case
+// NOTE: The mixer renders a 256 sample block in ~4000 cycles, every other handler only moves a few bytes or
+// posts an event. The dispatcher (PendSV) only has a budget when it computes the samples (1 per tick), since
+// the uDMA doesn't depend on it otherwise. SysTick only interrupts (counting its wrap-arounds, see "SysTick.c")
+// once SysTick_Init() has run, i.e. for the GPIO benchmark.
+#define BUDGET_DAC_CYCLES 8000
+#define BUDGET_UART_CYCLES 1000
+#define BUDGET_BUTTON_CYCLES 500
+#define BUDGET_TICK_CYCLES 500
+#define BUDGET_DISPATCH_CYCLES 2000
+#define BUDGET_SYSTICK_CYCLES 100
+
+// Only handlers at or below the framework level may post events, & the DAC must stay above all of them
+INTERRUPT_STATIC_ASSERT(Button_Priority_Must_Allow_Posting, BUTTON_PRIORITY >= INTERRUPT_FRAMEWORK_PRIORITY);
+INTERRUPT_STATIC_ASSERT(Uart_Priority_Must_Allow_Posting, UART_PRIORITY >= INTERRUPT_FRAMEWORK_PRIORITY);
+INTERRUPT_STATIC_ASSERT(Tick_Priority_Must_Allow_Posting, ACTIVE_TICK_PRIORITY >= INTERRUPT_FRAMEWORK_PRIORITY);
+INTERRUPT_STATIC_ASSERT(Dac_Must_Preempt_Framework, DAC_DMA_PRIORITY < INTERRUPT_FRAMEWORK_PRIORITY);
+
+// Waveform active object signals
+#define WAVEFORM_SIGNAL_TICK (ACTIVE_SIGNAL_USER + 0)    // Time for the next DAC update
+#define WAVEFORM_SIGNAL_MODE (ACTIVE_SIGNAL_USER + 1)    // Output mode change, 'param' = new mode
+#define WAVEFORM_SIGNAL_SERIAL (ACTIVE_SIGNAL_USER + 2)  // Waveform table commands received over UART
+
+// Latency measurement channels (see "latency.h")
+#define LATENCY_CHANNEL_BUTTON 0    // Button press (GPIOF_Handler) to the output mode changing
+#define LATENCY_CHANNEL_SAMPLE 1    // Jitter of the DAC sample writes, 1 per tick (only computed waveforms)
 
 
 // Function Declarations
-void Setup_Port_B_Pins(void);
-void Setup_Port_F_Pins(void);
+void Setup_GPIO_Pins(void);
+void Setup_Port_F_Interrupts(void);
 void Setup_Global_Interrupts(void);
-void SysTick_Wait_1ms(uint32_t delay);
+void Button_Pressed(uint8_t port, uint8_t pin);
+void Waveform_Handler(Active *self, const Active_Event *event);
+void Waveform_DMA_Handler(Active *self, const Active_Event *event);
+void Build_Waveform_Tables(void);
+void Setup_Mixer_Voices(void);
+void Serial_Rx_Ready(void);
+void Setup_Latency_Measurements(void);
+void Update_Latency_Results(void);
+void Setup_ISR_Budgets(void);
+void Update_ISR_Budget_Results(void);
+void ISR_Overrun(const Budget_Stats *stats);
+
+void DEBUG_Benchmark_GPIO_Throughput(void);
 
 uint8_t DEBUG_Generate_Stair_Voltage_Waveform_Tick(int tick);
 uint8_t Generate_Sawtooth_Waveform_Tick(int tick);
@@ -48,9 +149,62 @@ uint8_t Generate_Sine_Waveform_Tick(int tick);
 //////////////////////
 
 
-// NOTE: Declaring a global variable 'volatile' flags it to the compiler that this variable
-// may be changed outside the obviously defined program flow (useful for interrupt handling).
-volatile int outputMode = 0;
+// Waveform generator active object, fed output mode changes by Button_Pressed() & ticks by its timer
+Active waveform;
+static Active_Event waveformQueue[WAVEFORM_QUEUE_CAPACITY];
+static Active_Timer waveformTimer;
+
+// Waveform generated 1 sample per tick, with 1 cycle lasting 'period' ticks (no 'generate' function = 0 V)
+typedef struct {
+    uint8_t (*generate)(int tick);
+    int period;
+} Waveform;
+
+// Waveform of each output mode (0 = off, 1 = SW1, 2 = SW2) & the DEBUG stair voltage waveform
+const Waveform OUTPUT_WAVEFORMS[] = {
+    {NULL,                                      1},
+    {Generate_Sawtooth_Waveform_Tick,           SAWTOOTH_PERIOD},
+    {Generate_Sine_Waveform_Tick,               SINE_PERIOD}
+};
+const Waveform STAIR_WAVEFORM = {DEBUG_Generate_Stair_Voltage_Waveform_Tick, STAIR_PERIOD};
+
+// State of the waveform generator, with the waveform double-buffered: mode changes only queue the next one,
+// which takes over at the start of the playing one's next cycle (so no partial cycles are played)
+// NOTE: Only the cycle starts line up, not the output levels (i.e. the sine starts at mid-scale but the sawtooth
+// at 0), so a mode change still steps the output once, just never in the middle of a cycle
+// NOTE: Only touched by the waveform handlers, so these need neither 'volatile' nor disabling interrupts
+int outputMode = 0;
+int waveformTick = 0;
+int waveformPhase = 0;  // Tick within the cycle of the playing waveform
+const Waveform *playingWaveform = &OUTPUT_WAVEFORMS[0];
+const Waveform *queuedWaveform = &OUTPUT_WAVEFORMS[0];
+
+// Blocks streamed from the mixer (as words, since it renders 4 samples per store) & the wave of its voices
+static uint32_t mixerBuffer[2 * MIXER_BLOCK_LENGTH / 4];
+static int8_t mixerSine[MIXER_WAVE_LENGTH];
+
+// Set once received bytes are waiting for the waveform generator, so only 1 event gets posted for them
+static volatile int serialPending = 0;
+
+// Results of the DEBUG GPIO throughput benchmark (in system clock cycles per operation, inspect via debugger)
+volatile uint32_t benchmarkToggleCycles = 0;
+volatile uint32_t benchmarkDacWriteCycles = 0;
+
+// Time spent sleeping vs. active & the resulting average supply current, updated every 3840 ms (inspect via debugger)
+Power_Stats powerStats;
+volatile unsigned long powerAverageCurrent_uA = 0;
+
+// Latency & jitter results in system clock cycles, updated along with the statistics above (inspect via debugger)
+// NOTE: Also written over UART (see Latency_Write()) when the DAC is played by the uDMA
+Latency_Stats buttonLatency;
+Latency_Stats sampleJitter;
+
+// Execution time & overruns of every interrupt handler, updated along with the statistics above, and the last
+// handler to overrun its budget (inspect via debugger)
+// NOTE: Also written over UART (see Budget_Write()) when the DAC is played by the uDMA
+Budget_Stats isrBudgets[BUDGET_MAX_HANDLERS];
+volatile unsigned long isrOverruns = 0;
+const char *volatile lastOverrunIsr = NULL;
 
 
 //////////////////////////
@@ -58,91 +212,26 @@ volatile int outputMode = 0;
 //////////////////////////
 
 
-void Setup_Port_B_Pins(void) {
-    // Enable Port B clock
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R1;
-
-    // Wait until Port B clock is fully initialized
-    while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R1) == 0);
-
-    // Unlock Port B configuration
-    GPIO_PORTB_LOCK_R = GPIO_LOCK_KEY;
-
-    // Set commit register to only work with pins PB0 - PB7
-    GPIO_PORTB_CR_R = OUTPUT_DAC_PIN;
-
-    // Set DAC output pins (PB0 - PB7) as outputs
-    GPIO_PORTB_DIR_R |= OUTPUT_DAC_PIN;
-
-    // Disable analog functionality for PB0 - PB7
-    GPIO_PORTB_AMSEL_R &= ~(OUTPUT_DAC_PIN);
-
-    // Enable digital functionality for PB0 - PB7
-    GPIO_PORTB_DEN_R |= OUTPUT_DAC_PIN;
+// Pin configuration for the DAC outputs (PB0 - PB7) and input buttons (PF0 & PF4)
+// NOTE: PF0 is a locked pin, which is handled by the commit register setup in GPIO_Init_Pins()
+const GPIO_PinConfig TASK_PIN_CONFIG[] = {
+    {GPIO_PORT_B, OUTPUT_DAC_PIN,    GPIO_OUTPUT,  0},
+    {GPIO_PORT_F, INPUT_BUTTON_PINS, GPIO_INPUT | GPIO_PULL_UP, 0},
+    GPIO_PIN_CONFIG_END
+};
 
-    // Disable all alternate functionality for PB0 - PB7
-    GPIO_PORTB_AFSEL_R &= ~OUTPUT_DAC_PIN;
 
-    // Disable all special functionality for PB0 - PB7
-    GPIO_PORTB_PCTL_R &= ~OUTPUT_DAC_PIN;
+void Setup_GPIO_Pins(void) {
+    const GPIO_PinConfig *const pinTables[] = { TASK_PIN_CONFIG, UART_PIN_CONFIG };
 
-    // Lock Port B configuration
-    GPIO_PORTB_LOCK_R = 0;
+    // Configure Ports A (UART), B & F in a single pass
+    GPIO_Init_Pins(pinTables, sizeof(pinTables) / sizeof(pinTables[0]));
 }
 
 
-void Setup_Port_F_Pins(void) {
-    // Enable Port F clock
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R5;
-
-    // Wait until Port F clock is fully initialized
-    while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R5) == 0);
-
-    // Unlock Port F configuration
-    GPIO_PORTF_LOCK_R = GPIO_LOCK_KEY;
-
-    // Set commit register to only work with pins PF0 & PF4
-    GPIO_PORTF_CR_R = INPUT_BUTTON_PINS;
-
-    // Set input buttons pins (PF0 & PF4) as inputs
-    GPIO_PORTF_DIR_R &= ~INPUT_BUTTON_PINS;
-
-    // Disable analog functionality for PF0 & PF4
-    GPIO_PORTF_AMSEL_R &= ~(INPUT_BUTTON_PINS);
-
-    // Enable digital functionality for PF0 & PF4
-    GPIO_PORTF_DEN_R |= INPUT_BUTTON_PINS;
-
-    // Disable all alternate functionality for PF0 & PF4
-    GPIO_PORTF_AFSEL_R &= ~INPUT_BUTTON_PINS;
-
-    // Disable all special functionality for PF0 & PF4
-    GPIO_PORTF_PCTL_R &= ~INPUT_BUTTON_PINS;
-
-    // Enable pull-down resistors for input button pins (PF0 & PF4)
-    GPIO_PORTF_PUR_R |= INPUT_BUTTON_PINS;
-
-    //////////////////////////////
-    // Interrupt-specific Setup //
-    //////////////////////////////
-
-    // Set interrupt trigger for PF0 & PF4 to be edge sensitive
-    GPIO_PORTF_IS_R &= ~INPUT_BUTTON_PINS;
-
-    // Set interrupt trigger for PF0 & PF4 to NOT be fired from both edges
-    GPIO_PORTF_IBE_R &= ~INPUT_BUTTON_PINS;
-
-    // Set PF0 & PF4 to listen to falling edge
-    GPIO_PORTF_IEV_R &= ~INPUT_BUTTON_PINS;
-
-    // Clear any prior interrupts for PF0 & PF4
-    GPIO_PORTF_ICR_R |= INPUT_BUTTON_PINS;
-
-    // Unmask the interrupt for PF0 & PF4
-    GPIO_PORTF_IM_R |= INPUT_BUTTON_PINS;
-
-    // Lock Port F configuration
-    GPIO_PORTF_LOCK_R = 0;
+void Setup_Port_F_Interrupts(void) {
+    // Call Button_Pressed() on the falling edges of PF0 & PF4 (buttons pull low), at interrupt priority level 5
+    GPIO_Irq_Register(GPIO_PORT_F, INPUT_BUTTON_PINS, GPIO_IRQ_FALLING, Button_Pressed, BUTTON_PRIORITY);
 }
 
 
@@ -152,13 +241,8 @@ void Setup_Port_F_Pins(void) {
 
 
 void Setup_Global_Interrupts(void) {
-    // Set interrupt priority for Interrupt #30 (for GPIO Port F) to level 5 (Refer to Table 2-9 or pg. 104-106 in datasheet)
-    // Equivalent statement: NVIC_PRI7_R = (NVIC_PRI7_R & 0xFF00FFFF) | (5 << 21);
-    NVIC_SetPriorityIRQn(30, 5);
-
-    // Enable interrupt #30 (for GPIO Port F) (Refer to Table 2-9 or pg. 104-106 in datasheet)
-    // Equivalent statement: NVIC_EN0_R |= (1 << 30);
-    NVIC_EnableIRQn(30);
+    // Let every priority bit decide preemption, as assumed by the priority map (& the masking levels)
+    NVIC_SetPriorityGrouping(PRIORITY_PREEMPT_BITS);
 
     // Globally enable interrupt requests (IRQs) by clearing priority mask
     // Equivalent assembly statement: "CPSIE I" (Change Processor State Interrupt Enable)
@@ -166,56 +250,82 @@ void Setup_Global_Interrupts(void) {
 }
 
 
-//////////////////////
-// Timing Functions //
-//////////////////////
+////////////////////////
+// Interrupt Handlers //
+////////////////////////
 
 
-// Wait for delay x 1 ms via SysTick (assuming 50 MHz clock -> 1 cycle = 20 ns)
-void SysTick_Wait_1ms(uint32_t delay) {
-    uint32_t i;
-    for (i = 0 ; i < delay; i++) {
-        // Wait for duration of 50,000 * 20 ns
-        SysTick_Wait(50000);
+// Called from GPIOF_Handler (see "gpio_irq.h") for every button press, once per pin
+void Button_Pressed(uint8_t port, uint8_t pin) {
+    #if MEASURE_LATENCY
+        // Stamp the press first thing, so the time spent getting here (exception entry & the dispatch in
+        // "gpio_irq.c", a few dozen cycles) is all that's missing from the measurement
+        LATENCY_TRIGGER(LATENCY_CHANNEL_BUTTON);
+    #endif
+
+    if (GPIO_READ_PINS(port, INPUT_BUTTON_PINS) == 0) {
+        // Both SW1 (PF4) and SW2 (PF0) are held down: don't display anything
+        Active_Post(&waveform, WAVEFORM_SIGNAL_MODE, 0, NULL);
+    } else if (pin == 4) {
+        // SW1 (PF4): start outputting a sawtooth waveform
+        Active_Post(&waveform, WAVEFORM_SIGNAL_MODE, 1, NULL);
+    } else {
+        // SW2 (PF0): start outputting a sine waveform
+        Active_Post(&waveform, WAVEFORM_SIGNAL_MODE, 2, NULL);
     }
 }
 
 
-////////////////////////
-// Interrupt Handlers //
-////////////////////////
+///////////////////////////
+// Debug Benchmark Tools //
+///////////////////////////
+
+
+// Debug function to measure the GPIO throughput of the selected bus aperture (see GPIO_AHB_PORTS in "gpio.h")
+// - Toggle: PB0 driven high then low, reported as cycles per full toggle period
+// - DAC write: one 8-bit sample written to PB0 - PB7, reported as cycles per sample
+// NOTE: Each result includes the loop overhead. Compare a build with GPIO_AHB_PORTS = 0x00 (APB) against
+// the default build (AHB) to see the difference. At 50 MHz, the toggle rate is 50 MHz / benchmarkToggleCycles.
+void DEBUG_Benchmark_GPIO_Throughput(void) {
+    uint32_t i, start, end, savedCtrl, savedReload;
 
+    // Save the SysTick setup of the caller, to put it back afterwards
+    savedCtrl = NVIC_ST_CTRL_R;
+    savedReload = NVIC_ST_RELOAD_R;
+
+    // Let SysTick free-run from its maximum reload value (24-bit down counter), without interrupts so a
+    // periodic setup doesn't count the 2^24 cycle wrap-arounds as ticks
+    NVIC_ST_CTRL_R = 0;
+    NVIC_ST_RELOAD_R = NVIC_ST_RELOAD_M;
+    NVIC_ST_CURRENT_R = 0;
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_ENABLE | NVIC_ST_CTRL_CLK_SRC;
+
+    // Measure pin toggling
+    start = NVIC_ST_CURRENT_R;
+    for (i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        GPIO_SET_PINS(GPIO_PORT_B, 0x01);
+        GPIO_CLEAR_PINS(GPIO_PORT_B, 0x01);
+    }
+    end = NVIC_ST_CURRENT_R;
+    benchmarkToggleCycles = ((start - end) & NVIC_ST_RELOAD_M) / BENCHMARK_ITERATIONS;
 
-// NOTE: This is meant to be implicitly overriden
-void GPIOF_Handler(void) {
-    volatile int readback;
-
-    while (GPIO_PORTF_MIS_R != 0) {
-        // NOTE: You cannot have checks on multiple pins in 1 statement or it will not work
-        //   (i.e. GPIO_PORTF_MIS_R & 0x11 will NOT work as expected)
-        if ((GPIO_PORTF_MIS_R & 0x10) && (GPIO_PORTF_MIS_R & 0x01)) { // Have both SW1 (PF4) and SW2 (PF0) been pressed?
-            // Don't display anything
-            outputMode = 0;
-
-            // Clear the PF4 & PF0 interrupt flags, making sure to force clear it via a read
-            GPIO_PORTF_ICR_R |= 0x11;
-            readback = GPIO_PORTF_ICR_R;
-        } else if (GPIO_PORTF_MIS_R & 0x10) { // Has SW1 (PF4) been pressed?
-            // Start outputting a sawtooth waveform
-            outputMode = 1;
-
-            // Clear the PF4 interrupt flag, making sure to force clear it via a read
-            GPIO_PORTF_ICR_R |= 0x10;
-            readback = GPIO_PORTF_ICR_R;
-        } else if (GPIO_PORTF_MIS_R & 0x01) { // Has SW2 (PF0) been pressed?
-            // Start outputting a sine waveform
-            outputMode = 2;
-
-            // Clear the PF0 interrupt flag, making sure to force clear it via a read
-            GPIO_PORTF_ICR_R |= 0x01;
-            readback = GPIO_PORTF_ICR_R;
-        }
+    // Measure DAC sample updates
+    start = NVIC_ST_CURRENT_R;
+    for (i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        GPIO_WRITE_PINS(GPIO_PORT_B, OUTPUT_DAC_PIN, i);
     }
+    end = NVIC_ST_CURRENT_R;
+    benchmarkDacWriteCycles = ((start - end) & NVIC_ST_RELOAD_M) / BENCHMARK_ITERATIONS;
+
+    // Leave the DAC output at 0 V
+    GPIO_WRITE_PINS(GPIO_PORT_B, OUTPUT_DAC_PIN, 0x00);
+
+    // Restore the SysTick setup of the caller
+    // NOTE: The current value can't be restored (any write clears it), so the caller's period restarts here
+    NVIC_ST_CTRL_R = 0;
+    NVIC_ST_RELOAD_R = savedReload;
+    NVIC_ST_CURRENT_R = 0;
+    NVIC_ST_CTRL_R = savedCtrl & (NVIC_ST_CTRL_ENABLE | NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_INTEN);
 }
 
 
@@ -278,60 +388,359 @@ uint8_t Generate_Sine_Waveform_Tick(int tick) {
 }
 
 
-int main() {
-    int tick = 0;
-    uint8_t dac_output;
+////////////////////////////
+// Waveform Active Object //
+////////////////////////////
 
-    // Initialize PLL & SysTick
-    PLL_Init(SYSDIV2_50_00_Mhz);
-    SysTick_Init();
 
-    // Initialize GPIO for Ports B & F
-    Setup_Port_B_Pins();
-    Setup_Port_F_Pins();
+// Handle 1 event of the waveform generator, updating the DAC output once per tick (1 ms)
+void Waveform_Handler(Active *self, const Active_Event *event) {
+    uint8_t dac_output;
 
-    // Setup global interrupts for GPIO Port F
-    Setup_Global_Interrupts();
+    switch (event->signal) {
+        case ACTIVE_SIGNAL_START:
+            #if TEST_DAC_OUTPUTS
+                // If the 'TEST_DAC_OUTPUTS' flag is set to 1, then we don't care about button inputs for the time being
+                // This waveform is meant for debugging the voltage outputs for every segment of the DAC individually
+                // If not desired, make sure to set to 0 and re-compile
+                queuedWaveform = &STAIR_WAVEFORM;
+            #endif
+
+            // Start ticking
+            Active_Timer_Arm(&waveformTimer, self, WAVEFORM_SIGNAL_TICK, 1, 1);
+            return;
+        case WAVEFORM_SIGNAL_MODE:
+            #if !TEST_DAC_OUTPUTS
+                // Button presses are queued in order, so the last one wins (once the playing cycle is over)
+                outputMode = (int) event->param;
+
+                #if MEASURE_LATENCY
+                    LATENCY_ENTER(LATENCY_CHANNEL_BUTTON);
+                #endif
+
+                if (outputMode >= 0 && outputMode < (int) (sizeof(OUTPUT_WAVEFORMS) / sizeof(OUTPUT_WAVEFORMS[0])))
+                    queuedWaveform = &OUTPUT_WAVEFORMS[outputMode];
+                else
+                    queuedWaveform = &OUTPUT_WAVEFORMS[0];
+            #endif
+            return;
+        case WAVEFORM_SIGNAL_TICK:
+            break;
+        default:
+            return;
+    }
 
-    while (1) {
-        #if TEST_DAC_OUTPUTS
-            // If the 'TEST_DAC_OUTPUTS' flag is set to 1, then we don't care about button inputs for the time being
-            // This function is meant for debugging the voltage outputs for every segment of the DAC individually
-            // If not desired, make sure to set to 0 and re-compile
-            dac_output = DEBUG_Generate_Stair_Voltage_Waveform_Tick(tick % 480);
-        #else
-            // Normal operation: The waveform generation works similar to a game engine by displaying the state of
-            // the waveform per tick. This allows as close to realtime switching of the waveform as you can get, but
-            // it also has the side-effect of seeing partial waveforms if the buttons are pressed during the middle
-            // of a waveform cycle. This is really meant to demonstrate the realtime responsiveness of the interrupts.
-            switch (outputMode) {
-                case 0:
-                    dac_output = 0x00;
-                    break;
-                case 1:
-                    dac_output = Generate_Sawtooth_Waveform_Tick(tick % 256);
-                    break;
-                case 2:
-                    dac_output = Generate_Sine_Waveform_Tick(tick % 60);
-                    break;
-                default:
-                    // NOTE: This should never happen but better safe than sorry
-                    dac_output = 0x00;
-                    break;
-            }
+    // The waveform generation works similar to a game engine by displaying the state of the waveform per tick,
+    // except that a new waveform only takes over at the start of a cycle (phase 0, where the sine crosses zero
+    // & the sawtooth starts rising), so the output never shows a partial cycle of either (the 2 start at
+    // different levels though, so the switch itself can still step the output)
+    // NOTE: The check shares the phase wrap-around with the sample lookup, so switching costs nothing per tick
+    if (waveformPhase == 0)
+        playingWaveform = queuedWaveform;
+
+    if (playingWaveform->generate != NULL)
+        dac_output = playingWaveform->generate(waveformPhase);
+    else
+        dac_output = 0x00;
+
+    // Each waveform keeps its own phase (rather than taking the modulo of a shared tick count), so it always
+    // starts from the beginning of its cycle
+    if (++waveformPhase >= playingWaveform->period)
+        waveformPhase = 0;
+
+    #if MEASURE_LATENCY
+        // Stamp the sample right as it gets written, so the waveform math before doesn't add to the jitter
+        LATENCY_ENTER(LATENCY_CHANNEL_SAMPLE);
+    #endif
+
+    // Write the DAC output from the waveform generation directly to all DAC pins on Port B
+    // NOTE: This assumes that PB7 is the MSB and PB0 is the LSB
+    GPIO_WRITE_PINS(GPIO_PORT_B, OUTPUT_DAC_PIN, dac_output);
+
+    // Make sure to reset the counter to 0 after every 3840 ms (only used for the statistics now)
+    waveformTick = (waveformTick + 1) % 3840;
+
+    // Update the sleep vs. active statistics once per counter reset
+    if (waveformTick == 0) {
+        Power_Get_Stats(&powerStats);
+        powerAverageCurrent_uA = Power_Estimate_Average_Current_uA(&powerStats);
+
+        #if MEASURE_LATENCY
+            Update_Latency_Results();
         #endif
 
-        // Write the DAC output from the waveform generation directly to all pins on Port B
-        // NOTE: This assumes that PB7 is the MSB and PB0 is the LSB
-        GPIO_PORTB_DATA_R = dac_output;
+        #if CHECK_ISR_BUDGETS
+            Update_ISR_Budget_Results();
+        #endif
+    }
+}
 
-        // Make sure to reset the counter to 0 after every 3840 ms
-        // - 3840 / 256      = 15 full cycles of sawtooth waveform
-        // - 3840 / 60       = 64 full cycles of sine waveform
-        // - 3840 / (8 * 60) = 8 full cucles of DEBUG stair voltage waveform
-        tick = (tick + 1) % 3840;
 
-        // Delay for exactly 1 millisecond due to waveform generation logic
-        SysTick_Wait_1ms(1);
+// Compute 1 full cycle of every built-in waveform up front as waveform generator tables, so playback needs
+// no math per sample
+void Build_Waveform_Tables(void) {
+    uint8_t *table;
+    int t;
+
+    table = AWG_Begin_Table();
+    for (t = 0; t < SAWTOOTH_PERIOD; t++)
+        table[t] = Generate_Sawtooth_Waveform_Tick(t);
+    AWG_Commit_Table("sawtooth", SAWTOOTH_PERIOD);
+
+    table = AWG_Begin_Table();
+    for (t = 0; t < SINE_PERIOD; t++)
+        table[t] = Generate_Sine_Waveform_Tick(t);
+    AWG_Commit_Table("sine", SINE_PERIOD);
+
+    #if TEST_DAC_OUTPUTS
+        table = AWG_Begin_Table();
+        for (t = 0; t < STAIR_PERIOD; t++)
+            table[t] = DEBUG_Generate_Stair_Voltage_Waveform_Tick(t);
+        AWG_Commit_Table("stair", STAIR_PERIOD);
+    #endif
+}
+
+
+// Setup a 3-tone test signal (1, 2.5 & 4 kHz, with the gains adding up to just under full scale) on the mixer
+void Setup_Mixer_Voices(void) {
+    Mixer_Init(DAC_SAMPLE_RATE_HZ);
+    Mixer_Build_Sine(mixerSine);
+
+    Mixer_Set_Voice(0, mixerSine, 1000, 128);
+    Mixer_Set_Voice(1, mixerSine, 2500, 64);
+    Mixer_Set_Voice(2, mixerSine, 4000, 48);
+}
+
+
+// Called from UART0_Handler once received bytes have been queued
+void Serial_Rx_Ready(void) {
+    if (!serialPending) {
+        serialPending = 1;
+        Active_Post(&waveform, WAVEFORM_SIGNAL_SERIAL, 0, NULL);
+    }
+}
+
+
+// Handle 1 event of the waveform generator when the uDMA plays the DAC, which only has to pick the table
+// NOTE: A new waveform starts at the end of the cycle in progress, so no partial cycles show up
+void Waveform_DMA_Handler(Active *self, const Active_Event *event) {
+    char received[32];
+    unsigned int count;
+
+    switch (event->signal) {
+        case ACTIVE_SIGNAL_START:
+            AWG_Init();
+            Build_Waveform_Tables();
+
+            #if TEST_DAC_OUTPUTS
+                // If the 'TEST_DAC_OUTPUTS' flag is set to 1, play the DEBUG stair voltage waveform for good
+                AWG_Play("stair");
+            #elif MIXER_OUTPUT
+                // If the 'MIXER_OUTPUT' flag is set to 1, stream the test signal right away
+                Setup_Mixer_Voices();
+                DAC_DMA_Stream((uint8_t *) mixerBuffer, MIXER_BLOCK_LENGTH, Mixer_Render);
+            #endif
+
+            // Only wake up for the statistics
+            Active_Timer_Arm(&waveformTimer, self, WAVEFORM_SIGNAL_TICK, POWER_STATS_PERIOD_MS, POWER_STATS_PERIOD_MS);
+            break;
+
+        case WAVEFORM_SIGNAL_MODE:
+            #if MIXER_OUTPUT && !TEST_DAC_OUTPUTS
+                // SW1 mixes the voices at full scale (clipping when they peak together), SW2 at a quarter scale each
+                outputMode = (int) event->param;
+
+                #if MEASURE_LATENCY
+                    LATENCY_ENTER(LATENCY_CHANNEL_BUTTON);
+                #endif
+
+                if (outputMode == 0) {
+                    DAC_DMA_Stop();
+                    GPIO_WRITE_PINS(GPIO_PORT_B, OUTPUT_DAC_PIN, 0x00);
+                } else {
+                    Mixer_Set_Mode((outputMode == 2) ? MIXER_AVERAGE : MIXER_SATURATE);
+                    DAC_DMA_Stream((uint8_t *) mixerBuffer, MIXER_BLOCK_LENGTH, Mixer_Render);
+                }
+            #elif !TEST_DAC_OUTPUTS
+                outputMode = (int) event->param;
+
+                #if MEASURE_LATENCY
+                    LATENCY_ENTER(LATENCY_CHANNEL_BUTTON);
+                #endif
+
+                switch (outputMode) {
+                    case 1:
+                        AWG_Play("sawtooth");
+                        break;
+                    case 2:
+                        AWG_Play("sine");
+                        break;
+                    default:
+                        AWG_Stop();
+                        GPIO_WRITE_PINS(GPIO_PORT_B, OUTPUT_DAC_PIN, 0x00);
+                        break;
+                }
+            #endif
+            break;
+
+        case WAVEFORM_SIGNAL_SERIAL:
+            // Clear the flag first, so bytes arriving while these are handled post another event
+            serialPending = 0;
+
+            // Run the waveform table commands received (see "awg.h"), i.e. to load or play another table
+            while ((count = Uart_Read(received, sizeof(received))) != 0)
+                AWG_Feed(received, count, Uart_Write_String);
+            break;
+
+        case WAVEFORM_SIGNAL_TICK:
+            Power_Get_Stats(&powerStats);
+            powerAverageCurrent_uA = Power_Estimate_Average_Current_uA(&powerStats);
+
+            #if MEASURE_LATENCY
+                Update_Latency_Results();
+                Latency_Write(Uart_Write_String);
+            #endif
+
+            #if CHECK_ISR_BUDGETS
+                Update_ISR_Budget_Results();
+                Budget_Write(Uart_Write_String);
+            #endif
+            break;
     }
 }
+
+
+//////////////////////////
+// Latency Measurements //
+//////////////////////////
+
+
+// Start the cycle counter & name the measurement channels
+void Setup_Latency_Measurements(void) {
+    Latency_Init();
+    Latency_Setup_Channel(LATENCY_CHANNEL_BUTTON, "button", 0);
+
+    // The uDMA plays the DAC off Timer 5A without the core, so only the computed waveforms have any jitter
+    #if !DAC_DMA_OUTPUT
+        Latency_Setup_Channel(LATENCY_CHANNEL_SAMPLE, "sample", SYS_CLOCK_HZ / ACTIVE_TICK_HZ);
+    #endif
+}
+
+
+// Copy the latest results to where the debugger can see them
+void Update_Latency_Results(void) {
+    Latency_Get(LATENCY_CHANNEL_BUTTON, &buttonLatency);
+    Latency_Get(LATENCY_CHANNEL_SAMPLE, &sampleJitter);
+}
+
+
+///////////////////////////////
+// Interrupt Handler Budgets //
+///////////////////////////////
+
+
+// Time every interrupt handler against its budget
+void Setup_ISR_Budgets(void) {
+    Budget_Init(ISR_Overrun);
+
+    Budget_Watch(GPIOF_IRQn, "button", BUDGET_BUTTON_CYCLES);
+    Budget_Watch(TIMER2A_IRQn, "tick", BUDGET_TICK_CYCLES);
+
+    #if DAC_DMA_OUTPUT
+        Budget_Watch(TIMER5A_IRQn, "dac", BUDGET_DAC_CYCLES);
+        Budget_Watch(UART0_IRQn, "uart", BUDGET_UART_CYCLES);
+    #else
+        Budget_Watch(BUDGET_PENDSV_IRQn, "dispatch", BUDGET_DISPATCH_CYCLES);
+    #endif
+
+    #if BENCHMARK_GPIO_THROUGHPUT
+        // SysTick_Init() left the SysTick interrupt enabled
+        Budget_Watch(BUDGET_SYSTICK_IRQn, "systick", BUDGET_SYSTICK_CYCLES);
+    #endif
+}
+
+
+// Copy the latest results to where the debugger can see them
+void Update_ISR_Budget_Results(void) {
+    unsigned int slot;
+
+    for (slot = 0; slot < BUDGET_MAX_HANDLERS; slot++)
+        Budget_Get(slot, &isrBudgets[slot]);
+
+    isrOverruns = Budget_Total_Overruns();
+}
+
+
+// Called right after a handler took longer than its budget, from the same interrupt
+void ISR_Overrun(const Budget_Stats *stats) {
+    lastOverrunIsr = stats->name;
+
+    #if BREAK_ON_ISR_OVERRUN
+        // If the 'BREAK_ON_ISR_OVERRUN' flag is set to 1, stop here (see 'stats' for the handler & its timing)
+        // NOTE: Without a debugger attached, this escalates to a hard fault
+        __breakpoint(0);
+    #endif
+}
+
+
+int main() {
+    #if DAC_DMA_OUTPUT
+        // Port F keeps its clock while sleeping to detect the button edges, Timer 2 to keep ticking, Timer 5,
+        // the uDMA & Port B to keep playing the DAC, and UART 0 (with its pins on Port A) to receive tables
+        const Power_SleepClocks sleepClocks = { (1UL << GPIO_PORT_F) | (1UL << GPIO_PORT_B) | (1UL << GPIO_PORT_A),
+                                                SYSCTL_SCGCTIMER_S2 | SYSCTL_SCGCTIMER_S5, 0, 0, SYSCTL_SCGCUART_S0,
+                                                SYSCTL_SCGCDMA_S0, 0 };
+    #else
+        // Port F keeps its clock while sleeping to detect the button edges, and Timer 2 to keep ticking
+        const Power_SleepClocks sleepClocks = { (1UL << GPIO_PORT_F), SYSCTL_SCGCTIMER_S2, 0, 0, 0, 0, 0 };
+    #endif
+
+    // Initialize PLL
+    PLL_Init(SYSDIV2_50_00_Mhz);
+
+    // Initialize GPIO for Ports B & F
+    Setup_GPIO_Pins();
+
+    #if BENCHMARK_GPIO_THROUGHPUT
+        // If the 'BENCHMARK_GPIO_THROUGHPUT' flag is set to 1, measure the GPIO throughput before starting
+        // NOTE: The results are stored in 'benchmarkToggleCycles' & 'benchmarkDacWriteCycles'
+        SysTick_Init();
+        DEBUG_Benchmark_GPIO_Throughput();
+    #endif
+
+    #if MEASURE_LATENCY
+        // If the 'MEASURE_LATENCY' flag is set to 1, measure from the very first button press & tick on
+        // NOTE: The results are stored in 'buttonLatency' & 'sampleJitter'
+        Setup_Latency_Measurements();
+    #endif
+
+    #if CHECK_ISR_BUDGETS
+        // If the 'CHECK_ISR_BUDGETS' flag is set to 1, time every handler from its first run on
+        // NOTE: The results are stored in 'isrBudgets', 'isrOverruns' & 'lastOverrunIsr'
+        Setup_ISR_Budgets();
+    #endif
+
+    // Setup the event framework (1 ms ticks) & start the waveform generator
+    MemPool_Init();
+    Active_Init(SYS_CLOCK_HZ, ACTIVE_TICK_HZ);
+
+    #if DAC_DMA_OUTPUT
+        // Let the uDMA play the DAC (Timer 5A paced), leaving only button presses & table commands for the core
+        DAC_DMA_Init(SYS_CLOCK_HZ, DAC_SAMPLE_RATE_HZ);
+        Uart_Init(SYS_CLOCK_HZ, UART_BAUD_RATE);
+        Uart_Set_Rx_Callback(Serial_Rx_Ready);
+        Active_Start(&waveform, WAVEFORM_PRIORITY, waveformQueue, WAVEFORM_QUEUE_CAPACITY, Waveform_DMA_Handler);
+    #else
+        Active_Start(&waveform, WAVEFORM_PRIORITY, waveformQueue, WAVEFORM_QUEUE_CAPACITY, Waveform_Handler);
+    #endif
+
+    // Gate the clocks of every other peripheral while sleeping in between DAC updates
+    Power_Init(&sleepClocks);
+
+    // Listen to the buttons only now that the waveform generator can take their events, then enable interrupts
+    Setup_Port_F_Interrupts();
+    Setup_Global_Interrupts();
+
+    // Sleep whenever no interrupt or active object is running (never returns)
+    Active_Run();
+}
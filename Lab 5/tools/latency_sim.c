@@ -0,0 +1,164 @@
+/*
+ * Host-side check of the latency & jitter measurements (lib/latency/latency.c), on a simulated cycle counter
+ *
+ * Replays the 2 measurements of main.c with a made-up (but board-like) timing model, in system clock cycles:
+ * - "sample": the 1 ms tick (Timer 2A) pends PendSV, which runs the waveform handler, which writes the DAC
+ *   sample after computing it, so every sample is late by the exception entries, the waveform math (much
+ *   slower for the sine) & any critical section or other interrupt handler running at the tick
+ * - "button": a press enters GPIOF_Handler (after any critical section in progress), which posts the mode
+ *   change, which the waveform handler only gets to once PendSV runs & any handler in progress is done
+ *
+ * Prints the report of Latency_Write() (the same lines the board sends over UART), then checks the minimum,
+ * mean & worst case of each channel against the ones tracked here (on stderr). The counter starts just below
+ * its wrap-around point, so the wrap gets covered as well.
+ *
+ * Build (from the "Lab 5" folder):
+ *   gcc -std=gnu89 -Wall -O2 -I. -Ilib -o latency_sim tools/latency_sim.c lib/latency/latency.c
+ *
+ * Usage:
+ *   ./latency_sim [ticks (default 100000)] > report.txt
+ *
+ * The exit code is 1 if any result doesn't match, so it can be used in scripts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "latency/latency.h"
+
+// Board settings (see main.c)
+#define SYS_CLOCK_HZ 50000000UL
+#define ACTIVE_TICK_HZ 1000UL
+#define CHANNEL_BUTTON 0
+#define CHANNEL_SAMPLE 1
+
+// Timing model (cycles)
+#define EXCEPTION_ENTRY 12          // Stacking & vector fetch
+#define TAIL_CHAIN 6                // Exception to exception without unstacking
+#define TICK_HANDLER 90             // TIMER2A_Handler, counting down the armed timers & posting
+#define GPIO_HANDLER 70             // GPIOF_Handler, dispatching & posting
+#define DISPATCH 60                 // PendSV_Handler, picking & popping the event
+#define SAWTOOTH_MATH 25
+#define SINE_MATH 240               // sinf() with software division & float conversions
+#define MAX_CRITICAL 400            // Longest section with interrupts disabled
+#define MAX_OTHER_HANDLER 600       // Longest interrupt handler of the same or a higher priority (i.e. UART)
+#define PRESS_EVERY_TICKS 37        // Average ticks between button presses
+
+#define START_CYCLES 0xFFFF0000UL   // 65536 cycles (~1.3 ms) before the counter wraps
+
+
+typedef struct {
+    unsigned long count;
+    uint32_t min, max;
+    double total;
+} Expected;
+
+
+static unsigned int Write_Line(const char *str) {
+    fputs(str, stdout);
+    return 0;
+}
+
+
+// Cycles something gets held up by a critical section or another handler, about 1 time in 10
+static uint32_t Random_Blocking(void) {
+    switch (rand() % 20) {
+        case 0:
+            return (uint32_t) (rand() % MAX_CRITICAL);
+        case 1:
+            return (uint32_t) (rand() % MAX_OTHER_HANDLER);
+        default:
+            return 0;
+    }
+}
+
+
+static void Expect(Expected *expected, uint32_t sample) {
+    if (expected->count == 0 || sample < expected->min)
+        expected->min = sample;
+
+    if (sample > expected->max)
+        expected->max = sample;
+
+    expected->total += sample;
+    expected->count++;
+}
+
+
+static int Check(unsigned int channel, const Expected *expected) {
+    Latency_Stats stats;
+    unsigned long mean;
+
+    Latency_Get(channel, &stats);
+    mean = stats.count ? (unsigned long) (stats.totalCycles / stats.count) : 0;
+
+    fprintf(stderr, "%s: %lu samples, min %lu, mean %lu, worst %lu cycles (expected %lu, %lu, %lu, %lu)\n",
+            stats.name, stats.count, (unsigned long) stats.minCycles, mean, (unsigned long) stats.maxCycles,
+            expected->count, (unsigned long) expected->min, (unsigned long) (expected->total / expected->count),
+            (unsigned long) expected->max);
+
+    return stats.count == expected->count && stats.minCycles == expected->min && stats.maxCycles == expected->max
+        && mean == (unsigned long) (expected->total / expected->count);
+}
+
+
+int main(int argc, char *argv[]) {
+    const uint32_t period = SYS_CLOCK_HZ / ACTIVE_TICK_HZ;
+    Expected sample = {0, 0, 0, 0}, button = {0, 0, 0, 0};
+    uint32_t tick, lastWrite = 0, write, press, handled, deviation;
+    unsigned long ticks = 100000, n;
+    int mode = 1, ok;
+
+    if (argc >= 2)
+        ticks = strtoul(argv[1], NULL, 10);
+
+    srand(1);
+    Latency_Init();
+    Latency_Setup_Channel(CHANNEL_BUTTON, "button", 0);
+    Latency_Setup_Channel(CHANNEL_SAMPLE, "sample", period);
+
+    for (n = 0; n < ticks; n++) {
+        tick = (uint32_t) (START_CYCLES + n * period);
+
+        // DAC sample of this tick
+        write = tick + Random_Blocking() + EXCEPTION_ENTRY + TICK_HANDLER + TAIL_CHAIN + DISPATCH
+              + ((mode == 2) ? SINE_MATH : SAWTOOTH_MATH);
+
+        latencySimCycles = write;
+        LATENCY_ENTER(CHANNEL_SAMPLE);
+
+        if (n > 0) {
+            deviation = write - lastWrite;
+            deviation = (deviation > period) ? deviation - period : period - deviation;
+            Expect(&sample, deviation);
+        }
+
+        lastWrite = write;
+
+        // Button press somewhere in between this tick & the next one, switching between sawtooth & sine
+        if (rand() % PRESS_EVERY_TICKS == 0) {
+            press = tick + 1000 + (uint32_t) (rand() % (period - 2000));
+            handled = press + Random_Blocking() + EXCEPTION_ENTRY + GPIO_HANDLER + TAIL_CHAIN + DISPATCH;
+
+            latencySimCycles = press;
+            LATENCY_TRIGGER(CHANNEL_BUTTON);
+            latencySimCycles = handled;
+            LATENCY_ENTER(CHANNEL_BUTTON);
+
+            Expect(&button, handled - press);
+            mode = 3 - mode;
+        }
+    }
+
+    Latency_Write(Write_Line);
+
+    ok = Check(CHANNEL_SAMPLE, &sample);
+    ok &= Check(CHANNEL_BUTTON, &button);
+
+    if (!ok) {
+        fprintf(stderr, "FAILED: the measurements don't match the simulated timing\n");
+        return 1;
+    }
+
+    return 0;
+}
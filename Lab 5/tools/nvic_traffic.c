@@ -0,0 +1,197 @@
+/*
+ * Host-side register traffic test for the NVIC macros & functions (lib/nvic/Interrupt.h & Interrupt.c)
+ *
+ * Points every NVIC register the macros use at a RAM array, fills the arrays with a sentinel pattern standing in
+ * for whatever the hardware would read back, then runs each operation on a spread of interrupt numbers (both
+ * constant & run-time) and checks the exact stores left behind:
+ * - Enable / disable / set pending / clear pending: a single store of only the interrupt's bit to the right
+ *   register of the bank (write-1-to-set / write-1-to-clear), so the sentinel must be gone from that register
+ *   (no read-modify-write) & every other register of every bank must be untouched
+ * - Priority: only the interrupt's own byte gets stored, so the 3 other interrupts sharing its 32-bit register
+ *   (& every other byte) keep the sentinel
+ * - Priority grouping: a single store of the vector key & the PRIGROUP field
+ *
+ * Build (from the "Lab 5" folder):
+ *   gcc -std=gnu89 -Wall -O2 -I. -Ilib -o nvic_traffic tools/nvic_traffic.c
+ *
+ * Usage:
+ *   ./nvic_traffic
+ *
+ * The exit code is 1 if any operation stored anything else, so it can be used in scripts.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+// Host stand-ins for the compiler intrinsics used by "Interrupt.h"
+#define __inline inline
+#define __asm(x)
+#define __disable_irq()
+#define __enable_irq()
+#define __isb(x)
+
+// Take the MCU header first, so the NVIC registers can be pointed at RAM before "Interrupt.h" uses them
+#include "mcu/tm4c123gh6pm.h"
+
+#define BANK_REGISTERS 5    // 139 interrupts, 32 per register
+#define PRIORITY_BYTES 140  // 1 per interrupt, rounded up to whole registers
+#define SENTINEL 0xA5
+
+static volatile unsigned long enableRegs[BANK_REGISTERS];
+static volatile unsigned long disableRegs[BANK_REGISTERS];
+static volatile unsigned long pendRegs[BANK_REGISTERS];
+static volatile unsigned long unpendRegs[BANK_REGISTERS];
+static volatile unsigned long priorityRegs[PRIORITY_BYTES / sizeof(unsigned long) + 1];
+static volatile unsigned long apintReg;
+
+#undef NVIC_EN0_R
+#undef NVIC_DIS0_R
+#undef NVIC_PEND0_R
+#undef NVIC_UNPEND0_R
+#undef NVIC_PRI0_R
+#undef NVIC_APINT_R
+#define NVIC_EN0_R      (enableRegs[0])
+#define NVIC_DIS0_R     (disableRegs[0])
+#define NVIC_PEND0_R    (pendRegs[0])
+#define NVIC_UNPEND0_R  (unpendRegs[0])
+#define NVIC_PRI0_R     (priorityRegs[0])
+#define NVIC_APINT_R    (apintReg)
+
+// The run-time versions, built against the same RAM registers
+#include "nvic/Interrupt.c"
+
+// Interrupt numbers to check: both ends of every bank register & the ones used in the labs
+static const int IRQ_NUMBERS[] = {
+    0, 1, 4, 5, 17, 19, 21, 23, 30, 31, 32, 51, 63, 64, 92, 94, 95, 96, 127, 128, 138
+};
+#define IRQ_COUNT (sizeof(IRQ_NUMBERS) / sizeof(IRQ_NUMBERS[0]))
+
+static int failures = 0;
+
+
+static void Fill_Sentinel(void) {
+    memset((void *) enableRegs, SENTINEL, sizeof(enableRegs));
+    memset((void *) disableRegs, SENTINEL, sizeof(disableRegs));
+    memset((void *) pendRegs, SENTINEL, sizeof(pendRegs));
+    memset((void *) unpendRegs, SENTINEL, sizeof(unpendRegs));
+    memset((void *) priorityRegs, SENTINEL, sizeof(priorityRegs));
+    memset((void *) &apintReg, SENTINEL, sizeof(apintReg));
+}
+
+
+static void Fail(const char *operation, int IRQn, const char *what) {
+    fprintf(stderr, "FAILED: %s(%d): %s\n", operation, IRQn, what);
+    failures++;
+}
+
+
+// Check that only register 'IRQn / 32' of 'target' changed, to exactly the interrupt's bit
+static void Check_Bank_Store(const char *operation, int IRQn, volatile unsigned long *target) {
+    volatile unsigned long *banks[4];
+    unsigned long sentinel;
+    unsigned int b, i;
+
+    banks[0] = enableRegs;
+    banks[1] = disableRegs;
+    banks[2] = pendRegs;
+    banks[3] = unpendRegs;
+    memset(&sentinel, SENTINEL, sizeof(sentinel));
+
+    for (b = 0; b < 4; b++) {
+        for (i = 0; i < BANK_REGISTERS; i++) {
+            if (banks[b] == target && i == (unsigned int) (IRQn >> 5)) {
+                if (banks[b][i] != (1UL << (IRQn & 0x1F)))
+                    Fail(operation, IRQn, "the register doesn't hold exactly the interrupt's bit (read-modify-write?)");
+            } else if (banks[b][i] != sentinel) {
+                Fail(operation, IRQn, "another register was written");
+            }
+        }
+    }
+}
+
+
+// Check that only byte 'IRQn' of the priority registers changed, to 'priority' in bits[7:5]
+static void Check_Priority_Store(const char *operation, int IRQn, int priority) {
+    const volatile unsigned char *bytes = (const volatile unsigned char *) priorityRegs;
+    unsigned int i;
+
+    for (i = 0; i < PRIORITY_BYTES; i++) {
+        if (i == (unsigned int) IRQn) {
+            if (bytes[i] != (unsigned char) (priority << 5))
+                Fail(operation, IRQn, "wrong value in the interrupt's priority byte");
+        } else if (bytes[i] != SENTINEL) {
+            Fail(operation, IRQn, "the priority byte of another interrupt was written");
+        }
+    }
+}
+
+
+int main(void) {
+    unsigned int i;
+    int IRQn, priority;
+
+    // Constant interrupt numbers (each macro resolving to a fixed address)
+    Fill_Sentinel();
+    NVIC_ENABLE_IRQ(TIMER5A_IRQn);
+    Check_Bank_Store("NVIC_ENABLE_IRQ", TIMER5A_IRQn, enableRegs);
+
+    Fill_Sentinel();
+    NVIC_DISABLE_IRQ(GPIOF_IRQn);
+    Check_Bank_Store("NVIC_DISABLE_IRQ", GPIOF_IRQn, disableRegs);
+
+    Fill_Sentinel();
+    NVIC_SET_PENDING_IRQ(UART0_IRQn);
+    Check_Bank_Store("NVIC_SET_PENDING_IRQ", UART0_IRQn, pendRegs);
+
+    Fill_Sentinel();
+    NVIC_CLEAR_PENDING_IRQ(TIMER5A_IRQn);
+    Check_Bank_Store("NVIC_CLEAR_PENDING_IRQ", TIMER5A_IRQn, unpendRegs);
+
+    Fill_Sentinel();
+    NVIC_SET_PRIORITY(TIMER2A_IRQn, 6);
+    Check_Priority_Store("NVIC_SET_PRIORITY", TIMER2A_IRQn, 6);
+
+    // Run-time interrupt numbers, through the functions
+    for (i = 0; i < IRQ_COUNT; i++) {
+        IRQn = IRQ_NUMBERS[i];
+
+        Fill_Sentinel();
+        NVIC_EnableIRQn(IRQn);
+        Check_Bank_Store("NVIC_EnableIRQn", IRQn, enableRegs);
+
+        Fill_Sentinel();
+        NVIC_DisableIRQn(IRQn);
+        Check_Bank_Store("NVIC_DisableIRQn", IRQn, disableRegs);
+
+        Fill_Sentinel();
+        NVIC_SetPendingIRQn(IRQn);
+        Check_Bank_Store("NVIC_SetPendingIRQn", IRQn, pendRegs);
+
+        Fill_Sentinel();
+        NVIC_ClearPendingIRQn(IRQn);
+        Check_Bank_Store("NVIC_ClearPendingIRQn", IRQn, unpendRegs);
+
+        for (priority = 0; priority <= 7; priority++) {
+            Fill_Sentinel();
+            NVIC_SetPriorityIRQn(IRQn, priority);
+            Check_Priority_Store("NVIC_SetPriorityIRQn", IRQn, priority);
+        }
+    }
+
+    // Priority grouping: key & field only, whatever the register held
+    for (i = 0; i <= 3; i++) {
+        Fill_Sentinel();
+        NVIC_SetPriorityGrouping((int) i);
+
+        if (apintReg != (NVIC_APINT_VECTKEY | ((7UL - i) << 8)))
+            Fail("NVIC_SetPriorityGrouping", (int) i, "not a single store of the key & PRIGROUP");
+    }
+
+    if (failures != 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+
+    printf("All NVIC stores are single, exact & confined to their own register / byte\n");
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * Host-side stress test & throughput benchmark for the SPSC ring buffer (lib/ringbuf/ringbuf.c)
+ *
+ * Runs a producer & a consumer thread on the same ring (standing in for an interrupt handler & the main
+ * code), on separate cores when available, which is a much harsher test of the index handoff than the
+ * single-core board:
+ * - Stress: the producer pushes an increasing sequence number in bursts of random size (single & bulk
+ *   pushes mixed), the consumer pops in bursts of random size & checks that every number arrives exactly
+ *   once & in order
+ * - Benchmark: elements per second with single Push / Pop calls vs. bulk calls of BULK_SIZE elements
+ *
+ * Build (from the "Lab 5" folder):
+ *   gcc -std=gnu89 -Wall -O2 -pthread -I. -Ilib -o ringbuf_stress tools/ringbuf_stress.c lib/ringbuf/ringbuf.c
+ *
+ * Usage:
+ *   ./ringbuf_stress [elements per run (default 20000000)]
+ *
+ * The exit code is 1 if any element was lost, duplicated or reordered, so it can be used in scripts.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ringbuf/ringbuf.h"
+
+#define DEFAULT_ELEMENTS 20000000UL
+#define RING_CAPACITY 256
+#define BULK_SIZE 64
+
+typedef enum {
+    MODE_STRESS,
+    MODE_SINGLE,
+    MODE_BULK
+} RunMode;
+
+typedef struct {
+    RingBuf *ring;
+    RunMode mode;
+    unsigned long elements;
+    unsigned long errors;   // Consumer only
+} RunArgs;
+
+
+// Small xorshift generator per thread (rand() isn't thread-safe)
+static uint32_t Next_Random(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+
+// Size of the next burst: 1 element or a random bulk size up to BULK_SIZE
+static unsigned int Burst_Size(RunMode mode, uint32_t *state) {
+    switch (mode) {
+        case MODE_SINGLE:
+            return 1;
+        case MODE_BULK:
+            return BULK_SIZE;
+        default:
+            return 1 + Next_Random(state) % BULK_SIZE;
+    }
+}
+
+
+static void *Producer(void *arg) {
+    RunArgs *run = (RunArgs *) arg;
+    uint32_t batch[BULK_SIZE];
+    uint32_t random = 0x12345678;
+    unsigned long next = 0;
+    unsigned int burst, pushed, i;
+
+    while (next < run->elements) {
+        burst = Burst_Size(run->mode, &random);
+        if (burst > run->elements - next)
+            burst = (unsigned int) (run->elements - next);
+
+        for (i = 0; i < burst; i++)
+            batch[i] = (uint32_t) (next + i);
+
+        if (burst == 1)
+            pushed = (unsigned int) RingBuf_Push(run->ring, batch);
+        else
+            pushed = RingBuf_Push_Many(run->ring, batch, burst);
+
+        // Whatever didn't fit gets pushed again with the next burst
+        // NOTE: Give up the CPU while the ring is full, so this also works on a single-core host
+        next += pushed;
+        if (pushed == 0)
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+
+static void *Consumer(void *arg) {
+    RunArgs *run = (RunArgs *) arg;
+    uint32_t batch[BULK_SIZE];
+    uint32_t random = 0x9E3779B9;
+    unsigned long expected = 0;
+    unsigned int burst, popped, i;
+
+    while (expected < run->elements) {
+        burst = Burst_Size(run->mode, &random);
+
+        if (burst == 1)
+            popped = (unsigned int) RingBuf_Pop(run->ring, batch);
+        else
+            popped = RingBuf_Pop_Many(run->ring, batch, burst);
+
+        if (popped == 0)
+            sched_yield();
+
+        for (i = 0; i < popped; i++) {
+            if (batch[i] != (uint32_t) expected) {
+                // Resync on the value received, so one fault doesn't count as millions
+                if (run->errors++ < 10)
+                    fprintf(stderr, "expected %lu, got %lu\n", expected, (unsigned long) batch[i]);
+                expected = batch[i];
+            }
+            expected++;
+        }
+    }
+
+    return NULL;
+}
+
+
+// Run a producer & consumer thread through 'elements' elements, returning the elapsed time in seconds
+static double Run(RunMode mode, unsigned long elements, unsigned long *errors, unsigned int *highWater) {
+    static uint32_t storage[RING_CAPACITY];
+    RingBuf ring;
+    RunArgs run;
+    pthread_t producer, consumer;
+    struct timespec start, end;
+
+    RingBuf_Init(&ring, storage, sizeof(storage[0]), RING_CAPACITY);
+    run.ring = &ring;
+    run.mode = mode;
+    run.elements = elements;
+    run.errors = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_create(&consumer, NULL, Consumer, &run);
+    pthread_create(&producer, NULL, Producer, &run);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    *errors = run.errors;
+    *highWater = RingBuf_High_Water(&ring);
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+
+int main(int argc, char *argv[]) {
+    static const char *const names[] = { "stress (mixed)", "single push/pop", "bulk push/pop" };
+    unsigned long elements = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_ELEMENTS;
+    unsigned long errors, totalErrors = 0;
+    unsigned int highWater;
+    double seconds;
+    int mode;
+
+    if (elements == 0) {
+        fprintf(stderr, "usage: %s [elements per run]\n", argv[0]);
+        return 2;
+    }
+
+    printf("%lu elements per run, capacity %d, bulk size %d\n", elements, RING_CAPACITY, BULK_SIZE);
+
+    for (mode = MODE_STRESS; mode <= MODE_BULK; mode++) {
+        seconds = Run((RunMode) mode, elements, &errors, &highWater);
+        totalErrors += errors;
+
+        printf("%-16s %8.2f M elements/s   high water %3u / %d   errors %lu\n",
+               names[mode], elements / seconds / 1e6, highWater, RING_CAPACITY, errors);
+    }
+
+    return totalErrors != 0 ? 1 : 0;
+}
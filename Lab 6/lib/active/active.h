@@ -0,0 +1,93 @@
+#ifndef MCU_ACTIVE
+#define MCU_ACTIVE
+
+#include <stdint.h>
+
+#include "ringbuf/ringbuf.h"
+
+// Active objects: each component owns an event queue & a handler that processes 1 event at a time
+// - Interrupt handlers & other active objects only post events, so they never wait on each other
+// - Posting pends the PendSV exception (lowest priority), whose handler runs the handler of the most urgent
+//   active object with events queued, to completion, until every queue is empty
+// - Handlers never preempt each other (only interrupt handlers preempt them), so the state of an active
+//   object needs no locking as long as it's only touched by its own handler
+// - The core sleeps whenever no interrupt or handler is running (see Active_Run())
+//
+// Number of active objects (each one needs a distinct priority from 0 to ACTIVE_MAX_OBJECTS - 1)
+#ifndef ACTIVE_MAX_OBJECTS
+#define ACTIVE_MAX_OBJECTS 8
+#endif
+
+// Interrupt priority of the tick (TIMER2A_Handler, 0 - 6, 0 = most urgent), with the dispatcher (PendSV) always
+// at the lowest level (7)
+// NOTE: Overridable per project, i.e. via the C/C++ "Define" field in the Keil project options
+#ifndef ACTIVE_TICK_PRIORITY
+#define ACTIVE_TICK_PRIORITY 6
+#endif
+
+// Signals reserved by the framework (the ones of the active objects start at ACTIVE_SIGNAL_USER)
+#define ACTIVE_SIGNAL_START 0   // First event of every active object, posted by Active_Start()
+#define ACTIVE_SIGNAL_USER  1
+
+typedef struct {
+    uint8_t signal;
+    uint32_t param;
+    void *data;     // Optional block from MemPool_Alloc(), freed once the handler returns
+} Active_Event;
+
+typedef struct Active Active;
+
+// Processes 1 event of 'self', running to completion
+typedef void (*Active_Handler)(Active *self, const Active_Event *event);
+
+struct Active {
+    RingBuf queue;
+    Active_Handler handler;
+    unsigned int priority;
+    unsigned long droppedEvents;
+};
+
+// Posts an event with 'signal' to 'target' every tick count, once or periodically
+typedef struct Active_Timer {
+    struct Active_Timer *next;
+    Active *target;
+    uint8_t signal;
+    uint32_t remaining;
+    uint32_t period;
+    int armed;
+} Active_Timer;
+
+
+// Setup the dispatcher (PendSV) & the time base for timers, ticking 'tickHz' times per second (Timer 2A)
+extern void Active_Init(uint32_t sysClockHz, uint32_t tickHz);
+
+// Keep ticking 'tickHz' times per second on a new system clock frequency (a Clock_Listener, see clock/clock.h)
+// NOTE: The tick in progress restarts, so it gets stretched by up to 1 tick
+extern void Active_Set_Clock(uint32_t sysClockHz);
+
+// Register 'active' with 'priority' (0 = most urgent, unlike the NVIC each priority belongs to 1 object)
+// and an event queue of 'queueCapacity' events (a power of 2) in 'queueStorage', then post it the
+// ACTIVE_SIGNAL_START event, returning 0 if the priority is taken or the capacity isn't a power of 2
+extern int Active_Start(Active *active, unsigned int priority, Active_Event *queueStorage,
+                        unsigned int queueCapacity, Active_Handler handler);
+
+// Queue an event for 'target', returning 0 (and freeing 'data') if its queue is full
+// NOTE: Safe to call from any active object & interrupt handler at or below INTERRUPT_FRAMEWORK_PRIORITY (see
+// "Interrupt.h")
+extern int Active_Post(Active *target, uint8_t signal, uint32_t param, void *data);
+
+// Post 'signal' to 'target' after 'ticks' ticks, then every 'period' ticks (0 = only once)
+// NOTE: Timers must start out zeroed (i.e. static), and only be armed or disarmed from active objects or the
+// main code (not from interrupt handlers). Re-arming an armed timer restarts it.
+extern void Active_Timer_Arm(Active_Timer *timer, Active *target, uint8_t signal, uint32_t ticks, uint32_t period);
+extern void Active_Timer_Disarm(Active_Timer *timer);
+
+// Number of ticks since Active_Init()
+// NOTE: The counter wraps around after 2^32 ticks, so compare ticks by subtraction, i.e. (now - start) >= n
+extern uint32_t Active_Get_Ticks(void);
+
+// Hand the core over to the interrupt handlers & active objects for good, sleeping whenever they're idle
+extern void Active_Run(void);
+
+
+#endif /* MCU_ACTIVE */
@@ -0,0 +1,155 @@
+#include <stdint.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "nvic/Interrupt.h"
+#include "power/power.h"
+#include "adc_stream.h"
+
+
+// Ping-pong batches: ADC1SS3_Handler fills one while the main code works on the other
+static uint16_t batches[2][ADC_STREAM_BATCH_SAMPLES];
+static uint32_t batchFirstSample[2];
+
+// Batch being filled by the handler & number of samples in it
+static unsigned int fillBatch = 0;
+static unsigned int fillCount = 0;
+
+// Batch handed over to the main code (-1 = none), set by the handler & cleared by ADC_Stream_Release_Batch()
+static volatile int readyBatch = -1;
+
+// Total number of samples taken, used as timestamp
+static uint32_t sampleCount = 0;
+
+static volatile unsigned long droppedBatches = 0;
+
+// Sample rate given to ADC_Stream_Init(), kept for ADC_Stream_Set_Clock()
+static uint32_t streamSampleRateHz;
+
+
+// Setup Timer 1A to trigger an ADC conversion every 'period' cycles
+static void ADC_Stream_Timer_Init(uint32_t period) {
+    // Enable clock for Timer 1
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R1;
+
+    // Wait until Timer 1 clock is fully initialized
+    while ((SYSCTL_PRTIMER_R & SYSCTL_PRTIMER_R1) == 0);
+
+    // Disable Timer A during setup
+    TIMER1_CTL_R = 0;
+
+    // 32-bit periodic mode, counting down from 'period - 1'
+    TIMER1_CFG_R = 0;
+    TIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+    TIMER1_TAILR_R = period - 1;
+
+    // Start Timer A with its time-out routed to the ADC trigger instead of an interrupt
+    TIMER1_CTL_R = (TIMER_CTL_TAOTE | TIMER_CTL_TASTALL | TIMER_CTL_TAEN);
+}
+
+
+// Setup ADC 1 SS3 to take 1 internal temperature sensor sample per timer trigger
+static void ADC_Stream_ADC_Init(void) {
+    // Enable clock for ADC module 1
+    SYSCTL_RCGCADC_R |= SYSCTL_RCGCADC_R1;
+
+    // Wait until ADC 1 clock is fully initialized
+    while ((SYSCTL_PRADC_R & SYSCTL_PRADC_R1) == 0);
+
+    // Disable Sample Sequence 3 (SS3) during configuration
+    ADC1_ACTSS_R &= ~ADC_ACTSS_ASEN3;
+
+    // Set the sampling trigger to be the timer
+    ADC1_EMUX_R = (ADC1_EMUX_R & ~ADC_EMUX_EM3_M) | ADC_EMUX_EM3_TIMER;
+
+    // Take only 1 sample per trigger from the internal temperature sensor, interrupting once it's done
+    ADC1_SSMUX3_R = 0;
+    ADC1_SSCTL3_R = (ADC_SSCTL3_TS0 | ADC_SSCTL3_IE0 | ADC_SSCTL3_END0);
+
+    // Clear any prior interrupts & unmask the SS3 interrupt
+    ADC1_ISC_R = ADC_ISC_IN3;
+    ADC1_IM_R |= ADC_IM_MASK3;
+
+    // Re-enable Sample Sequence 3 (SS3)
+    ADC1_ACTSS_R |= ADC_ACTSS_ASEN3;
+
+    // Set interrupt priority for ADC 1 SS3 to level 4 (above the UART, so no sample gets lost while sending) & enable it
+    NVIC_SET_PRIORITY(ADC1SS3_IRQn, 4);
+    NVIC_ENABLE_IRQ(ADC1SS3_IRQn);
+}
+
+
+// Setup ADC 1 to sample the internal temperature sensor at 'sampleRateHz', triggered by Timer 1A
+void ADC_Stream_Init(uint32_t sysClockHz, uint32_t sampleRateHz) {
+    fillBatch = 0;
+    fillCount = 0;
+    readyBatch = -1;
+    sampleCount = 0;
+    streamSampleRateHz = sampleRateHz;
+
+    ADC_Stream_ADC_Init();
+    ADC_Stream_Timer_Init(sysClockHz / sampleRateHz);
+}
+
+
+// Keep sampling at 'sampleRateHz' on a new system clock frequency
+// NOTE: The ADC conversion clock itself comes straight from the PLL (400 MHz / 25 = 16 MHz), so only the
+// trigger timer needs rescaling
+void ADC_Stream_Set_Clock(uint32_t sysClockHz) {
+    TIMER1_TAILR_R = sysClockHz / streamSampleRateHz - 1;
+}
+
+
+// NOTE: This is meant to be implicitly overriden
+void ADC1SS3_Handler(void) {
+    // Clear the conversion flag (ISC is write-1-to-clear, so a direct store is enough)
+    ADC1_ISC_R = ADC_ISC_IN3;
+
+    if (fillCount == 0)
+        batchFirstSample[fillBatch] = sampleCount;
+
+    // Read the ADC coversion result from the SS3 FIFO queue
+    batches[fillBatch][fillCount++] = (uint16_t) (ADC1_SSFIFO3_R & 0xFFF);
+    sampleCount++;
+
+    if (fillCount < ADC_STREAM_BATCH_SAMPLES)
+        return;
+
+    fillCount = 0;
+
+    if (readyBatch >= 0) {
+        // The main code still holds the other batch, so refill this one (the gap shows up in the timestamps)
+        droppedBatches++;
+        return;
+    }
+
+    // Hand the full batch over & continue with the other one
+    readyBatch = (int) fillBatch;
+    fillBatch ^= 1;
+}
+
+
+// Sleep until a batch of samples is ready, returning it along with the index of its first sample
+const uint16_t *ADC_Stream_Wait_Batch(uint32_t *firstSample) {
+    int batch;
+
+    __disable_irq();
+    while (readyBatch < 0)
+        Power_Sleep();
+    __enable_irq();
+
+    batch = readyBatch;
+    *firstSample = batchFirstSample[batch];
+    return batches[batch];
+}
+
+
+// Hand the batch returned by ADC_Stream_Wait_Batch() back for sampling
+void ADC_Stream_Release_Batch(void) {
+    readyBatch = -1;
+}
+
+
+// Number of batches dropped so far because the previous batch hadn't been released in time
+unsigned long ADC_Stream_Dropped_Batches(void) {
+    return droppedBatches;
+}
@@ -0,0 +1,32 @@
+#ifndef ADC_STREAM
+#define ADC_STREAM
+
+#include <stdint.h>
+
+// Number of samples per batch (and per stream frame)
+// NOTE: Must be even and at most STREAM_MAX_SAMPLES (see stream/stream_frame.h)
+#ifndef ADC_STREAM_BATCH_SAMPLES
+#define ADC_STREAM_BATCH_SAMPLES 32
+#endif
+
+
+// Setup ADC 1 to sample the internal temperature sensor at 'sampleRateHz', triggered by Timer 1A
+// NOTE: Runs independently of ADC 0, so Get_ADC_Temp_Reading() can still be used
+extern void ADC_Stream_Init(uint32_t sysClockHz, uint32_t sampleRateHz);
+
+// Keep sampling at 'sampleRateHz' on a new system clock frequency (a Clock_Listener, see clock/clock.h)
+extern void ADC_Stream_Set_Clock(uint32_t sysClockHz);
+
+// Sleep until a batch of ADC_STREAM_BATCH_SAMPLES samples is ready, returning it along with the index of
+// its first sample (counted since ADC_Stream_Init())
+// NOTE: The batch stays valid until ADC_Stream_Release_Batch(), and this must not be called with interrupts disabled
+extern const uint16_t *ADC_Stream_Wait_Batch(uint32_t *firstSample);
+
+// Hand the batch returned by ADC_Stream_Wait_Batch() back for sampling
+extern void ADC_Stream_Release_Batch(void);
+
+// Number of batches dropped so far because the previous batch hadn't been released in time
+extern unsigned long ADC_Stream_Dropped_Batches(void);
+
+
+#endif /* ADC_STREAM */
@@ -1,38 +1,25 @@
 #include <stdint.h>
+#include <stddef.h>
 
 #include "mcu/tm4c123gh6pm.h"
+#include "gpio/gpio.h"
+#include "nvic/Interrupt.h"
+#include "power/power.h"
 #include "adc_temp.h"
 
 
-// Setup GPIO Port E and pin PE3, using internal temperature sensor
-void Setup_Port_E_Pins(void) {
-    // Enable Port E clock
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R4;
+// Pin configuration for GPIO Port E and pin PE3, using internal temperature sensor
+const GPIO_PinConfig ADC_TEMP_PIN_CONFIG[] = {
+    {GPIO_PORT_E, INTERNAL_TEMP_SENSOR_PIN, GPIO_INPUT | GPIO_ANALOG, 0},
+    GPIO_PIN_CONFIG_END
+};
 
-    // Wait until Port E clock is fully initialized
-    while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R4) == 0);
+// Latest SS3 conversion result & completion flag (set by ADC0SS3_Handler)
+static volatile uint32_t adcSample = 0;
+static volatile int adcSampleReady = 0;
 
-    // Unlock Port E configuration
-    GPIO_PORTE_LOCK_R = GPIO_LOCK_KEY;
-
-    // Set commit register to only work with pins PE3
-    GPIO_PORTE_CR_R = INTERNAL_TEMP_SENSOR_PIN;
-
-    // Set input buttons pins (PE3) as inputs
-    GPIO_PORTE_DIR_R &= ~INTERNAL_TEMP_SENSOR_PIN;
-
-    // Enable analog functionality for PE3
-    GPIO_PORTE_AMSEL_R |= INTERNAL_TEMP_SENSOR_PIN;
-
-    // Disable digital functionality for PE3
-    GPIO_PORTE_DEN_R &= ~INTERNAL_TEMP_SENSOR_PIN;
-
-    // Enable all alternate functionality for PE3
-    GPIO_PORTE_AFSEL_R |= INTERNAL_TEMP_SENSOR_PIN;
-
-    // Disable all special functionality for PE3
-    GPIO_PORTE_PCTL_R &= ~INTERNAL_TEMP_SENSOR_PIN;
-}
+// Called with the result of the conversion in progress, if started by ADC_Temp_Start_Reading()
+static volatile ADC_Temp_Callback adcCallback = NULL;
 
 
 // Setup ADC 0 module, using internal temperature sensor
@@ -59,6 +46,12 @@ void ADC0_Module_Init(void) {
     // NOTE: The internal temperature sensor does not have a differential option
     ADC0_SSCTL3_R = (ADC_SSCTL3_TS0 | ADC_SSCTL3_IE0 | ADC_SSCTL3_END0);
 
+    // Forward the SS3 completion flag to the interrupt controller, so a conversion can wake up the core
+    ADC0_ISC_R = ADC_ISC_IN3;
+    ADC0_IM_R |= ADC_IM_MASK3;
+    NVIC_SET_PRIORITY(ADC0SS3_IRQn, 5);
+    NVIC_ENABLE_IRQ(ADC0SS3_IRQn);
+
     // Re-enable Sample Sequence 3 (SS3)
     // NOTE: When querying for the ADC value from PE3, SSE3 will take 1 sample
     ADC0_ACTSS_R |= ADC_ACTSS_ASEN3;
@@ -66,33 +59,56 @@ void ADC0_Module_Init(void) {
 
 
 // Fully initialize ADC module and internal temperature sensor
+// NOTE: The sensor pin (ADC_TEMP_PIN_CONFIG) must be configured via GPIO_Init_Pins() beforehand
 void ADC_Temp_Sensor_Init(void) {
-    // Setup GPIO Port E and pin PE3, using internal temperature sensor
-    Setup_Port_E_Pins();
-
     // Setup ADC0 module, using internal temperature sensor
     ADC0_Module_Init();
 }
 
 
+// NOTE: This is meant to be implicitly overriden
+void ADC0SS3_Handler(void) {
+    // Read the ADC coversion result from the SS3 FIFO queue
+    adcSample = ADC0_SSFIFO3_R;
+
+    // Clear the conversion flag to allow sampling from ADC0 again (ISC is write-1-to-clear)
+    ADC0_ISC_R = ADC_ISC_IN3;
+
+    adcSampleReady = 1;
+
+    if (adcCallback != NULL)
+        adcCallback(adcSample);
+}
+
+
 // Fetch raw ADC value of internal temperature sensor
 //   Output range (unsigned int): [0, 4095]
+// NOTE: Must not be called with interrupts disabled
 uint32_t Get_ADC_Temp_Reading(void) {
-    uint32_t adcValue;
+    adcSampleReady = 0;
+    adcCallback = NULL;
 
     // Enable SS3 conversion or start sampling data from Ain0
     ADC0_PSSI_R = ADC_PSSI_SS3;
 
-    // Poll the Raw Interrupt Status (RIS) until the ADC sample conversion has completed
-    while ((ADC0_RIS_R & ADC_RIS_INR3) == 0);
+    // Sleep until the SS3 interrupt signals that the ADC sample conversion has completed
+    __disable_irq();
+    while (!adcSampleReady)
+        Power_Sleep();
+    __enable_irq();
+
+    return adcSample;
+}
 
-    // Read the ADC coversion result from the SS3 FIFO queue
-    adcValue = ADC0_SSFIFO3_R;
 
-    // Clear the conversion flag to allow sampling from ADC0 again
-    ADC0_ISC_R |= ADC_ISC_IN3;
+// Start sampling the internal temperature sensor without waiting, calling 'onDone' (from ADC0SS3_Handler) with the
+// raw ADC value once the conversion is done
+void ADC_Temp_Start_Reading(ADC_Temp_Callback onDone) {
+    adcSampleReady = 0;
+    adcCallback = onDone;
 
-    return adcValue;
+    // Enable SS3 conversion or start sampling data from Ain0
+    ADC0_PSSI_R = ADC_PSSI_SS3;
 }
 
 
@@ -3,17 +3,25 @@
 
 #include <stdint.h>
 
+#include "gpio/gpio.h"
+
 // Pin definitions
 #define INTERNAL_TEMP_SENSOR_PIN    0x08u // = 0x08 (PE3)
 
 
+// Pin configuration table (to be passed to GPIO_Init_Pins())
+extern const GPIO_PinConfig ADC_TEMP_PIN_CONFIG[];
+
 // Setup function definitions
-extern void Setup_Port_E_Pins(void);
 extern void ADC0_Module_Init(void);
 extern void ADC_Temp_Sensor_Init(void);
 
+// Called from ADC0SS3_Handler with the raw reading once a conversion started by ADC_Temp_Start_Reading() is done
+typedef void (*ADC_Temp_Callback)(uint32_t adcReading);
+
 // Temperature reading function definitions
 extern uint32_t Get_ADC_Temp_Reading(void);
+extern void ADC_Temp_Start_Reading(ADC_Temp_Callback onDone);
 extern float Convert_Temp_Voltage_Celsius(float vRefPos, float vRefNeg, uint32_t adcReading);
 
 
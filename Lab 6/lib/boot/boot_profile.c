@@ -0,0 +1,82 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "nvic/Interrupt.h"
+#include "boot_profile.h"
+
+// GPTM Clock Configuration register of Wide Timer 4 (missing from the MCU header)
+// NOTE: ALTCLK clocks the timer from the alternate clock (ALTCLKCFG), which is the PIOSC out of reset
+#define WTIMER4_CC_R        (*((volatile unsigned long *)0x4004EFC8))
+#define TIMER_CC_ALTCLK     0x00000001
+
+
+typedef struct {
+    const char *phase;
+    uint32_t ticks;
+} Boot_Profile_Entry;
+
+static Boot_Profile_Entry marks[BOOT_PROFILE_MAX_MARKS];
+static unsigned int markCount = 0;
+
+
+// Start WTIMER4A as a free-running 32-bit up counter off the PIOSC (wraps after ~268 s)
+void Boot_Profile_Start(void) {
+    markCount = 0;
+
+    // Enable clock for Wide Timer 4
+    SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R4;
+
+    // Wait until Wide Timer 4 clock is fully initialized
+    while ((SYSCTL_PRWTIMER_R & SYSCTL_PRWTIMER_R4) == 0);
+
+    // Disable Timer A during setup
+    WTIMER4_CTL_R = 0;
+
+    // Use Timer A on its own (32 bits wide on a wide timer) in periodic mode, counting up from 0
+    WTIMER4_CFG_R = TIMER_CFG_16_BIT;
+    WTIMER4_TAMR_R = (TIMER_TAMR_TAMR_PERIOD | TIMER_TAMR_TACDIR);
+    WTIMER4_TAILR_R = 0xFFFFFFFF;
+    WTIMER4_CC_R = TIMER_CC_ALTCLK;
+
+    // Start Timer A, pausing it while the debugger halts the core
+    WTIMER4_CTL_R = (TIMER_CTL_TAEN | TIMER_CTL_TASTALL);
+}
+
+
+// Timestamp the end of boot phase 'phase'
+void Boot_Profile_Mark(const char *phase) {
+    uint32_t primask = Interrupt_Disable_Save();
+
+    if (markCount < BOOT_PROFILE_MAX_MARKS) {
+        marks[markCount].phase = phase;
+        marks[markCount].ticks = WTIMER4_TAV_R;
+        markCount++;
+    }
+
+    Interrupt_Restore(primask);
+}
+
+
+// Send every mark as a "boot,<phase>,<us since start>,<us since previous mark>" line via 'writeString'
+void Boot_Profile_Write(unsigned int (*writeString)(const char *str)) {
+    char line[48];
+    uint32_t previous = 0;
+    unsigned int i;
+
+    for (i = 0; i < markCount; i++) {
+        sprintf(line, "boot,%.16s,%lu,%lu\r\n", marks[i].phase,
+                (unsigned long) (marks[i].ticks / BOOT_PROFILE_TICKS_PER_US),
+                (unsigned long) ((marks[i].ticks - previous) / BOOT_PROFILE_TICKS_PER_US));
+        writeString(line);
+
+        previous = marks[i].ticks;
+    }
+}
+
+
+// Stop the timer & turn off its clock
+void Boot_Profile_Stop(void) {
+    WTIMER4_CTL_R = 0;
+    SYSCTL_RCGCWTIMER_R &= ~SYSCTL_RCGCWTIMER_R4;
+}
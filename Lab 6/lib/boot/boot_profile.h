@@ -0,0 +1,38 @@
+#ifndef MCU_BOOT_PROFILE
+#define MCU_BOOT_PROFILE
+
+#include <stdint.h>
+
+// Boot-time profiling: timestamps the end of each named boot phase with a free-running wide timer (WTIMER4A),
+// to see where the time to the first reading goes
+// - The timer runs off the precision internal oscillator (PIOSC, 16 MHz) instead of the system clock, so the
+//   timestamps stay comparable across the switch from the crystal to the PLL (and any later clock switch)
+// - Timestamps count from Boot_Profile_Start(), so the startup code running before main isn't included
+//
+// Number of phases that can be marked (any further marks are dropped)
+#ifndef BOOT_PROFILE_MAX_MARKS
+#define BOOT_PROFILE_MAX_MARKS 12
+#endif
+
+// Timer ticks per 1 us (PIOSC = 16 MHz)
+#define BOOT_PROFILE_TICKS_PER_US 16UL
+
+
+// Start the timestamp timer (first thing in main)
+// NOTE: The timer must keep its clock while sleeping until Boot_Profile_Stop(), so list SYSCTL_SCGCWTIMER_S4
+// in the sleep clocks given to Power_Init()
+extern void Boot_Profile_Start(void);
+
+// Timestamp the end of boot phase 'phase' (only the pointer is kept, so pass a string literal)
+// NOTE: Safe to call from any interrupt handler
+extern void Boot_Profile_Mark(const char *phase);
+
+// Send every mark as a "boot,<phase>,<us since start>,<us since previous mark>" line via 'writeString'
+// (i.e. Uart_Write_String)
+extern void Boot_Profile_Write(unsigned int (*writeString)(const char *str));
+
+// Stop the timer & turn off its clock
+extern void Boot_Profile_Stop(void);
+
+
+#endif /* MCU_BOOT_PROFILE */
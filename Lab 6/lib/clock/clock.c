@@ -0,0 +1,113 @@
+#include <stdint.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "nvic/Interrupt.h"
+#include "pll/PLL.h"
+#include "clock.h"
+
+
+static Clock_Listener listeners[CLOCK_MAX_LISTENERS];
+static unsigned int listenerCount = 0;
+
+static Clock_Listener preparers[CLOCK_MAX_LISTENERS];
+static unsigned int preparerCount = 0;
+
+// Current SYSDIV2 divisor & the frequency it gives
+static uint8_t currentDivisor;
+static volatile uint32_t currentHz;
+
+
+// Configure the system to get its clock from the PLL (see PLL_Init())
+void Clock_Init(uint8_t sysdiv2_divisor) {
+    Clock_Init_Begin(sysdiv2_divisor);
+    Clock_Init_End();
+}
+
+
+// Power up the PLL, leaving the system on the crystal until Clock_Init_End()
+void Clock_Init_Begin(uint8_t sysdiv2_divisor) {
+    PLL_Start(sysdiv2_divisor);
+    currentDivisor = sysdiv2_divisor;
+}
+
+
+// Wait for the PLL to lock & switch the system clock over to it
+void Clock_Init_End(void) {
+    PLL_Wait_Lock();
+    currentHz = PLL_SYSDIV2_TO_HZ(currentDivisor);
+}
+
+
+// Call 'listener' after every switch from now on, returning 0 if all CLOCK_MAX_LISTENERS are taken
+int Clock_Add_Listener(Clock_Listener listener) {
+    uint32_t primask;
+    int added = 0;
+
+    primask = Interrupt_Disable_Save();
+
+    if (listenerCount < CLOCK_MAX_LISTENERS) {
+        listeners[listenerCount++] = listener;
+        added = 1;
+    }
+
+    Interrupt_Restore(primask);
+    return added;
+}
+
+
+// Call 'preparer' with the new frequency before every switch from now on, returning 0 if all
+// CLOCK_MAX_LISTENERS are taken
+int Clock_Add_Preparer(Clock_Listener preparer) {
+    uint32_t primask;
+    int added = 0;
+
+    primask = Interrupt_Disable_Save();
+
+    if (preparerCount < CLOCK_MAX_LISTENERS) {
+        preparers[preparerCount++] = preparer;
+        added = 1;
+    }
+
+    Interrupt_Restore(primask);
+    return added;
+}
+
+
+// Switch the system clock to another SYSDIV2 divisor & rescale every listener
+int Clock_Set(uint8_t sysdiv2_divisor) {
+    uint32_t primask;
+    unsigned int i;
+
+    if (sysdiv2_divisor < PLL_SYSDIV2_MIN)
+        return 0;
+
+    if (sysdiv2_divisor == currentDivisor)
+        return 1;
+
+    // Let the preparers finish up at the old rate, before interrupts get disabled for the switch itself
+    for (i = 0; i < preparerCount; i++)
+        preparers[i](PLL_SYSDIV2_TO_HZ(sysdiv2_divisor));
+
+    // Nested calls (i.e. from a handler preempting another switch) can't interleave, since the whole switch
+    // runs with interrupts disabled
+    primask = Interrupt_Disable_Save();
+
+    if (sysdiv2_divisor != currentDivisor) {
+        PLL_Set_Divisor(sysdiv2_divisor);
+
+        currentDivisor = sysdiv2_divisor;
+        currentHz = PLL_SYSDIV2_TO_HZ(sysdiv2_divisor);
+
+        for (i = 0; i < listenerCount; i++)
+            listeners[i](currentHz);
+    }
+
+    Interrupt_Restore(primask);
+    return 1;
+}
+
+
+// Current system clock frequency (in Hz)
+uint32_t Clock_Get_Hz(void) {
+    return currentHz;
+}
@@ -0,0 +1,49 @@
+#ifndef MCU_CLOCK
+#define MCU_CLOCK
+
+#include <stdint.h>
+
+// Run-time clock scaling on top of the PLL (see "PLL.h"): run slow while waiting & fast for bursts of work
+// - Clock_Set() switches the SYSDIV2 divisor while the PLL stays locked, so a switch only takes a handful of
+//   cycles plus the time the listeners take (no waiting for the PLL to lock again)
+// - Every driver timed off the system clock (SysTick delays, timers, UART baud rate) registers a listener, which
+//   is called with the new frequency right after the switch
+// - The switch & the listeners run with interrupts disabled, so no handler ever runs on stale timing
+// - Drivers that have to finish something at the old rate first (i.e. bytes in the UART FIFO) register a
+//   preparer instead, which is called before the switch with interrupts still enabled
+//
+// Number of listeners (& of preparers) that can be registered
+#ifndef CLOCK_MAX_LISTENERS
+#define CLOCK_MAX_LISTENERS 8
+#endif
+
+// Rescales a driver to the new system clock frequency (in Hz)
+// NOTE: Runs with interrupts disabled, so it must be short & must not wait on interrupts
+typedef void (*Clock_Listener)(uint32_t sysClockHz);
+
+
+// Configure the system to get its clock from the PLL (see PLL_Init())
+extern void Clock_Init(uint8_t sysdiv2_divisor);
+
+// Same as Clock_Init(), split in 2 halves so other setup can overlap the PLL lock time (see PLL_Start())
+// NOTE: The system runs off the 16 MHz crystal in between, so Clock_Get_Hz() only holds once both are done
+extern void Clock_Init_Begin(uint8_t sysdiv2_divisor);
+extern void Clock_Init_End(void);
+
+// Call 'listener' after every switch from now on, returning 0 if all CLOCK_MAX_LISTENERS are taken
+extern int Clock_Add_Listener(Clock_Listener listener);
+
+// Call 'preparer' with the new frequency before every switch from now on (with interrupts as the caller of
+// Clock_Set() left them, so it may wait on hardware), returning 0 if all CLOCK_MAX_LISTENERS are taken
+extern int Clock_Add_Preparer(Clock_Listener preparer);
+
+// Switch the system clock to another SYSDIV2 divisor & rescale every listener, returning 0 if it's out of range
+// NOTE: Switching to the current divisor does nothing. Must not be called while a SysTick delay is in progress
+// (i.e. from an interrupt handler preempting one)
+extern int Clock_Set(uint8_t sysdiv2_divisor);
+
+// Current system clock frequency (in Hz)
+extern uint32_t Clock_Get_Hz(void);
+
+
+#endif /* MCU_CLOCK */
@@ -2,8 +2,13 @@
 
 #include "mcu/tm4c123gh6pm.h"
 #include "timing_util/timing.h"
+#include "gpio/gpio.h"
 #include "lcd_driver.h"
 
+// Delays (in whole ms ticks) of the protothread versions, the slow commands (clear & return home) taking 1.52 ms
+#define LCD_SLOW_CMD_TICKS  2
+#define LCD_CHAR_TICKS      500
+
 
 /*
  * I/O Setup
@@ -19,10 +24,8 @@
  */
 
 
+// NOTE: The LCD pins (LCD_PIN_CONFIG) must be configured via GPIO_Init_Pins() beforehand
 void LCD_4Bits_Init(void) {
-    // Setup LCD GPIO Pins
-    Setup_LCD_GPIO_Pins();
-
     // Sets cursor to beginning of display and unshifts display if set before
     LCD_4Bits_Cmd(LCD_RETURN_HOME); // 0x02
 
@@ -41,37 +44,11 @@ void LCD_4Bits_Init(void) {
 }
 
 
-void Setup_LCD_GPIO_Pins(void) {
-    // Enable Port B clock
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R1;
-
-    // Wait until Port B clock is fully initialized
-    while ((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R1) == 0);
-
-    // Unlock Port B configuration
-    GPIO_PORTB_LOCK_R = GPIO_LOCK_KEY;
-
-    // Set commit register to only work with pins PB0 - PB2 & PB4 - PB7
-    GPIO_PORTB_CR_R = LCD_ALL_PINS;
-
-    // Set all LED pins (PB0 - PB2 & PB4 - PB7) as outputs
-    GPIO_PORTB_DIR_R |= LCD_ALL_PINS;
-
-    // Disable all analog functionality for PB0 - PB2 & PB4 - PB7
-    GPIO_PORTB_AMSEL_R &= ~LCD_ALL_PINS;
-
-    // Enable digital functionality for PB0 - PB2 & PB4 - PB7
-    GPIO_PORTB_DEN_R |= LCD_ALL_PINS;
-
-    // Disable all alternate functionality for PB0 - PB2 & PB4 - PB7
-    GPIO_PORTB_AFSEL_R &= ~LCD_ALL_PINS;
-
-    // Disable all special functionality for PB0 - PB2 & PB4 - PB7
-    GPIO_PORTB_PCTL_R &= ~LCD_ALL_PINS;
-
-    // Lock Port B configuration
-    GPIO_PORTB_LOCK_R = 0;
-}
+// Pin configuration for the LCD control pins (PB0 - PB2) & data pins (PB4 - PB7)
+const GPIO_PinConfig LCD_PIN_CONFIG[] = {
+    {GPIO_PORT_B, LCD_ALL_PINS, GPIO_OUTPUT, 0},
+    GPIO_PIN_CONFIG_END
+};
 
 
 void LCD_Write4Bits(uint8_t data, uint8_t control) {
@@ -81,13 +58,15 @@ void LCD_Write4Bits(uint8_t data, uint8_t control) {
     uint8_t dataPacket = ((data & 0xF0) | (control & 0x0F));
 
     // Send both data and the control signals to LCD through the GPIODATA register. Secure the sent signals by EN.
-    GPIO_PORTB_DATA_R = (dataPacket | LCD_EN_ENABLE_MODE);
+    // NOTE: Only the LCD pins are written, leaving PB3 untouched
+    GPIO_WRITE_PINS(GPIO_PORT_B, LCD_ALL_PINS, (dataPacket | LCD_EN_ENABLE_MODE));
 
     // Allow some delay to let sent data be processed by LCD
     SysTick_Wait_1us(3);
 
     // Set back to the data without EN.
-    GPIO_PORTB_DATA_R ^= LCD_EN_ENABLE_MODE;
+    // NOTE: Only the EN pin is written, so the strobe cannot disturb any other pin on Port B
+    GPIO_CLEAR_PINS(GPIO_PORT_B, LCD_EN_PIN);
 }
 
 
@@ -137,3 +116,55 @@ void LCD_4Bits_OutputString(char* str) {
         i++;
     }
 }
+
+
+// Send a command without waiting for the LCD to process it
+static void LCD_4Bits_Cmd_No_Wait(uint8_t command) {
+    LCD_Write8Bits_4BitMode(command, (LCD_RW_WRITE_MODE | LCD_RS_COMMAND_MODE));
+}
+
+
+// Same sequence as LCD_4Bits_Init(), but sleeping through the slow commands (return home & clear) while other
+// active objects run, and only busy waiting the 37 us of the fast ones
+int LCD_4Bits_Init_Thread(PT *pt) {
+    PT_BEGIN(pt);
+
+    // Sets cursor to beginning of display and unshifts display if set before
+    LCD_4Bits_Cmd_No_Wait(LCD_RETURN_HOME); // 0x02
+    AWAIT_TICKS(pt, LCD_SLOW_CMD_TICKS);
+
+    // Sets LCD to operate in 4-bit mode, using 2 lines and 5 x 8 fonts
+    // NOTE: Function set command MUST be run first before any other LCD commands
+    LCD_4Bits_Cmd(LCD_FUNCTION_SET | LCD_4_BIT_MODE | LCD_2_LINE_MODE | LCD_5x8_FONT_MODE); // 0x28
+
+    // Set cursor to increment automatically after each character insert
+    LCD_4Bits_Cmd(LCD_ENTRY_MODE_SET | LCD_ENTRY_CURSOR_AUTO_MOVE_RIGHT | LCD_ENTRY_NO_SHIFT_DISPLAY); // 0x06
+
+    // Turn on the display & cursor and set cursor to blinking
+    LCD_4Bits_Cmd(LCD_DISPLAY_CTRL | LCD_DISPLAY_FULL_ON | LCD_DISPLAY_CURSOR_ON | LCD_DISPLAY_BLINKING_CURSOR_ON); // 0x0F
+
+    // Clear the LCD display
+    LCD_4Bits_Cmd_No_Wait(LCD_CLEAR_DISPLAY); // 0x01
+    AWAIT_TICKS(pt, LCD_SLOW_CMD_TICKS);
+
+    PT_END(pt);
+}
+
+
+// Same as LCD_4Bits_OutputString(), but sleeping in between characters while other active objects run
+int LCD_4Bits_OutputString_Thread(PT *pt, const char *str) {
+    // NOTE: Static, since local variables don't survive a wait (only 1 LCD, so only 1 thread at a time)
+    static int i;
+
+    PT_BEGIN(pt);
+
+    for (i = 0; str[i] != '\0' && i < 16; i++) {
+        // Send the current character to the LCD
+        LCD_4Bits_Data(str[i]);
+
+        // Allow some delay to let the LCD display the character
+        AWAIT_TICKS(pt, LCD_CHAR_TICKS);
+    }
+
+    PT_END(pt);
+}
@@ -3,6 +3,9 @@
 
 #include <stdint.h>
 
+#include "gpio/gpio.h"
+#include "pt/pt.h"
+
 // LCD Datasheet: https://www.sparkfun.com/datasheets/LCD/HD44780.pdf
 
 // LCD pin definitions
@@ -72,14 +75,22 @@
 #define LCD_EN_DISABLE_MODE	0x00u
 
 
+// Pin configuration table for LCD device driver (to be passed to GPIO_Init_Pins())
+extern const GPIO_PinConfig LCD_PIN_CONFIG[];
+
 // Function signatures for LCD device driver
 extern void LCD_4Bits_Init(void);
-extern void Setup_LCD_GPIO_Pins(void);
 extern void LCD_Write4Bits(uint8_t data, uint8_t control);
 extern void LCD_Write8Bits_4BitMode(uint8_t data, uint8_t control);
 extern void LCD_4Bits_Cmd(uint8_t command);
 extern void LCD_4Bits_Data(uint8_t data);
 extern void LCD_4Bits_OutputString(char* str);
 
+// Protothread versions of LCD_4Bits_Init() & LCD_4Bits_OutputString() (see "pt/pt.h"), giving the CPU back during
+// the slow commands & the delay between characters instead of waiting them out
+// NOTE: Assumes 1 ms ticks. The string must stay unchanged until the thread ends.
+extern int LCD_4Bits_Init_Thread(PT *pt);
+extern int LCD_4Bits_OutputString_Thread(PT *pt, const char *str);
+
 
 #endif /* LCD__DRIVER */
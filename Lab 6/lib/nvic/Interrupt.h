@@ -0,0 +1,159 @@
+#ifndef MCU_NVIC_INTERRUPT
+#define MCU_NVIC_INTERRUPT
+
+#include <stdint.h>
+
+#include "mcu/tm4c123gh6pm.h"
+
+// Interrupt numbers of the peripherals used in the labs
+// Source: Table 2-9 or pg. 104-106 in datasheet (https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf)
+#define GPIOA_IRQn      0
+#define GPIOB_IRQn      1
+#define GPIOC_IRQn      2
+#define GPIOD_IRQn      3
+#define GPIOE_IRQn      4
+#define UART0_IRQn      5
+#define ADC0SS3_IRQn    17
+#define TIMER0A_IRQn    19
+#define TIMER1A_IRQn    21
+#define TIMER2A_IRQn    23
+#define GPIOF_IRQn      30
+#define ADC1SS3_IRQn    51
+#define TIMER5A_IRQn    92
+
+
+// NVIC register addressing
+// Sources:
+// * Register mapping: pg. 134 - 137 of datasheet (https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf)
+// * Priority bit field locations: pg. 152 of datasheet (https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf)
+//
+// The enable (EN), disable (DIS), set pending (PEND) and clear pending (UNPEND) banks are laid
+// out as consecutive 32-bit registers, with interrupt n controlled by bit (n % 32) of register (n / 32).
+// Writing a 0 has no effect on these registers, so a single store of just the target bit is enough
+// (no read-modify-write and no risk of clobbering another interrupt that changed in between).
+#define NVIC_IRQ_REG(reg0, IRQn)    (((volatile unsigned long *) &(reg0))[(IRQn) >> 5])
+#define NVIC_IRQ_BIT(IRQn)          (1UL << ((IRQn) & 0x1F))
+
+// The priority registers are byte-accessible, with interrupt n owning byte n starting from PRI0.
+// Only the upper 3 bits of each byte are implemented (priority 0 = highest, 7 = lowest).
+#define NVIC_PRI_BYTE(IRQn)         (((volatile unsigned char *) &NVIC_PRI0_R)[(IRQn)])
+#define NVIC_PRI_SHIFT              5
+#define NVIC_PRI_MASK               0x7u
+
+
+// Compile-time versions of the NVIC operations
+// NOTE: When 'IRQn' is a constant, every macro below resolves to a single store to a fixed address
+#define NVIC_ENABLE_IRQ(IRQn)           (NVIC_IRQ_REG(NVIC_EN0_R, IRQn) = NVIC_IRQ_BIT(IRQn))
+#define NVIC_DISABLE_IRQ(IRQn)          (NVIC_IRQ_REG(NVIC_DIS0_R, IRQn) = NVIC_IRQ_BIT(IRQn))
+#define NVIC_SET_PENDING_IRQ(IRQn)      (NVIC_IRQ_REG(NVIC_PEND0_R, IRQn) = NVIC_IRQ_BIT(IRQn))
+#define NVIC_CLEAR_PENDING_IRQ(IRQn)    (NVIC_IRQ_REG(NVIC_UNPEND0_R, IRQn) = NVIC_IRQ_BIT(IRQn))
+#define NVIC_IS_PENDING_IRQ(IRQn)       ((NVIC_IRQ_REG(NVIC_PEND0_R, IRQn) & NVIC_IRQ_BIT(IRQn)) != 0)
+#define NVIC_SET_PRIORITY(IRQn, priority) \
+    (NVIC_PRI_BYTE(IRQn) = (unsigned char) (((priority) & NVIC_PRI_MASK) << NVIC_PRI_SHIFT))
+
+
+// Nestable critical sections (interrupts are only re-enabled when leaving the outermost one)
+//   uint32_t primask = Interrupt_Disable_Save();
+//   ... code that must not be interrupted ...
+//   Interrupt_Restore(primask);
+// NOTE: PRIMASK is read through a named register variable, the compiler's way of emitting "MRS r0, PRIMASK"
+static __inline uint32_t Interrupt_Disable_Save(void) {
+    register uint32_t primaskReg __asm("primask");
+    uint32_t primask = primaskReg;
+
+    __disable_irq();
+    return primask;
+}
+
+static __inline void Interrupt_Restore(uint32_t primask) {
+    if ((primask & 1) == 0)
+        __enable_irq();
+}
+
+
+// Nestable critical sections that only mask the interrupts at priority 'priority' (1 - 7) & below, so more
+// urgent handlers (i.e. a DAC timer) keep running through them
+//   uint32_t basepri = Interrupt_Mask_Save(5);
+//   ... code shared with handlers of priority 5 - 7 ...
+//   Interrupt_Mask_Restore(basepri);
+// NOTE: Goes through BASEPRI_MAX, which the core ignores when it would lower the masking level, so a section
+// nested in a stricter one stays as strict. BASEPRI = 0 means no masking at all, so priority 0 handlers can
+// only be held off by Interrupt_Disable_Save().
+#ifdef __ARMCC_VERSION
+static __inline uint32_t Interrupt_Mask_Save(unsigned int priority) {
+    register uint32_t basepriReg __asm("basepri");
+    register uint32_t basepriMaxReg __asm("basepri_max");
+    uint32_t basepri = basepriReg;
+
+    basepriMaxReg = (priority & NVIC_PRI_MASK) << NVIC_PRI_SHIFT;
+
+    // Make sure the new level applies from the very next instruction on
+    __isb(0xF);
+    return basepri;
+}
+
+static __inline void Interrupt_Mask_Restore(uint32_t basepri) {
+    register uint32_t basepriReg __asm("basepri");
+
+    basepriReg = basepri;
+}
+#else
+// Host builds (i.e. the tests in tools/) have no BASEPRI to mask with
+static __inline uint32_t Interrupt_Mask_Save(unsigned int priority) {
+    (void) priority;
+    return 0;
+}
+
+static __inline void Interrupt_Mask_Restore(uint32_t basepri) {
+    (void) basepri;
+}
+#endif
+
+
+// Most urgent priority of the handlers using the shared event framework services (posting active object events,
+// allocating & freeing memory pool blocks), whose critical sections then only mask that level & below
+// - 0 = every interrupt (disables them all via PRIMASK)
+// - 1 - 7 = that level & below (via BASEPRI), leaving more urgent handlers running, which then must not use
+//   any of these services
+// NOTE: Overridable per project, i.e. via the C/C++ "Define" field in the Keil project options
+#ifndef INTERRUPT_FRAMEWORK_PRIORITY
+#define INTERRUPT_FRAMEWORK_PRIORITY 0
+#endif
+
+#if INTERRUPT_FRAMEWORK_PRIORITY == 0
+#define Interrupt_Framework_Save()          Interrupt_Disable_Save()
+#define Interrupt_Framework_Restore(saved)  Interrupt_Restore(saved)
+#else
+#define Interrupt_Framework_Save()          Interrupt_Mask_Save(INTERRUPT_FRAMEWORK_PRIORITY)
+#define Interrupt_Framework_Restore(saved)  Interrupt_Mask_Restore(saved)
+#endif
+
+// Fails the build (with a negative array size error naming 'name') unless 'condition' holds, i.e. to check
+// the interrupt priority map of a project
+#define INTERRUPT_STATIC_ASSERT(name, condition) typedef char name[(condition) ? 1 : -1]
+
+
+// Run-time versions for when the interrupt number is only known at run-time
+
+// Enable the specified interrupt (number)
+extern void NVIC_EnableIRQn(int IRQn);
+
+// Disable the specified interrupt (number)
+extern void NVIC_DisableIRQn(int IRQn);
+
+// Force the specified interrupt (number) into the pending state
+extern void NVIC_SetPendingIRQn(int IRQn);
+
+// Remove the pending state of the specified interrupt (number)
+extern void NVIC_ClearPendingIRQn(int IRQn);
+
+// Set the priority for the specified interrupt (number)
+extern void NVIC_SetPriorityIRQn(int IRQn, int priority);
+
+// Split the 3 priority bits into 'preemptBits' (0 - 3) upper bits of group priority, deciding which handler
+// preempts which (& what BASEPRI masks), & the rest as subpriority, only ordering pending handlers
+// NOTE: Out of reset all 3 bits are group priority, which is what the rest of the labs assume
+extern void NVIC_SetPriorityGrouping(int preemptBits);
+
+
+#endif /* MCU_NVIC_INTERRUPT */
@@ -8,6 +8,15 @@
 // - RCC2 Register - pg. 260 of MCU datasheet (above)
 // - https://alhabish.github.io/embedded-course/2018/06/20/pll.html
 int PLL_Init(uint8_t sysdiv2_divisor) {
+    PLL_Start(sysdiv2_divisor);
+    PLL_Wait_Lock();
+
+    return 0;
+}
+
+
+// Steps 1 - 5 of PLL_Init(): power up the PLL, leaving the system on the crystal until it locks
+void PLL_Start(uint8_t sysdiv2_divisor) {
     // Step 1: Configure the system to use RCC2 for advanced features
     // such as 400 MHz PLL and non-integer System Clock Divisor.
     SYSCTL_RCC2_R |= SYSCTL_RCC2_USERCC2;
@@ -34,13 +43,41 @@ int PLL_Init(uint8_t sysdiv2_divisor) {
     // Set the system clock frequency based on the following formula: 400 Mhz / (SYSDIV2 + 1)
     // See Table 5-6 on pg. 224 of the MCU datasheet for example frequencies and limitations
     SYSCTL_RCC2_R += (sysdiv2_divisor << 22);
+}
+
 
+// Steps 6 - 7 of PLL_Init(): wait for the PLL to lock, then switch the system clock over to it
+void PLL_Wait_Lock(void) {
     // Step 6: Wait for PLL to lock by polling PLLLRIS (PLL Lock Raw Interrupt Status)
     while ((SYSCTL_RIS_R & SYSCTL_RIS_PLLLRIS) == 0);
 
     // Step 7: Re-enable use of PLL & System Clock Divider
     SYSCTL_RCC2_R &= ~SYSCTL_RCC2_BYPASS2;
     SYSCTL_RCC2_R |= SYSCTL_RCC_USESYSDIV;
+}
+
+
+// Switch the system clock to another SYSDIV2 divisor at run-time
+// Only the divider after the (400 MHz) PLL changes, so the PLL stays powered & locked and there's no lock to
+// wait for. The system clock runs straight off the crystal for the few cycles the divider takes to switch over
+// (like TivaWare's SysCtlClockSet()), so the core never sees a clock glitch.
+int PLL_Set_Divisor(uint8_t sysdiv2_divisor) {
+    uint32_t rcc2;
+
+    if (sysdiv2_divisor < PLL_SYSDIV2_MIN)
+        return -1;
+
+    // Step 1: Bypass the PLL while switching the divider
+    rcc2 = SYSCTL_RCC2_R | SYSCTL_RCC2_BYPASS2;
+    SYSCTL_RCC2_R = rcc2;
+
+    // Step 2: Replace the system clock divider field + LSB bit (bits 28-23 + 22 in RCC2 - pg. 260)
+    rcc2 &= ~(SYSCTL_RCC2_SYSDIV2_M | SYSCTL_RCC2_SYSDIV2LSB);
+    rcc2 |= ((uint32_t) sysdiv2_divisor << 22);
+    SYSCTL_RCC2_R = rcc2;
+
+    // Step 3: Go back to the (still locked) PLL
+    SYSCTL_RCC2_R = rcc2 & ~SYSCTL_RCC2_BYPASS2;
 
     return 0;
 }
@@ -0,0 +1,159 @@
+#include <stdint.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "power.h"
+
+#if POWER_ACCOUNTING
+// GPTM Clock Configuration register of Wide Timer 5 (missing from the MCU header)
+// NOTE: ALTCLK clocks the timer from the alternate clock (ALTCLKCFG), which is the PIOSC out of reset
+#define WTIMER5_CC_R        (*((volatile unsigned long *)0x4004FFC8))
+#define TIMER_CC_ALTCLK     0x00000001
+
+// Timer value at the last sleep/wake-up boundary
+static uint32_t lastStamp;
+
+// Time spent active & sleeping (in PIOSC ticks)
+static uint64_t activeTicks = 0;
+static uint64_t sleepTicks = 0;
+static unsigned long sleepCount = 0;
+
+
+// Setup WTIMER5A as a free-running 32-bit down counter off the PIOSC, so the counts don't depend on the system
+// clock (which may get switched in between, see "clock.h")
+static void Power_Accounting_Timer_Init(void) {
+    // Enable clock for Wide Timer 5
+    SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R5;
+
+    // Wait until Wide Timer 5 clock is fully initialized
+    while ((SYSCTL_PRWTIMER_R & SYSCTL_PRWTIMER_R5) == 0);
+
+    // Disable Timer A during setup
+    WTIMER5_CTL_R = 0;
+
+    // Use Timer A on its own (32 bits wide on a wide timer) in periodic mode, counting down from the maximum
+    WTIMER5_CFG_R = TIMER_CFG_16_BIT;
+    WTIMER5_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+    WTIMER5_TAILR_R = 0xFFFFFFFF;
+    WTIMER5_CC_R = TIMER_CC_ALTCLK;
+
+    // Start Timer A, pausing it while the debugger halts the core
+    WTIMER5_CTL_R = (TIMER_CTL_TAEN | TIMER_CTL_TASTALL);
+
+    lastStamp = WTIMER5_TAV_R;
+}
+
+
+// Number of ticks elapsed since the last boundary, moving the boundary to now
+// NOTE: The timer counts down, so subtracting the new value from the old one also handles the wrap around
+//       (as long as boundaries are less than 2^32 ticks apart, i.e. ~268 s)
+static uint32_t Power_Ticks_Since_Stamp(void) {
+    uint32_t now = WTIMER5_TAV_R;
+    uint32_t elapsed = lastStamp - now;
+
+    lastStamp = now;
+    return elapsed;
+}
+#endif
+
+
+// Enable clock gating of every peripheral not listed in 'sleepClocks' while the core sleeps
+void Power_Init(const Power_SleepClocks *sleepClocks) {
+    unsigned long wtimerClocks = sleepClocks->wtimer;
+
+#if POWER_ACCOUNTING
+    // Keep the accounting timer running during sleep
+    wtimerClocks |= SYSCTL_SCGCWTIMER_S5;
+    Power_Accounting_Timer_Init();
+#endif
+
+    // Select which peripherals keep their clock in sleep mode
+    SYSCTL_SCGCGPIO_R = sleepClocks->gpio;
+    SYSCTL_SCGCTIMER_R = sleepClocks->timer;
+    SYSCTL_SCGCWTIMER_R = wtimerClocks;
+    SYSCTL_SCGCADC_R = sleepClocks->adc;
+    SYSCTL_SCGCUART_R = sleepClocks->uart;
+    SYSCTL_SCGCDMA_R = sleepClocks->dma;
+    SYSCTL_SCGCPWM_R = sleepClocks->pwm;
+
+    // Use the sleep mode clock gating registers (SCGC) instead of the run mode ones (RCGC) while sleeping
+    SYSCTL_RCC_R |= SYSCTL_RCC_ACG;
+
+    // Use sleep mode (not deep-sleep) for WFI, so the system clock keeps running for SysTick & timers
+    NVIC_SYS_CTRL_R &= ~(NVIC_SYS_CTRL_SLEEPDEEP | NVIC_SYS_CTRL_SLEEPEXIT);
+}
+
+
+// Sleep until the next interrupt
+// NOTE: With interrupts disabled, an interrupt arriving between the caller's check and WFI stays pending
+// and still ends WFI right away, so the wake-up can't be missed. Its handler runs once interrupts are
+// enabled again below, and the caller then re-checks its wake-up condition with interrupts disabled.
+void Power_Sleep(void) {
+#if POWER_ACCOUNTING
+    activeTicks += Power_Ticks_Since_Stamp();
+#endif
+
+    __wfi();
+
+#if POWER_ACCOUNTING
+    sleepTicks += Power_Ticks_Since_Stamp();
+    sleepCount++;
+#endif
+
+    // Let the handler of the waking interrupt run
+    __enable_irq();
+    __isb(0xF);
+    __disable_irq();
+}
+
+
+// Hand the core over to the interrupt handlers for good, sleeping whenever no handler is running
+void Power_Sleep_On_Exit(void) {
+    // Go back to sleep right after returning from an interrupt handler instead of returning to this loop
+    NVIC_SYS_CTRL_R |= NVIC_SYS_CTRL_SLEEPEXIT;
+    __enable_irq();
+
+    while (1)
+        __wfi();
+}
+
+
+// Get the time spent sleeping vs. active so far
+void Power_Get_Stats(Power_Stats *stats) {
+#if POWER_ACCOUNTING
+    // Count the time since the last wake-up as active
+    activeTicks += Power_Ticks_Since_Stamp();
+
+    stats->activeTicks = activeTicks;
+    stats->sleepTicks = sleepTicks;
+    stats->sleepCount = sleepCount;
+#else
+    stats->activeTicks = 0;
+    stats->sleepTicks = 0;
+    stats->sleepCount = 0;
+#endif
+}
+
+
+// Restart counting the time spent sleeping vs. active
+void Power_Reset_Stats(void) {
+#if POWER_ACCOUNTING
+    Power_Ticks_Since_Stamp();
+
+    activeTicks = 0;
+    sleepTicks = 0;
+    sleepCount = 0;
+#endif
+}
+
+
+// Estimate the average supply current (in uA) over the given statistics
+//   I_avg = (t_active * I_run + t_sleep * I_sleep) / (t_active + t_sleep)
+unsigned long Power_Estimate_Average_Current_uA(const Power_Stats *stats) {
+    uint64_t totalTicks = stats->activeTicks + stats->sleepTicks;
+
+    if (totalTicks == 0)
+        return POWER_RUN_CURRENT_UA;
+
+    return (unsigned long) ((stats->activeTicks * POWER_RUN_CURRENT_UA
+                             + stats->sleepTicks * POWER_SLEEP_CURRENT_UA) / totalTicks);
+}
@@ -0,0 +1,74 @@
+#ifndef MCU_POWER
+#define MCU_POWER
+
+#include <stdint.h>
+
+// Measure the time spent sleeping vs. active with a free-running wide timer (WTIMER5A)
+// NOTE: The timer runs off the PIOSC (16 MHz) instead of the system clock, so the times stay right across clock
+// switches (see "clock.h")
+// NOTE: The timer has to stay clocked during sleep, which costs a little power. Set to 0 for the lowest power draw
+#ifndef POWER_ACCOUNTING
+#define POWER_ACCOUNTING 1
+#endif
+
+// Rough supply currents (in uA) in run & sleep mode, used for the energy estimate
+// NOTE: These depend on the clock frequency and enabled peripherals, so adjust them to the currents measured on the board
+#ifndef POWER_RUN_CURRENT_UA
+#define POWER_RUN_CURRENT_UA   30000UL
+#endif
+
+#ifndef POWER_SLEEP_CURRENT_UA
+#define POWER_SLEEP_CURRENT_UA 12000UL
+#endif
+
+
+// Peripherals that keep their clock while the core sleeps (bit n = module n, same layout as the SCGC registers)
+// NOTE: Every peripheral that has to wake up the core (i.e. GPIO edge interrupts, ADC conversions) must be listed
+typedef struct {
+    unsigned long gpio;     // SCGCGPIO (bit n = GPIO port index n)
+    unsigned long timer;    // SCGCTIMER
+    unsigned long wtimer;   // SCGCWTIMER
+    unsigned long adc;      // SCGCADC
+    unsigned long uart;     // SCGCUART
+    unsigned long dma;      // SCGCDMA
+    unsigned long pwm;      // SCGCPWM (i.e. for PWM outputs that must keep running)
+} Power_SleepClocks;
+
+// Accounting timer ticks per 1 us (PIOSC = 16 MHz)
+#define POWER_TICKS_PER_US 16UL
+
+// Time spent sleeping vs. active (in accounting timer ticks) since Power_Init() or Power_Reset_Stats()
+typedef struct {
+    uint64_t activeTicks;
+    uint64_t sleepTicks;
+    unsigned long sleepCount;
+} Power_Stats;
+
+
+// Enable clock gating of every peripheral not listed in 'sleepClocks' while the core sleeps
+// NOTE: Call after PLL_Init() and after the listed peripherals have been enabled
+extern void Power_Init(const Power_SleepClocks *sleepClocks);
+
+// Sleep until the next interrupt
+// NOTE: Must be called with interrupts disabled, in a loop that re-checks the wake-up condition:
+//   __disable_irq();
+//   while (!condition)
+//       Power_Sleep();
+//   __enable_irq();
+extern void Power_Sleep(void);
+
+// Hand the core over to the interrupt handlers for good, sleeping whenever no handler is running
+// NOTE: Never returns, and the time spent this way is not included in the statistics
+extern void Power_Sleep_On_Exit(void);
+
+// Get the time spent sleeping vs. active so far
+extern void Power_Get_Stats(Power_Stats *stats);
+
+// Restart counting the time spent sleeping vs. active
+extern void Power_Reset_Stats(void);
+
+// Estimate the average supply current (in uA) over the given statistics
+extern unsigned long Power_Estimate_Average_Current_uA(const Power_Stats *stats);
+
+
+#endif /* MCU_POWER */
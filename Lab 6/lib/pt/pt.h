@@ -0,0 +1,79 @@
+#ifndef MCU_PT
+#define MCU_PT
+
+#include <stdint.h>
+
+#include "active/active.h"
+
+// Protothreads: stackless coroutines running inside an active object (see "active.h"), so drivers can be
+// written as sequential code that gives the CPU back during every wait instead of blocking
+// - A protothread is a function 'int thread(PT *pt)' whose body sits between PT_BEGIN() and PT_END()
+// - The owning active object resumes it with PT_RUN() for every event it handles, and the thread runs on
+//   from where it last waited until it waits again (PT_WAITING) or finishes (PT_ENDED)
+// - Built on a switch statement & __LINE__ (C90), so:
+//   - Local variables don't survive a wait (keep state in static variables or a struct instead)
+//   - No 'switch' statement may span a wait, and only 1 wait may be put on a line
+//
+// Example (blinking an LED every 500 ms):
+//   int Blink_Thread(PT *pt) {
+//       PT_BEGIN(pt);
+//       while (1) {
+//           LED_Toggle();
+//           AWAIT_TICKS(pt, 500);
+//       }
+//       PT_END(pt);
+//   }
+
+// Return values of a protothread
+#define PT_WAITING  0
+#define PT_ENDED    1
+
+// Signal of the event posted by the timer of AWAIT_TICKS()
+// NOTE: Active objects running protothreads must not use it for anything else
+#define PT_SIGNAL_TIMEOUT 0xFFu
+
+typedef struct {
+    unsigned int line;              // Where to resume (0 = from the start)
+    Active *owner;                  // Active object the thread runs in
+    const Active_Event *event;      // Event the thread was resumed with
+    Active_Timer timer;             // Used by AWAIT_TICKS()
+} PT;
+
+
+// Start (or restart) 'pt' from the top, running inside active object 'active'
+// NOTE: Protothreads must start out zeroed (i.e. static), like the timers in "active.h"
+#define PT_INIT(pt, active)     do { (pt)->line = 0; (pt)->owner = (active); } while (0)
+
+// Resume 'thread' with the event being handled by its active object, giving PT_WAITING or PT_ENDED
+#define PT_RUN(pt, thread, ev)  ((pt)->event = (ev), thread(pt))
+
+#define PT_BEGIN(pt)            switch ((pt)->line) { case 0:
+#define PT_END(pt)              } (pt)->line = 0; return PT_ENDED
+
+// Give the CPU back until 'condition' is true (checked again with every event of the active object)
+#define PT_WAIT_UNTIL(pt, condition) \
+    do { (pt)->line = __LINE__; case __LINE__: if (!(condition)) return PT_WAITING; } while (0)
+
+// Give the CPU back until an event with 'sig' is handled by the active object
+// NOTE: Other events handled in the meantime are skipped by the thread
+#define AWAIT_EVENT(pt, sig)    PT_WAIT_UNTIL(pt, (pt)->event->signal == (sig))
+
+// Give the CPU back for at least 'n' whole ticks
+// NOTE: The next tick can come right after arming, so the timer runs 'n' + 1 ticks & the wait takes between 'n'
+// and 'n' + 1 tick periods. The timer disarms itself once it fires, so a time-out posted for another thread of
+// the same active object doesn't end the wait early
+#define AWAIT_TICKS(pt, n) \
+    do { \
+        Active_Timer_Arm(&(pt)->timer, (pt)->owner, PT_SIGNAL_TIMEOUT, (n) + 1, 0); \
+        PT_WAIT_UNTIL(pt, (pt)->event->signal == PT_SIGNAL_TIMEOUT && !(pt)->timer.armed); \
+    } while (0)
+
+// Run protothread 'call' (using the separate 'child' state) until it ends, passing it every event
+#define PT_SPAWN(pt, child, call) \
+    do { \
+        PT_INIT(child, (pt)->owner); \
+        PT_WAIT_UNTIL(pt, ((child)->event = (pt)->event, (call)) == PT_ENDED); \
+    } while (0)
+
+
+#endif /* MCU_PT */
@@ -0,0 +1,74 @@
+#include <stdint.h>
+
+#include "stream_frame.h"
+
+
+// Compute the CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) of 'length' bytes
+// NOTE: Computed bit by bit instead of with a 512-byte lookup table, which is fast enough for a 56-byte
+// frame every few milliseconds
+uint16_t Stream_Crc16(const uint8_t *data, unsigned int length) {
+    uint16_t crc = 0xFFFF;
+    unsigned int i;
+    int bit;
+
+    for (i = 0; i < length; i++) {
+        crc ^= (uint16_t) (data[i] << 8);
+
+        for (bit = 0; bit < 8; bit++) {
+            if (crc & 0x8000)
+                crc = (uint16_t) ((crc << 1) ^ 0x1021);
+            else
+                crc = (uint16_t) (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+
+// Build a frame out of 'count' 12-bit samples into 'frame', returning the frame size
+unsigned int Stream_Encode_Frame(uint8_t *frame, uint8_t sequence, uint16_t sampleIndex,
+                                 const uint16_t *samples, unsigned int count) {
+    uint8_t *payload = frame + STREAM_HEADER_SIZE;
+    unsigned int i, size;
+    uint16_t crc;
+
+    if (count == 0 || (count & 1) != 0 || count > STREAM_MAX_SAMPLES)
+        return 0;
+
+    // Header
+    frame[0] = STREAM_SYNC0;
+    frame[1] = STREAM_SYNC1;
+    frame[2] = sequence;
+    frame[3] = (uint8_t) count;
+    frame[4] = (uint8_t) (sampleIndex & 0xFF);
+    frame[5] = (uint8_t) (sampleIndex >> 8);
+
+    // Pack 2 samples into 3 bytes
+    for (i = 0; i < count; i += 2) {
+        payload[0] = (uint8_t) (samples[i] & 0xFF);
+        payload[1] = (uint8_t) (((samples[i] >> 8) & 0x0F) | ((samples[i + 1] & 0x0F) << 4));
+        payload[2] = (uint8_t) ((samples[i + 1] >> 4) & 0xFF);
+        payload += 3;
+    }
+
+    // CRC over everything but the sync bytes
+    size = STREAM_HEADER_SIZE + STREAM_PAYLOAD_SIZE(count);
+    crc = Stream_Crc16(frame + 2, size - 2);
+    frame[size] = (uint8_t) (crc & 0xFF);
+    frame[size + 1] = (uint8_t) (crc >> 8);
+
+    return size + STREAM_CRC_SIZE;
+}
+
+
+// Unpack 'count' 12-bit samples from the packed samples of a frame
+void Stream_Unpack_Samples(const uint8_t *payload, uint16_t *samples, unsigned int count) {
+    unsigned int i;
+
+    for (i = 0; i + 1 < count; i += 2) {
+        samples[i] = (uint16_t) (payload[0] | ((payload[1] & 0x0F) << 8));
+        samples[i + 1] = (uint16_t) ((payload[1] >> 4) | (payload[2] << 4));
+        payload += 3;
+    }
+}
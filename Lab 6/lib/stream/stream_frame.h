@@ -0,0 +1,45 @@
+#ifndef STREAM_FRAME
+#define STREAM_FRAME
+
+#include <stdint.h>
+
+// Binary sample stream frame layout (all multi-byte fields are little-endian)
+//   Offset  Size      Field
+//   0       1         Sync byte 0 (0xA5)
+//   1       1         Sync byte 1 (0x5A)
+//   2       1         Sequence number (incremented per frame, wraps around)
+//   3       1         Sample count N (even, 2 - STREAM_MAX_SAMPLES)
+//   4       2         Sample index: low 16 bits of the index of the first sample (counted since sampling
+//                     started), so the index of every frame received stays known whatever got lost before it
+//   6       3 * N / 2 Samples, packed as 12 bits each (2 samples per 3 bytes):
+//                       byte 0 = s0[7:0], byte 1 = s1[3:0] << 4 | s0[11:8], byte 2 = s1[11:4]
+//   6 + 3N/2  2       CRC-16/CCITT-FALSE over bytes 2 up to the end of the samples
+//
+// A frame of 32 samples takes 56 bytes (1.75 bytes per sample), so 115,200 baud (11,520 bytes/s) carries
+// ~6,500 samples/s, compared to a few hundred as formatted text.
+#define STREAM_SYNC0            0xA5u
+#define STREAM_SYNC1            0x5Au
+#define STREAM_HEADER_SIZE      6
+#define STREAM_CRC_SIZE         2
+#define STREAM_MAX_SAMPLES      64
+
+// Size of the packed samples & of a whole frame with 'n' samples (n must be even)
+#define STREAM_PAYLOAD_SIZE(n)  (((n) / 2) * 3)
+#define STREAM_FRAME_SIZE(n)    (STREAM_HEADER_SIZE + STREAM_PAYLOAD_SIZE(n) + STREAM_CRC_SIZE)
+
+// NOTE: These functions don't touch any hardware, so they can also be compiled on a host machine (i.e. for
+// the decoder in tools/stream_decode.c)
+
+// Compute the CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) of 'length' bytes
+extern uint16_t Stream_Crc16(const uint8_t *data, unsigned int length);
+
+// Build a frame out of 'count' 12-bit samples into 'frame' (at least STREAM_FRAME_SIZE(count) bytes),
+// returning the frame size (or 0 if 'count' is odd, 0 or above STREAM_MAX_SAMPLES)
+extern unsigned int Stream_Encode_Frame(uint8_t *frame, uint8_t sequence, uint16_t sampleIndex,
+                                        const uint16_t *samples, unsigned int count);
+
+// Unpack 'count' 12-bit samples from the packed samples of a frame
+extern void Stream_Unpack_Samples(const uint8_t *payload, uint16_t *samples, unsigned int count);
+
+
+#endif /* STREAM_FRAME */
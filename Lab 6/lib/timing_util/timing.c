@@ -3,29 +3,35 @@
 #include "systick/SysTick.h"
 #include "timing.h"
 
-// Wait for delay x 1 us via SysTick (assuming 50 MHz clock -> 1 cycle = 20 ns)
+// System clock cycles per 1 us (50 MHz clock -> 1 cycle = 20 ns by default)
+static volatile uint32_t cyclesPerUs = 50;
+
+
+// Rescale the delays to a new system clock frequency
+void Timing_Set_Clock(uint32_t sysClockHz) {
+    cyclesPerUs = sysClockHz / 1000000UL;
+}
+
+// Wait for delay x 1 us via SysTick
 void SysTick_Wait_1us(uint32_t delay) {
     uint32_t i;
     for (i = 0 ; i < delay; i++) {
-        // Wait for duration of 50 * 20 ns
-        SysTick_Wait(50);
+        // Wait for duration of 1 us (i.e. 50 * 20 ns at 50 MHz)
+        SysTick_Wait(cyclesPerUs);
     }
 }
 
-// Wait for delay x 1 ms via SysTick (assuming 50 MHz clock -> 1 cycle = 20 ns)
+// Wait for delay x 1 ms via SysTick
 void SysTick_Wait_1ms(uint32_t delay) {
     uint32_t i;
     for (i = 0 ; i < delay; i++) {
-        // Wait for duration of 50,000 * 20 ns
-        SysTick_Wait(50000);
+        // Wait for duration of 1 ms (i.e. 50,000 * 20 ns at 50 MHz)
+        SysTick_Wait(cyclesPerUs * 1000);
     }
 }
 
-// Wait for delay x 500 ms via SysTick (assuming 50 MHz clock -> 1 cycle = 20 ns)
+// Wait for delay x 500 ms via SysTick
+// NOTE: Done as 1 ms waits, since 500 ms worth of cycles doesn't fit the 24-bit reload value above ~33 MHz
 void SysTick_Wait_500ms(uint32_t delay) {
-    uint32_t i;
-    for (i = 0 ; i < delay; i++) {
-        // Wait for duration of 25,000,000 * 20 ns
-        SysTick_Wait(25000000);
-    }
+    SysTick_Wait_1ms(delay * 500);
 }
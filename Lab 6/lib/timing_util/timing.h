@@ -4,15 +4,20 @@
 #include <stdint.h>
 
 
-// Wait for delay x 1 us via SysTick (assuming 50 MHz clock -> 1 cycle = 20 ns)
+// Rescale the delays below to a new system clock frequency (a Clock_Listener, see clock/clock.h)
+// NOTE: The delays assume a 50 MHz clock (1 cycle = 20 ns) until this is called
+extern void Timing_Set_Clock(uint32_t sysClockHz);
+
+
+// Wait for delay x 1 us via SysTick
 extern void SysTick_Wait_1us(uint32_t delay);
 
 
-// Wait for delay x 1 ms via SysTick (assuming 50 MHz clock -> 1 cycle = 20 ns)
+// Wait for delay x 1 ms via SysTick
 extern void SysTick_Wait_1ms(uint32_t delay);
 
 
-// Wait for delay x 500 ms via SysTick (assuming 50 MHz clock -> 1 cycle = 20 ns)
+// Wait for delay x 500 ms via SysTick
 extern void SysTick_Wait_500ms(uint32_t delay);
 
 
@@ -0,0 +1,258 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mcu/tm4c123gh6pm.h"
+#include "gpio/gpio.h"
+#include "nvic/Interrupt.h"
+#include "power/power.h"
+#include "ringbuf/ringbuf.h"
+#include "uart.h"
+
+
+// Pin configuration for UART0 (PA0 = U0Rx & PA1 = U0Tx, alternate function 1)
+const GPIO_PinConfig UART_PIN_CONFIG[] = {
+    {GPIO_PORT_A, UART_RX_PIN, GPIO_INPUT | GPIO_ALT_FUNC, 1},
+    {GPIO_PORT_A, UART_TX_PIN, GPIO_OUTPUT | GPIO_ALT_FUNC, 1},
+    GPIO_PIN_CONFIG_END
+};
+
+
+// Single-producer / single-consumer ring buffers (see ringbuf/ringbuf.h), so neither side has to disable interrupts
+// - TX: main code produces (Uart_Write), UART0_Handler consumes
+// - RX: UART0_Handler produces, main code consumes (Uart_Read)
+static uint8_t txStorage[UART_TX_BUFFER_SIZE];
+static RingBuf txRing;
+
+static uint8_t rxStorage[UART_RX_BUFFER_SIZE];
+static RingBuf rxRing;
+
+static volatile unsigned long txDropped = 0;
+static volatile unsigned long rxDropped = 0;
+
+// Called once received bytes have been queued
+static volatile Uart_Rx_Callback rxCallback = NULL;
+
+// Baud rate given to Uart_Init(), kept for Uart_Set_Clock()
+static uint32_t uartBaudRate;
+
+
+// Move queued bytes from the TX buffer into the hardware FIFO until either one runs out
+static void Uart_Fill_Tx_Fifo(void) {
+    uint8_t data;
+
+    while ((UART0_FR_R & UART_FR_TXFF) == 0 && RingBuf_Pop(&txRing, &data))
+        UART0_DR_R = data;
+}
+
+
+// Move received bytes from the hardware FIFO into the RX buffer until the FIFO is empty
+static void Uart_Drain_Rx_Fifo(void) {
+    uint8_t data;
+
+    while ((UART0_FR_R & UART_FR_RXFE) == 0) {
+        data = (uint8_t) UART0_DR_R;
+
+        // Keep draining the FIFO (so the interrupt clears) even when the buffer is full, dropping the byte
+        if (!RingBuf_Push(&rxRing, &data))
+            rxDropped++;
+    }
+}
+
+
+// Baud rate divisor in 1/64ths: BRD = sysClock / (16 * baudRate), rounded to the nearest 1/64
+// - 50 MHz & 115,200 baud => BRD = 27.127 => IBRD = 27, FBRD = 8
+// - 10 MHz & 115,200 baud => BRD = 5.425 => IBRD = 5, FBRD = 27
+static uint32_t Uart_Baud_Divisor64(uint32_t sysClockHz, uint32_t baudRate) {
+    return (sysClockHz * 4 + baudRate / 2) / baudRate;
+}
+
+
+// Setup UART0 as 8N1 at 'baudRate', driven by UART0_Handler
+void Uart_Init(uint32_t sysClockHz, uint32_t baudRate) {
+    uint32_t divisor64 = Uart_Baud_Divisor64(sysClockHz, baudRate);
+
+    uartBaudRate = baudRate;
+
+    RingBuf_Init(&txRing, txStorage, 1, UART_TX_BUFFER_SIZE);
+    RingBuf_Init(&rxRing, rxStorage, 1, UART_RX_BUFFER_SIZE);
+
+    // Enable clock for UART 0
+    SYSCTL_RCGCUART_R |= SYSCTL_RCGCUART_R0;
+
+    // Wait until UART 0 clock is fully initialized
+    while ((SYSCTL_PRUART_R & SYSCTL_PRUART_R0) == 0);
+
+    // Disable UART 0 during configuration
+    UART0_CTL_R &= ~UART_CTL_UARTEN;
+
+    // Set the baud rate divisor (integer & fractional parts)
+    UART0_IBRD_R = divisor64 >> 6;
+    UART0_FBRD_R = divisor64 & 0x3F;
+
+    // 8 data bits, no parity, 1 stop bit & hardware FIFOs enabled (writing LCRH also latches IBRD & FBRD)
+    UART0_LCRH_R = (UART_LCRH_WLEN_8 | UART_LCRH_FEN);
+
+    // Clock the baud rate generator from the system clock
+    UART0_CC_R = UART_CC_CS_SYSCLK;
+
+    // Interrupt once the TX FIFO drains to 1/4 full (4 bytes left = ~350 us to refill it at 115,200 baud),
+    // and once the RX FIFO fills to 1/2 full or stays non-empty for 32 bit periods (time-out)
+    UART0_IFLS_R = (UART_IFLS_TX2_8 | UART_IFLS_RX4_8);
+
+    // Clear any prior interrupts & unmask the RX, RX time-out & overrun interrupts
+    // NOTE: The TX interrupt is only unmasked while there are bytes queued (see Uart_Write)
+    UART0_ICR_R = (UART_ICR_TXIC | UART_ICR_RXIC | UART_ICR_RTIC | UART_ICR_OEIC);
+    UART0_IM_R = (UART_IM_RXIM | UART_IM_RTIM | UART_IM_OEIM);
+
+    // Re-enable UART 0 with both TX & RX
+    UART0_CTL_R = (UART_CTL_UARTEN | UART_CTL_TXE | UART_CTL_RXE);
+
+    // Set interrupt priority for UART 0 (level 5 by default) & enable it
+    NVIC_SET_PRIORITY(UART0_IRQn, UART_PRIORITY);
+    NVIC_ENABLE_IRQ(UART0_IRQn);
+}
+
+
+// Hold back the queued bytes & let the hardware FIFO drain at the current rate, ahead of a clock switch
+void Uart_Prepare_Clock(uint32_t sysClockHz) {
+    (void) sysClockHz;
+
+    // Keep the handler from refilling the FIFO until Uart_Set_Clock() (receiving goes on meanwhile)
+    UART0_IM_R &= ~UART_IM_TXIM;
+
+    // Wait for the last (up to 16) bytes to leave the hardware FIFO & shift register
+    while (UART0_FR_R & UART_FR_BUSY);
+}
+
+
+// Recompute the baud rate divisor for a new system clock frequency
+void Uart_Set_Clock(uint32_t sysClockHz) {
+    uint32_t divisor64 = Uart_Baud_Divisor64(sysClockHz, uartBaudRate);
+    unsigned long ctl = UART0_CTL_R;
+
+    // Disable UART 0 while changing the divisor, like in Uart_Init()
+    UART0_CTL_R = ctl & ~UART_CTL_UARTEN;
+
+    UART0_IBRD_R = divisor64 >> 6;
+    UART0_FBRD_R = divisor64 & 0x3F;
+
+    // Re-write the same line control to latch IBRD & FBRD
+    UART0_LCRH_R = UART0_LCRH_R;
+
+    UART0_CTL_R = ctl;
+
+    // Resume sending whatever Uart_Prepare_Clock() held back, at the new rate
+    Uart_Fill_Tx_Fifo();
+    if (RingBuf_Count(&txRing) != 0)
+        UART0_IM_R |= UART_IM_TXIM;
+}
+
+
+// NOTE: This is meant to be implicitly overriden
+void UART0_Handler(void) {
+    unsigned long status = UART0_MIS_R;
+
+    // Clear the handled interrupt flags (ICR is write-1-to-clear, so a direct store is enough)
+    UART0_ICR_R = status;
+
+    if (status & (UART_MIS_RXMIS | UART_MIS_RTMIS | UART_MIS_OEMIS)) {
+        if (status & UART_MIS_OEMIS)
+            rxDropped++;
+
+        Uart_Drain_Rx_Fifo();
+
+        if (rxCallback != NULL)
+            rxCallback();
+    }
+
+    if (status & UART_MIS_TXMIS) {
+        Uart_Fill_Tx_Fifo();
+
+        // Stop the TX interrupt once everything queued is in the hardware FIFO
+        if (RingBuf_Count(&txRing) == 0)
+            UART0_IM_R &= ~UART_IM_TXIM;
+    }
+}
+
+
+// Queue up to 'length' bytes for sending without blocking, returning how many were queued
+unsigned int Uart_Write(const void *data, unsigned int length) {
+    unsigned int queued = RingBuf_Push_Many(&txRing, data, length);
+
+    txDropped += length - queued;
+
+    // Kick off sending: the TX interrupt only fires when the FIFO drains past its trigger level, so an idle
+    // FIFO has to be primed here. Masking the TX interrupt keeps the handler from consuming at the same time.
+    UART0_IM_R &= ~UART_IM_TXIM;
+    Uart_Fill_Tx_Fifo();
+    if (RingBuf_Count(&txRing) != 0)
+        UART0_IM_R |= UART_IM_TXIM;
+
+    return queued;
+}
+
+
+// Queue a null-terminated string for sending without blocking, returning how many bytes were queued
+unsigned int Uart_Write_String(const char *str) {
+    unsigned int length = 0;
+
+    while (str[length] != '\0')
+        length++;
+
+    return Uart_Write(str, length);
+}
+
+
+// Take up to 'maxLength' received bytes without blocking, returning how many were taken
+unsigned int Uart_Read(void *data, unsigned int maxLength) {
+    return RingBuf_Pop_Many(&rxRing, data, maxLength);
+}
+
+
+// Call 'callback' whenever received bytes have been queued (NULL = no callback)
+void Uart_Set_Rx_Callback(Uart_Rx_Callback callback) {
+    rxCallback = callback;
+}
+
+
+// Number of bytes that can currently be queued without dropping any
+unsigned int Uart_Tx_Free(void) {
+    return RingBuf_Free(&txRing);
+}
+
+
+// Sleep until every queued byte has been sent
+void Uart_Flush(void) {
+    // Sleep until the handler has moved every queued byte into the hardware FIFO
+    __disable_irq();
+    while (RingBuf_Count(&txRing) != 0)
+        Power_Sleep();
+    __enable_irq();
+
+    // Wait for the last (up to 16) bytes to leave the hardware FIFO & shift register
+    while (UART0_FR_R & UART_FR_BUSY);
+}
+
+
+// Number of bytes dropped so far because the TX buffer was full
+unsigned long Uart_Tx_Dropped(void) {
+    return txDropped;
+}
+
+
+// Number of bytes dropped so far because the RX buffer was full (or the hardware FIFO overran)
+unsigned long Uart_Rx_Dropped(void) {
+    return rxDropped;
+}
+
+
+// Most bytes ever queued in the TX buffer at once
+unsigned int Uart_Tx_High_Water(void) {
+    return RingBuf_High_Water(&txRing);
+}
+
+
+// Most bytes ever queued in the RX buffer at once
+unsigned int Uart_Rx_High_Water(void) {
+    return RingBuf_High_Water(&rxRing);
+}
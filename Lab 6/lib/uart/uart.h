@@ -0,0 +1,80 @@
+#ifndef UART__DRIVER
+#define UART__DRIVER
+
+#include <stdint.h>
+
+#include "gpio/gpio.h"
+
+// UART0 pin definitions (routed to the debugger's virtual COM port on the LaunchPad)
+#define UART_RX_PIN     0x01u // = 0x01 (PA0)
+#define UART_TX_PIN     0x02u // = 0x02 (PA1)
+#define UART_ALL_PINS   0x03u // = 0x02 (PA1) | 0x01 (PA0)
+
+// Software buffer sizes (in bytes) on top of the 16-byte hardware FIFOs
+// NOTE: Must be powers of 2 (see ringbuf/ringbuf.h)
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE 512
+#endif
+
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE 64
+#endif
+
+// Interrupt priority of UART0_Handler (0 - 7, 0 = most urgent)
+// NOTE: Overridable per project, i.e. via the C/C++ "Define" field in the Keil project options
+#ifndef UART_PRIORITY
+#define UART_PRIORITY 5
+#endif
+
+
+// Called from UART0_Handler whenever received bytes have been queued (i.e. to post an event for reading them)
+typedef void (*Uart_Rx_Callback)(void);
+
+// Pin configuration table (to be passed to GPIO_Init_Pins())
+extern const GPIO_PinConfig UART_PIN_CONFIG[];
+
+// Setup UART0 as 8N1 at 'baudRate', driven by UART0_Handler
+// NOTE: The UART pins (UART_PIN_CONFIG) must be configured via GPIO_Init_Pins() beforehand
+extern void Uart_Init(uint32_t sysClockHz, uint32_t baudRate);
+
+// Hold back the queued bytes & wait for the hardware TX FIFO to drain at the current rate (at most 16 bytes,
+// ~1.4 ms at 115,200 baud), ahead of a clock switch (a preparer, see Clock_Add_Preparer() in clock/clock.h)
+// NOTE: Must not be called with interrupts disabled
+extern void Uart_Prepare_Clock(uint32_t sysClockHz);
+
+// Recompute the baud rate divisor for a new system clock frequency & resume sending (a Clock_Listener, see
+// clock/clock.h)
+// NOTE: Only bytes held back by Uart_Prepare_Clock() make it through the switch intact, so register both (and
+// don't write from a handler that can preempt the switch). A byte being received during the switch may be garbled
+extern void Uart_Set_Clock(uint32_t sysClockHz);
+
+// Queue up to 'length' bytes for sending without blocking, returning how many were queued
+// NOTE: Bytes that don't fit in the TX buffer are dropped (and counted), so the caller never waits on the link
+extern unsigned int Uart_Write(const void *data, unsigned int length);
+
+// Queue a null-terminated string for sending without blocking, returning how many bytes were queued
+extern unsigned int Uart_Write_String(const char *str);
+
+// Take up to 'maxLength' received bytes without blocking, returning how many were taken
+extern unsigned int Uart_Read(void *data, unsigned int maxLength);
+
+// Call 'callback' whenever received bytes have been queued (NULL = no callback)
+extern void Uart_Set_Rx_Callback(Uart_Rx_Callback callback);
+
+// Number of bytes that can currently be queued without dropping any
+extern unsigned int Uart_Tx_Free(void);
+
+// Sleep until every queued byte has been sent
+// NOTE: Must not be called with interrupts disabled
+extern void Uart_Flush(void);
+
+// Number of bytes dropped so far because the TX buffer was full (sending) or the RX buffer was full (receiving)
+extern unsigned long Uart_Tx_Dropped(void);
+extern unsigned long Uart_Rx_Dropped(void);
+
+// Most bytes ever queued in the TX & RX buffers at once, to size UART_TX_BUFFER_SIZE & UART_RX_BUFFER_SIZE with
+extern unsigned int Uart_Tx_High_Water(void);
+extern unsigned int Uart_Rx_High_Water(void);
+
+
+#endif /* UART__DRIVER */
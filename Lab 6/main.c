@@ -13,61 +13,378 @@
  */
 
 #include <stdint.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "lib/mcu/tm4c123gh6pm.h"
 #include "lib/pll/PLL.h"
+#include "lib/clock/clock.h"
 #include "lib/systick/SysTick.h"
 #include "lib/timing_util/timing.h"
+#include "lib/power/power.h"
 #include "lib/adc/adc_temp.h"
 #include "lib/lcd/lcd_driver.h"
+#include "lib/uart/uart.h"
+#include "lib/adc/adc_stream.h"
+#include "lib/stream/stream_frame.h"
+#include "lib/gpio/gpio.h"
+#include "lib/mempool/mempool.h"
+#include "lib/active/active.h"
+#include "lib/pt/pt.h"
+#include "lib/boot/boot_profile.h"
 
 
 // Voltage Reference values
 #define VREF_POS 3.3
 #define VREF_NEG 0
 
+// UART telemetry baud rate
+#define UART_BAUD_RATE 115200UL
 
-int main() {
-    // Initialize PLL & SysTick
-    PLL_Init(SYSDIV2_50_00_Mhz);
-    SysTick_Init();
+// Debug flags
+#define STREAM_ADC_SAMPLES 0  // Controls if raw ADC samples are streamed as binary frames instead of running the LCD thermometer (see relevant function for more info)
+#define SCALE_CLOCK 1         // Controls if the system clock drops to 10 MHz while waiting and only runs at 80 MHz while handling a reading (see "clock.h")
+#define PROFILE_BOOT 1        // Controls if each boot phase gets timestamped, with the timings sent over UART ahead of the first reading (see "boot_profile.h")
+#define FAST_BOOT 1           // Controls if boot overlaps the PLL lock with the pin & ADC setup, and defers the LCD setup until after the first reading
+
+// System clock at boot, while waiting & while handling a reading
+// NOTE: The current estimate sent with each reading (see "power.h") uses 1 run current at every frequency, so it
+// only shows the core staying awake longer at the idle clock, not the lower current it draws there (see
+// tools/power_sim.c). Compare SCALE_CLOCK = 0 & 1 with the board's supply current instead.
+#define SYSDIV2_BOOT SYSDIV2_50_00_Mhz
+
+#if SCALE_CLOCK
+    #define SYSDIV2_IDLE  SYSDIV2_10_00_Mhz
+    #define SYSDIV2_BURST SYSDIV2_80_00_Mhz
+#else
+    #define SYSDIV2_IDLE  SYSDIV2_BOOT
+    #define SYSDIV2_BURST SYSDIV2_BOOT
+#endif
+
+#if PROFILE_BOOT
+    #define BOOT_MARK(phase) Boot_Profile_Mark(phase)
+    #define BOOT_PROFILE_SLEEP_CLOCK SYSCTL_SCGCWTIMER_S4
+#else
+    #define BOOT_MARK(phase)
+    #define BOOT_PROFILE_SLEEP_CLOCK 0
+#endif
+
+// Sample rate of the binary ADC stream
+// NOTE: Each sample takes 1.75 bytes on the link, so 115,200 baud tops out at ~6,500 samples/s
+#define STREAM_SAMPLE_RATE_HZ 2000UL
+
+// Active objects (see "active.h"), ticking every 1 ms
+#define ACTIVE_TICK_HZ 1000UL
+#define SENSOR_PRIORITY 0
+#define DISPLAY_PRIORITY 1
+#define SENSOR_QUEUE_CAPACITY 4
+#define DISPLAY_QUEUE_CAPACITY 2
+
+// Time between temperature readings (in ms) & before the first one (letting the LCD settle after setup)
+// NOTE: With FAST_BOOT the LCD only gets setup after the first reading, so there's nothing to wait for
+#define SENSOR_PERIOD_MS 3000
+
+#if FAST_BOOT
+    #define SENSOR_FIRST_DELAY_MS 1
+#else
+    #define SENSOR_FIRST_DELAY_MS 500
+#endif
+
+// Temperature sensor active object signals
+#define SENSOR_SIGNAL_TIMER (ACTIVE_SIGNAL_USER + 0)    // Time to take the next reading
+#define SENSOR_SIGNAL_SAMPLE (ACTIVE_SIGNAL_USER + 1)   // Conversion done, 'param' = raw ADC reading
+
+// LCD active object signals
+#define DISPLAY_SIGNAL_SHOW (ACTIVE_SIGNAL_USER + 0)    // Show the line of text in 'data' on the first line
+
+// Size of an LCD line of text (16 characters + null terminator)
+#define LCD_LINE_SIZE 17
+
+
+// Function Declarations
+void Fast_Boot_Enable_Clocks(void);
+void Sensor_Handler(Active *self, const Active_Event *event);
+void Sensor_Sample_Done(uint32_t adcReading);
+void Display_Handler(Active *self, const Active_Event *event);
+int Display_Thread(PT *pt);
+
+void DEBUG_Stream_ADC_Samples(void);
+
+
+//////////////////////
+// Global Variables //
+//////////////////////
+
+
+// Temperature sensor active object: takes a reading every SENSOR_PERIOD_MS, then hands the text to the display
+// & sends the telemetry line
+Active sensor;
+static Active_Event sensorQueue[SENSOR_QUEUE_CAPACITY];
+static Active_Timer sensorTimer;
+
+// LCD active object: shows lines of text, with the LCD driver running as protothreads (see "pt.h"), so the
+// other active objects keep running while the LCD waits
+Active display;
+static Active_Event displayQueue[DISPLAY_QUEUE_CAPACITY];
+static PT displayThread;
+static PT lcdThread;
+
+// Latest line of text to show & the line being shown (which must stay unchanged until it's fully written)
+static char displayLineNext[LCD_LINE_SIZE];
+static char displayLine[LCD_LINE_SIZE];
+static int displayLinePending = 0;
 
-    // Initialize ADC module and internal temperature sensor (PE3)
-    ADC_Temp_Sensor_Init();
+// Number of temperature readings handled so far
+static unsigned long sensorReadings = 0;
 
-    // Initialize the LCD
-    LCD_4Bits_Init();
 
-    // Clear the LCD screen
-    LCD_4Bits_Cmd(LCD_CLEAR_DISPLAY);
+// Stream internal temperature sensor samples to the host as binary frames (see lib/stream/stream_frame.h), forever
+// NOTE: Decode on the host with tools/stream_decode.c
+void DEBUG_Stream_ADC_Samples(void) {
+    uint8_t frame[STREAM_FRAME_SIZE(ADC_STREAM_BATCH_SAMPLES)];
+    const uint16_t *samples;
+    uint32_t firstSample;
+    uint8_t sequence = 0;
+    unsigned int frameSize;
 
-    // Set the cursor to the beginning of the first line
-    LCD_4Bits_Cmd(LCD_SET_DDRAM_ADDR + LCD_LINE1_START);
+    // Timer 1 & ADC 1 (sampling) and UART 0 with its pins on Port A (sending) keep their clocks while sleeping
+    const Power_SleepClocks sleepClocks = { (1UL << GPIO_PORT_A), SYSCTL_SCGCTIMER_S1, 0, SYSCTL_SCGCADC_S1,
+                                            SYSCTL_SCGCUART_S0, 0, 0 };
 
-    // Allow some delay to let the LCD display the character
-    SysTick_Wait_500ms(1);
+    Power_Init(&sleepClocks);
+    ADC_Stream_Init(Clock_Get_Hz(), STREAM_SAMPLE_RATE_HZ);
+    Clock_Add_Listener(ADC_Stream_Set_Clock);
 
     while (1) {
-        // Fetch the latest temperature reading (as raw digital voltage) from PE3
-        uint32_t tempRaw = Get_ADC_Temp_Reading();
+        // Sleep until the next batch of samples is ready
+        samples = ADC_Stream_Wait_Batch(&firstSample);
 
-        // Convert temperature from raw voltage reading to Celsius
-        float tempCelsius = Convert_Temp_Voltage_Celsius(VREF_POS, VREF_NEG, tempRaw);
+        // Pack the batch into a frame, along with the index of its first sample (so the host can place every sample
+        // in time, whatever got dropped or corrupted in between), & hand the batch back for sampling right away
+        frameSize = Stream_Encode_Frame(frame, sequence, (uint16_t) firstSample, samples, ADC_STREAM_BATCH_SAMPLES);
+        ADC_Stream_Release_Batch();
+
+        // Only queue whole frames, so a full TX buffer drops a frame instead of corrupting one
+        // NOTE: The sequence number only advances for frames sent, so a gap on the host means a corrupted link
+        if (Uart_Tx_Free() >= frameSize) {
+            Uart_Write(frame, frameSize);
+            sequence++;
+        }
+    }
+}
+
+
+////////////////////
+// Active Objects //
+////////////////////
+
+
+// Handle 1 event of the temperature sensor
+void Sensor_Handler(Active *self, const Active_Event *event) {
+    float tempCelsius;
+    char *line;
+    char telemetryBuffer[40];
+
+    // Time spent sleeping vs. active, sent along with the readings
+    Power_Stats powerStats;
+
+    switch (event->signal) {
+        case ACTIVE_SIGNAL_START:
+            Active_Timer_Arm(&sensorTimer, self, SENSOR_SIGNAL_TIMER, SENSOR_FIRST_DELAY_MS, SENSOR_PERIOD_MS);
+            break;
+
+        case SENSOR_SIGNAL_TIMER:
+            // Start sampling the temperature sensor (PE3), with the result coming back as an event
+            ADC_Temp_Start_Reading(Sensor_Sample_Done);
+            break;
+
+        case SENSOR_SIGNAL_SAMPLE:
+            // Do the floating point math & formatting at full speed, then drop back to the idle clock
+            Clock_Set(SYSDIV2_BURST);
+
+            // Convert temperature from raw voltage reading to Celsius
+            tempCelsius = Convert_Temp_Voltage_Celsius(VREF_POS, VREF_NEG, event->param);
+
+            if (sensorReadings++ == 0) {
+                BOOT_MARK("first sample");
+
+                #if FAST_BOOT
+                    // Only now start the LCD (deferred from main), so its setup didn't hold up the first reading
+                    Active_Start(&display, DISPLAY_PRIORITY, displayQueue, DISPLAY_QUEUE_CAPACITY, Display_Handler);
+                #endif
+            }
+
+            // Prepare the display string for the LCD in a pool block, which goes along with the event
+            // NOTE: This format allows for negative temperatures and up
+            // to 2 decimals within a single LCD line (max 16 characters).
+            line = (char *) MemPool_Alloc(LCD_LINE_SIZE);
+            if (line != NULL) {
+                sprintf(line, "Temp (C): %.2f.", tempCelsius);
+                Active_Post(&display, DISPLAY_SIGNAL_SHOW, 0, line);
+            }
+
+            // Prepare a telemetry line for the host
+            // Format: <raw ADC reading>,<temperature in C>,<estimated average current in uA>
+            Power_Get_Stats(&powerStats);
+            sprintf(telemetryBuffer, "%lu,%.2f,%lu\r\n", (unsigned long) event->param, tempCelsius,
+                    Power_Estimate_Average_Current_uA(&powerStats));
+
+            Clock_Set(SYSDIV2_IDLE);
+
+            #if PROFILE_BOOT
+                // Send the boot phase timings once, ahead of the first telemetry line
+                if (sensorReadings == 1) {
+                    Boot_Profile_Write(Uart_Write_String);
+                    Boot_Profile_Stop();
+                }
+            #endif
+
+            // Queue the telemetry line without waiting for it to be sent
+            // NOTE: Only queued after switching back, so the switch doesn't have to wait for the UART FIFO to drain
+            Uart_Write_String(telemetryBuffer);
+            break;
+    }
+}
 
-        // Prepare the display string for the LCD
-        char lineBuffer[16];
-        // NOTE: This format allows for negative temperatures and up
-        // to 2 decimals within a single LCD line (max 16 characters).
-        sprintf(lineBuffer, "Temp (C): %.2f.", tempCelsius);
+
+// Called from ADC0SS3_Handler once a reading is done
+void Sensor_Sample_Done(uint32_t adcReading) {
+    Active_Post(&sensor, SENSOR_SIGNAL_SAMPLE, adcReading, NULL);
+}
+
+
+// Handle 1 event of the LCD
+void Display_Handler(Active *self, const Active_Event *event) {
+    switch (event->signal) {
+        case ACTIVE_SIGNAL_START:
+            PT_INIT(&displayThread, self);
+            break;
+
+        case DISPLAY_SIGNAL_SHOW:
+            // Only the latest line matters, so a line arriving while the previous one is still being written
+            // replaces any other one waiting
+            strncpy(displayLineNext, (const char *) event->data, LCD_LINE_SIZE - 1);
+            displayLinePending = 1;
+            break;
+    }
+
+    PT_RUN(&displayThread, Display_Thread, event);
+}
+
+
+// Setup the LCD, then keep showing the latest line of text on the first line
+int Display_Thread(PT *pt) {
+    PT_BEGIN(pt);
+
+    // Initialize the LCD (includes clearing the LCD screen)
+    PT_SPAWN(pt, &lcdThread, LCD_4Bits_Init_Thread(&lcdThread));
+
+    while (1) {
+        PT_WAIT_UNTIL(pt, displayLinePending);
+        displayLinePending = 0;
+        memcpy(displayLine, displayLineNext, LCD_LINE_SIZE);
 
         // Set the cursor to the beginning of the first line
         LCD_4Bits_Cmd(LCD_SET_DDRAM_ADDR + LCD_LINE1_START);
 
         // Display the string to the LCD (includes automatic handling of delays)
-        LCD_4Bits_OutputString(lineBuffer);
-
-        // Allow some delay before reading the temperature sensor again
-        SysTick_Wait_500ms(6);
+        PT_SPAWN(pt, &lcdThread, LCD_4Bits_OutputString_Thread(&lcdThread, displayLine));
     }
+
+    PT_END(pt);
+}
+
+
+// Turn on the clocks of every peripheral in use up front (1 write per clock gating register), so they all
+// power up while the PLL locks and none of the drivers has to wait on its ready bit afterwards
+void Fast_Boot_Enable_Clocks(void) {
+    // Ports A (UART), B (LCD) & E (temperature sensor)
+    SYSCTL_RCGCGPIO_R |= (1UL << GPIO_PORT_A) | (1UL << GPIO_PORT_B) | (1UL << GPIO_PORT_E);
+
+    // ADC 0 (temperature sensor), UART 0 (telemetry) & Timer 2 (event framework ticks)
+    SYSCTL_RCGCADC_R |= SYSCTL_RCGCADC_R0;
+    SYSCTL_RCGCUART_R |= SYSCTL_RCGCUART_R0;
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R2;
+}
+
+
+int main() {
+    // Pin configuration tables of every driver in use
+    const GPIO_PinConfig *const pinTables[] = { ADC_TEMP_PIN_CONFIG, LCD_PIN_CONFIG, UART_PIN_CONFIG };
+
+    // Only ADC 0, UART 0 (with its pins on Port A) & Timer 2 keep their clocks while sleeping, to finish
+    // conversions, keep sending telemetry in the background & keep ticking (plus the boot profiling timer)
+    const Power_SleepClocks sleepClocks = { (1UL << GPIO_PORT_A), SYSCTL_SCGCTIMER_S2, BOOT_PROFILE_SLEEP_CLOCK,
+                                            SYSCTL_SCGCADC_S0, SYSCTL_SCGCUART_S0, 0, 0 };
+
+    #if PROFILE_BOOT
+        // Timestamp every boot phase from here on
+        Boot_Profile_Start();
+    #endif
+
+    #if FAST_BOOT
+        // Start the PLL, then configure the pins & ADC off the crystal while it locks
+        Fast_Boot_Enable_Clocks();
+        Clock_Init_Begin(SYSDIV2_BOOT);
+
+        GPIO_Init_Pins(pinTables, sizeof(pinTables) / sizeof(pinTables[0]));
+        BOOT_MARK("gpio");
+
+        ADC_Temp_Sensor_Init();
+        BOOT_MARK("adc");
+
+        Clock_Init_End();
+        BOOT_MARK("pll");
+    #else
+        // Initialize PLL (via the clock manager)
+        Clock_Init(SYSDIV2_BOOT);
+        BOOT_MARK("pll");
+
+        // Configure the pins for the temperature sensor (PE3), LCD (PB0 - PB2 & PB4 - PB7) and UART (PA0 & PA1) in a single pass
+        GPIO_Init_Pins(pinTables, sizeof(pinTables) / sizeof(pinTables[0]));
+        BOOT_MARK("gpio");
+
+        // Initialize ADC module and internal temperature sensor (PE3)
+        ADC_Temp_Sensor_Init();
+        BOOT_MARK("adc");
+    #endif
+
+    // Initialize SysTick, with the SysTick delays following every clock switch
+    SysTick_Init();
+    Timing_Set_Clock(Clock_Get_Hz());
+    Clock_Add_Listener(Timing_Set_Clock);
+
+    // Initialize UART 0 for sending the readings to a host (via the debugger's virtual COM port)
+    Uart_Init(Clock_Get_Hz(), UART_BAUD_RATE);
+    Clock_Add_Preparer(Uart_Prepare_Clock);
+    Clock_Add_Listener(Uart_Set_Clock);
+    BOOT_MARK("uart");
+
+    #if STREAM_ADC_SAMPLES
+        // If the 'STREAM_ADC_SAMPLES' flag is set to 1, stream raw samples to the host instead (never returns)
+        DEBUG_Stream_ADC_Samples();
+    #endif
+
+    // Gate the clocks of every other peripheral while sleeping
+    Power_Init(&sleepClocks);
+
+    // Setup the event framework (1 ms ticks) & start the temperature sensor & LCD (after the first reading with FAST_BOOT)
+    MemPool_Init();
+    Active_Init(Clock_Get_Hz(), ACTIVE_TICK_HZ);
+    Clock_Add_Listener(Active_Set_Clock);
+
+    // Wait at the idle clock until the first reading comes in
+    Clock_Set(SYSDIV2_IDLE);
+    BOOT_MARK("active");
+
+    #if !FAST_BOOT
+        Active_Start(&display, DISPLAY_PRIORITY, displayQueue, DISPLAY_QUEUE_CAPACITY, Display_Handler);
+    #endif
+
+    Active_Start(&sensor, SENSOR_PRIORITY, sensorQueue, SENSOR_QUEUE_CAPACITY, Sensor_Handler);
+
+    // Sleep whenever no interrupt or active object is running (never returns)
+    // NOTE: Interrupts wake up from sleep for the SysTick delays, ADC conversions, UART & ticks
+    Active_Run();
 }
@@ -0,0 +1,229 @@
+/*
+ * Host-side check of the sleep vs. active accounting (lib/power/power.c) across clock switches
+ *
+ * Runs the real power.c on simulated registers (the peripheral pages it touches are mapped into RAM at their
+ * board addresses), driven by the same idle loop as Active_Run() (see lib/active/active.c), over a made-up
+ * (but board-like) timing model of the thermometer in main.c:
+ * - Every 1 ms tick wakes the core for the tick (Timer 2A) & the dispatcher (PendSV)
+ * - Every SENSOR_PERIOD_MS, the reading starts the ADC, then gets converted & formatted at the burst clock
+ *   (switching there & back), and sent to the LCD & UART at the idle clock
+ *
+ * Runs the model once with SCALE_CLOCK (10 MHz idle, 80 MHz burst) and once without (50 MHz throughout), and
+ * prints for each the time spent active vs. sleeping & the estimated average current: as modeled, as accounted
+ * by power.c (timed off the PIOSC), and as counting system clock cycles would have had it (the accounting before
+ * it moved to the PIOSC), then checks the accounted times against the modeled ones.
+ *
+ * NOTE: The estimate uses the same run current (POWER_RUN_CURRENT_UA) at every clock frequency, so it only
+ * reflects how long the core is awake, not the lower current of a slower clock.
+ *
+ * Build (from the "Lab 6" folder, Linux only):
+ *   gcc -std=gnu89 -Wall -O2 -I. -Ilib -o power_sim tools/power_sim.c
+ *
+ * Usage:
+ *   ./power_sim [readings (default 20)]
+ *
+ * The exit code is 1 if the accounted times don't match the modeled ones, so it can be used in scripts.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// Host stand-ins for the compiler intrinsics used by "power.c", driving the simulation
+static void Sim_Wait_For_Interrupt(void);
+static void Sim_Run_Handlers(void);
+
+#define __wfi() Sim_Wait_For_Interrupt()
+#define __enable_irq() Sim_Run_Handlers()
+#define __disable_irq()
+#define __isb(x)
+
+#include "power/power.c"
+
+// Board settings (see main.c)
+#define ACTIVE_TICK_HZ 1000UL
+#define SENSOR_PERIOD_MS 3000UL
+
+// Simulated time runs at 400 MHz, the least common multiple of every clock involved
+#define SIM_HZ 400000000UL
+#define PIOSC_HZ 16000000UL
+
+// Timing model (cycles of the clock running at the time)
+#define TICK_CYCLES 300             // Exception entry, TIMER2A_Handler & PendSV finding nothing to do
+#define ADC_START_CYCLES 200        // Sensor handler starting the conversion
+#define ADC_DONE_CYCLES 150         // ADC handler posting the sample
+#define CLOCK_SWITCH_CYCLES 120     // Clock_Set() & its listeners, at the old clock
+#define READING_CYCLES 60000        // Conversion to Celsius & formatting both lines (sprintf of floats)
+#define DISPLAY_CYCLES 3000         // LCD commands (spread over a few ticks, counted at once)
+#define TELEMETRY_CYCLES 1500       // UART interrupts sending the telemetry line
+
+// Page-aligned bases of the register blocks power.c touches (Wide Timer 5, System Control & the NVIC / SCB)
+static const unsigned long REGISTER_PAGES[] = { 0x4004F000UL, 0x400FE000UL, 0xE000E000UL };
+#define REGISTER_PAGE_COUNT (sizeof(REGISTER_PAGES) / sizeof(REGISTER_PAGES[0]))
+
+typedef struct {
+    const char *name;
+    unsigned long idleHz, burstHz;
+} Sim_Setup;
+
+typedef struct {
+    uint64_t activeTime, sleepTime;         // In SIM_HZ units
+    uint64_t activeCycles, sleepCycles;     // In system clock cycles (the accounting before the PIOSC)
+    unsigned long sleeps;
+} Sim_Expected;
+
+
+static const Sim_Setup *setup;
+static Sim_Expected expected;
+static unsigned long clockHz;
+static uint64_t now;
+static unsigned long tick;
+
+
+// Advance the simulated time by 'cycles' of the current clock, keeping the accounting timer (a down counter
+// off the PIOSC) in step
+static void Sim_Advance(uint64_t cycles, int sleeping) {
+    uint64_t time = cycles * (SIM_HZ / clockHz);
+
+    now += time;
+
+    if (sleeping) {
+        expected.sleepTime += time;
+        expected.sleepCycles += cycles;
+    } else {
+        expected.activeTime += time;
+        expected.activeCycles += cycles;
+    }
+
+    WTIMER5_TAV_R = (uint32_t) (0xFFFFFFFFUL - now / (SIM_HZ / PIOSC_HZ));
+}
+
+
+static void Sim_Clock_Set(unsigned long hz) {
+    Sim_Advance(CLOCK_SWITCH_CYCLES, 0);
+    clockHz = hz;
+}
+
+
+// Sleep until the next tick (not at all if it's already pending, i.e. after a reading taking over 1 tick)
+static void Sim_Wait_For_Interrupt(void) {
+    uint64_t nextTick = (uint64_t) (tick + 1) * (SIM_HZ / ACTIVE_TICK_HZ);
+
+    if (nextTick > now)
+        Sim_Advance((nextTick - now) / (SIM_HZ / clockHz), 1);
+
+    expected.sleeps++;
+}
+
+
+// Run whatever the tick that just woke the core up has pending
+static void Sim_Run_Handlers(void) {
+    tick++;
+    Sim_Advance(TICK_CYCLES, 0);
+
+    if (tick % SENSOR_PERIOD_MS != 0)
+        return;
+
+    Sim_Advance(ADC_START_CYCLES + ADC_DONE_CYCLES, 0);
+
+    Sim_Clock_Set(setup->burstHz);
+    Sim_Advance(READING_CYCLES, 0);
+    Sim_Clock_Set(setup->idleHz);
+
+    Sim_Advance(DISPLAY_CYCLES + TELEMETRY_CYCLES, 0);
+}
+
+
+static unsigned long Estimate_uA(uint64_t active, uint64_t sleep) {
+    Power_Stats stats;
+
+    stats.activeTicks = active;
+    stats.sleepTicks = sleep;
+    return Power_Estimate_Average_Current_uA(&stats);
+}
+
+
+// Run 'readings' readings with 'simSetup', returning 0 if the accounting is off
+static int Sim_Run(const Sim_Setup *simSetup, unsigned long readings) {
+    const Power_SleepClocks sleepClocks = { 0, 0, 0, 0, 0, 0, 0 };
+    const uint64_t timePerTick = SIM_HZ / PIOSC_HZ;
+    uint64_t expectedActive, expectedSleep, error;
+    Power_Stats stats;
+
+    setup = simSetup;
+    clockHz = setup->idleHz;
+    now = 0;
+    tick = 0;
+    memset(&expected, 0, sizeof(expected));
+
+    SYSCTL_PRWTIMER_R = SYSCTL_PRWTIMER_R5;
+    WTIMER5_TAV_R = 0xFFFFFFFFUL;
+    Power_Init(&sleepClocks);
+    Power_Reset_Stats();
+
+    // Same idle loop as Active_Run()
+    __disable_irq();
+    while (tick < readings * SENSOR_PERIOD_MS)
+        Power_Sleep();
+
+    Power_Get_Stats(&stats);
+
+    expectedActive = expected.activeTime / timePerTick;
+    expectedSleep = expected.sleepTime / timePerTick;
+
+    printf("%s:\n", setup->name);
+    printf("  modeled:            active %10lu us, asleep %10lu us, %5.2f %% active, %lu uA\n",
+           (unsigned long) (expected.activeTime / (SIM_HZ / 1000000UL)),
+           (unsigned long) (expected.sleepTime / (SIM_HZ / 1000000UL)),
+           100.0 * expected.activeTime / (expected.activeTime + expected.sleepTime),
+           Estimate_uA(expected.activeTime, expected.sleepTime));
+    printf("  accounted (PIOSC):  active %10lu us, asleep %10lu us, %5.2f %% active, %lu uA\n",
+           (unsigned long) (stats.activeTicks / POWER_TICKS_PER_US),
+           (unsigned long) (stats.sleepTicks / POWER_TICKS_PER_US),
+           100.0 * stats.activeTicks / (stats.activeTicks + stats.sleepTicks),
+           Power_Estimate_Average_Current_uA(&stats));
+    printf("  system clock cycles:                                       %5.2f %% active, %lu uA\n",
+           100.0 * expected.activeCycles / (expected.activeCycles + expected.sleepCycles),
+           Estimate_uA(expected.activeCycles, expected.sleepCycles));
+
+    // Each boundary truncates to a whole PIOSC tick, so each sleep can be off by up to 1 tick either way
+    error = (stats.activeTicks > expectedActive) ? stats.activeTicks - expectedActive
+                                                  : expectedActive - stats.activeTicks;
+    if (error > expected.sleeps || stats.sleepCount != expected.sleeps
+            || stats.activeTicks + stats.sleepTicks > expectedActive + expectedSleep + 1) {
+        fprintf(stderr, "FAILED: %s: accounted %lu active ticks over %lu sleeps, expected %lu\n", setup->name,
+                (unsigned long) stats.activeTicks, stats.sleepCount, (unsigned long) expectedActive);
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[]) {
+    const Sim_Setup scaled = { "SCALE_CLOCK = 1 (10 MHz idle, 80 MHz burst)", 10000000UL, 80000000UL };
+    const Sim_Setup fixed = { "SCALE_CLOCK = 0 (50 MHz throughout)", 50000000UL, 50000000UL };
+    unsigned long readings = 20;
+    unsigned int i;
+    int ok;
+
+    if (argc >= 2)
+        readings = strtoul(argv[1], NULL, 10);
+
+    for (i = 0; i < REGISTER_PAGE_COUNT; i++) {
+        if (mmap((void *) REGISTER_PAGES[i], 0x1000, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+            perror("mmap");
+            return 1;
+        }
+    }
+
+    ok = Sim_Run(&scaled, readings);
+    ok &= Sim_Run(&fixed, readings);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,200 @@
+/*
+ * Host-side decoder for the binary ADC sample stream of Lab 6 (STREAM_ADC_SAMPLES flag in main.c)
+ *
+ * Reads frames (see lib/stream/stream_frame.h) from the board's serial port or from a capture file,
+ * checks them & prints every sample as "<sample index>,<raw value>" CSV to stdout, where the sample
+ * index is rebuilt from the 16-bit sample index in each frame header (so lost samples, whether dropped on
+ * the board or in corrupted frames, show up as gaps in the index, as long as fewer than 65,536 samples go
+ * missing in a row). Once the input ends (or on Ctrl+C), a summary is printed to stderr:
+ * - Frames & samples decoded
+ * - Frames with a bad CRC, bytes skipped to find the next frame & sequence number gaps
+ *
+ * Build (from the "Lab 6" folder):
+ *   gcc -std=gnu89 -Wall -I. -Ilib -o stream_decode tools/stream_decode.c lib/stream/stream_frame.c
+ *
+ * Usage:
+ *   ./stream_decode <serial port> [baud rate]    i.e. ./stream_decode /dev/ttyACM0 115200
+ *   ./stream_decode <capture file>
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "stream/stream_frame.h"
+
+#define DEFAULT_BAUD_RATE 115200
+
+// Bytes read but not decoded yet (room for a few whole frames)
+#define RX_BUFFER_SIZE (4 * STREAM_FRAME_SIZE(STREAM_MAX_SAMPLES))
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static unsigned long framesDecoded = 0;
+static unsigned long samplesDecoded = 0;
+static unsigned long crcErrors = 0;
+static unsigned long bytesSkipped = 0;
+static unsigned long sequenceGaps = 0;
+
+
+static void Handle_Interrupt(int signal) {
+    (void) signal;
+    stopRequested = 1;
+}
+
+
+static speed_t Baud_To_Speed(long baudRate) {
+    switch (baudRate) {
+        case 9600:      return B9600;
+        case 19200:     return B19200;
+        case 38400:     return B38400;
+        case 57600:     return B57600;
+        case 115200:    return B115200;
+        case 230400:    return B230400;
+        default:        return 0;
+    }
+}
+
+
+// Open the input, putting it in raw mode at 'baudRate' if it's a serial port
+static int Open_Input(const char *path, long baudRate) {
+    struct termios settings;
+    speed_t speed = Baud_To_Speed(baudRate);
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+
+    if (fd < 0 || !isatty(fd))
+        return fd;
+
+    if (speed == 0) {
+        fprintf(stderr, "stream_decode: unsupported baud rate %ld\n", baudRate);
+        exit(2);
+    }
+
+    if (tcgetattr(fd, &settings) == 0) {
+        cfmakeraw(&settings);
+        cfsetispeed(&settings, speed);
+        cfsetospeed(&settings, speed);
+        tcsetattr(fd, TCSANOW, &settings);
+    }
+
+    return fd;
+}
+
+
+// Decode every whole frame at the start of 'buffer', returning the number of bytes consumed
+static unsigned int Decode_Frames(const uint8_t *buffer, unsigned int length) {
+    static int anyFrame = 0;
+    static uint8_t expectedSequence = 0;
+    static unsigned long sampleIndex = 0;
+    static uint16_t lastFrameIndex = 0;
+
+    uint16_t samples[STREAM_MAX_SAMPLES];
+    unsigned int pos = 0, count, size, i;
+    uint16_t crc, frameIndex;
+
+    while (pos + STREAM_HEADER_SIZE <= length) {
+        count = buffer[pos + 3];
+
+        // Skip a byte at a time until something that looks like a frame header shows up
+        if (buffer[pos] != STREAM_SYNC0 || buffer[pos + 1] != STREAM_SYNC1
+                || count == 0 || (count & 1) != 0 || count > STREAM_MAX_SAMPLES) {
+            pos++;
+            bytesSkipped++;
+            continue;
+        }
+
+        // Wait for the rest of the frame
+        size = STREAM_FRAME_SIZE(count);
+        if (pos + size > length)
+            break;
+
+        // A bad CRC means either a corrupted frame or sync bytes found in the middle of the samples, so
+        // only skip past the sync byte & look for the next frame from there
+        crc = (uint16_t) (buffer[pos + size - 2] | (buffer[pos + size - 1] << 8));
+        if (Stream_Crc16(buffer + pos + 2, size - 2 - STREAM_CRC_SIZE) != crc) {
+            crcErrors++;
+            pos++;
+            bytesSkipped++;
+            continue;
+        }
+
+        if (anyFrame && buffer[pos + 2] != expectedSequence)
+            sequenceGaps++;
+        expectedSequence = (uint8_t) (buffer[pos + 2] + 1);
+
+        // Place the samples in time from the distance to the previous frame decoded (the first frame seen starts
+        // at index 0), with the 16-bit subtraction covering the index wrapping around
+        frameIndex = (uint16_t) (buffer[pos + 4] | (buffer[pos + 5] << 8));
+        if (anyFrame)
+            sampleIndex += (uint16_t) (frameIndex - lastFrameIndex);
+        lastFrameIndex = frameIndex;
+        anyFrame = 1;
+
+        Stream_Unpack_Samples(buffer + pos + STREAM_HEADER_SIZE, samples, count);
+        for (i = 0; i < count; i++)
+            printf("%lu,%u\n", sampleIndex + i, samples[i]);
+
+        framesDecoded++;
+        samplesDecoded += count;
+        pos += size;
+    }
+
+    return pos;
+}
+
+
+int main(int argc, char *argv[]) {
+    uint8_t buffer[RX_BUFFER_SIZE];
+    unsigned int length = 0, consumed;
+    ssize_t count;
+    int fd;
+
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <serial port | capture file> [baud rate]\n", argv[0]);
+        return 2;
+    }
+
+    fd = Open_Input(argv[1], argc == 3 ? atol(argv[2]) : DEFAULT_BAUD_RATE);
+    if (fd < 0) {
+        fprintf(stderr, "stream_decode: could not open %s: %s\n", argv[1], strerror(errno));
+        return 2;
+    }
+
+    // Stop reading on Ctrl+C, still printing the summary (no SA_RESTART, so a blocked read() returns)
+    {
+        struct sigaction action;
+
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = Handle_Interrupt;
+        sigaction(SIGINT, &action, NULL);
+    }
+
+    printf("sample,raw\n");
+
+    while (!stopRequested) {
+        count = read(fd, buffer + length, sizeof(buffer) - length);
+        if (count <= 0)
+            break;
+
+        length += (unsigned int) count;
+        consumed = Decode_Frames(buffer, length);
+
+        // Keep the partial frame at the end for the next read
+        memmove(buffer, buffer + consumed, length - consumed);
+        length -= consumed;
+    }
+
+    fflush(stdout);
+    fprintf(stderr, "frames: %lu, samples: %lu, CRC errors: %lu, bytes skipped: %lu, sequence gaps: %lu\n",
+            framesDecoded, samplesDecoded, crcErrors, bytesSkipped, sequenceGaps);
+
+    close(fd);
+    return (crcErrors != 0 || sequenceGaps != 0) ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * Host-side stand-in for the UART0 driver (lib/uart/uart.c)
+ *
+ * Implements the same API as the board driver on top of a file descriptor, so code written against
+ * uart.h can be compiled & run on a host machine (i.e. to check what the board would send):
+ * - If the UART_HOST_PATH environment variable is set, that file is used for both directions
+ *   (bytes written are appended to it, bytes read come from its start, through a separate descriptor)
+ * - Otherwise a pseudo-terminal is created and its name printed to stderr, so a serial terminal or
+ *   host tool can be attached to it just like to the board's virtual COM port
+ *
+ * Build (from the "Lab 6" folder), together with the code using the driver:
+ *   gcc -std=gnu89 -Wall -I. -Ilib -o <program> <sources> tools/uart_host.c
+ */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "uart/uart.h"
+
+
+// No pins to configure on the host
+const GPIO_PinConfig UART_PIN_CONFIG[] = {
+    GPIO_PIN_CONFIG_END
+};
+
+static int uartFd = -1;
+static int uartRxFd = -1;   // Own descriptor (& file offset) for reading, as appending moves 'uartFd' to the end
+static int ptySlaveFd = -1;
+static unsigned long txDropped = 0;
+
+
+// Open the backing file or pseudo-terminal (the clock & baud rate only matter on the board)
+void Uart_Init(uint32_t sysClockHz, uint32_t baudRate) {
+    const char *path = getenv("UART_HOST_PATH");
+    struct termios settings;
+
+    (void) sysClockHz;
+    (void) baudRate;
+
+    if (path != NULL) {
+        uartFd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (uartFd >= 0) {
+            uartRxFd = open(path, O_RDONLY);
+            if (uartRxFd < 0) {
+                close(uartFd);
+                uartFd = -1;
+            }
+        }
+    } else {
+        uartFd = posix_openpt(O_RDWR | O_NOCTTY);
+        if (uartFd >= 0 && (grantpt(uartFd) != 0 || unlockpt(uartFd) != 0)) {
+            close(uartFd);
+            uartFd = -1;
+        }
+        uartRxFd = uartFd;
+    }
+
+    if (uartFd < 0) {
+        fprintf(stderr, "uart_host: could not open %s: %s\n", path != NULL ? path : "a pseudo-terminal", strerror(errno));
+        exit(2);
+    }
+
+    // Never block the caller, like the board driver
+    fcntl(uartFd, F_SETFL, fcntl(uartFd, F_GETFL) | O_NONBLOCK);
+    fcntl(uartRxFd, F_SETFL, fcntl(uartRxFd, F_GETFL) | O_NONBLOCK);
+
+    if (path == NULL) {
+        // Put the terminal in raw mode (no echo or line editing), like a plain serial port, and keep the
+        // other end open so writes don't fail while no program is attached yet
+        ptySlaveFd = open(ptsname(uartFd), O_RDWR | O_NOCTTY);
+        if (ptySlaveFd >= 0 && tcgetattr(ptySlaveFd, &settings) == 0) {
+            cfmakeraw(&settings);
+            tcsetattr(ptySlaveFd, TCSANOW, &settings);
+        }
+
+        fprintf(stderr, "uart_host: serial port stand-in at %s\n", ptsname(uartFd));
+    }
+}
+
+
+// No baud rate generator (or hardware FIFO) on the host
+void Uart_Prepare_Clock(uint32_t sysClockHz) {
+    (void) sysClockHz;
+}
+
+
+void Uart_Set_Clock(uint32_t sysClockHz) {
+    (void) sysClockHz;
+}
+
+
+// Write without blocking, counting whatever the other side can't take right now as dropped
+unsigned int Uart_Write(const void *data, unsigned int length) {
+    ssize_t written = write(uartFd, data, length);
+
+    if (written < 0)
+        written = 0;
+
+    txDropped += length - (unsigned int) written;
+    return (unsigned int) written;
+}
+
+
+unsigned int Uart_Write_String(const char *str) {
+    return Uart_Write(str, (unsigned int) strlen(str));
+}
+
+
+// Read without blocking
+unsigned int Uart_Read(void *data, unsigned int maxLength) {
+    ssize_t count = read(uartRxFd, data, maxLength);
+
+    return count < 0 ? 0 : (unsigned int) count;
+}
+
+
+// Nothing is received in the background on the host, so there's nothing to call back from
+void Uart_Set_Rx_Callback(Uart_Rx_Callback callback) {
+    (void) callback;
+}
+
+
+// The kernel buffers writes, so report the board's buffer size as always free
+unsigned int Uart_Tx_Free(void) {
+    return UART_TX_BUFFER_SIZE;
+}
+
+
+void Uart_Flush(void) {
+    if (isatty(uartFd))
+        tcdrain(uartFd);
+}
+
+
+unsigned long Uart_Tx_Dropped(void) {
+    return txDropped;
+}
+
+
+unsigned long Uart_Rx_Dropped(void) {
+    return 0;
+}
+
+
+// Nothing is queued on the host side
+unsigned int Uart_Tx_High_Water(void) {
+    return 0;
+}
+
+
+unsigned int Uart_Rx_High_Water(void) {
+    return 0;
+}